@@ -8,6 +8,7 @@
  *   - Struct packing / unpacking (CGRect, CGPoint, NSRange)
  *   - Object wrapping / argument unwrapping
  *   - String creation throughput
+ *   - bind() against the prepared-send method proxy
  *
  * Results are written to benchmarks/RESULTS.md after each run.
  *
@@ -20,7 +21,7 @@ import { writeFileSync } from "node:fs";
 import { join, dirname } from "node:path";
 import { fileURLToPath } from "node:url";
 import { execSync } from "node:child_process";
-import { NobjcLibrary, NobjcObject } from "../dist/index.js";
+import { NobjcLibrary, NobjcObject, bind } from "../dist/index.js";
 
 // ---------------------------------------------------------------------------
 // Harness
@@ -322,6 +323,43 @@ run("4 args: NSWindow initWithContentRect:...", () => {
   );
 });
 
+// -- bind() vs prepared send -----------------------------------------------
+
+printHeader("bind() vs Prepared Send");
+
+// The method proxy already sends through $prepareSend / $msgSendPrepared, so
+// each pair compares the same send with and without the bound template.
+const helloCopy = NSString.stringWithUTF8String$("Hello, Objective-C!");
+const boundCompare = bind(helloStr, "compare$options$", [undefined, 1]);
+const boundRange = bind(helloStr, "rangeOfString$", [undefined]);
+const boundSubstring = bind(helloStr, "substringWithRange$", [undefined]);
+const objcNeedle = NSString.stringWithUTF8String$("Objective");
+const subRange = { location: 7, length: 9 };
+
+run("prepared: compare:options: (obj + int args)", () => {
+  helloStr.compare$options$(helloCopy, 1);
+});
+
+run("bind: compare:options: (int arg fixed)", () => {
+  boundCompare.invoke(helloCopy);
+});
+
+run("prepared: rangeOfString: (struct return)", () => {
+  helloStr.rangeOfString$(objcNeedle);
+});
+
+run("bind: rangeOfString: (struct return)", () => {
+  boundRange.invoke(objcNeedle);
+});
+
+run("prepared: substringWithRange: (struct arg)", () => {
+  helloStr.substringWithRange$(subRange);
+});
+
+run("bind: substringWithRange: (struct arg)", () => {
+  boundSubstring.invoke(subRange);
+});
+
 // ---------------------------------------------------------------------------
 // Summary
 // ---------------------------------------------------------------------------
@@ -0,0 +1,114 @@
+// Unit benchmark for src/native/image-range-index.h.
+//
+// Plain C++ with no Objective-C or N-API dependencies:
+//
+//   c++ -std=c++20 -O2 -Isrc/native benchmarks/native/image-ranges.cpp -o build/bench-image-ranges -ldl
+//   ./build/bench-image-ranges [--counters]
+//
+// Probes addresses inside images (functions, data symbols), on the heap, on
+// the stack and small integers, checks the index agrees with dladdr for
+// every one, then times both. `--counters` adds hardware counters per query
+// (see perf-counters.h).
+
+#include "image-range-index.h"
+#include "perf-counters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+int gImageData = 42;
+
+template <typename F>
+double TimeNs(nobjc::bench::PerfCounters &counters, size_t iterations,
+              F &&body) {
+  counters.Reset();
+  counters.Start();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) body(i);
+  auto end = std::chrono::steady_clock::now();
+  counters.Stop();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(iterations);
+}
+
+bool InImageByDladdr(const void *address) {
+  Dl_info info;
+  return dladdr(address, &info) != 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  nobjc::bench::PerfCounters counters(argc, argv);
+  nobjc::ImageRangeIndex &index = nobjc::ImageRangeIndex::Shared();
+
+  // MARK: - Correctness
+  std::vector<std::unique_ptr<char[]>> heap;
+  std::vector<const void *> probes;
+  int stackValue = 0;
+  probes.push_back(reinterpret_cast<const void *>(&std::printf));
+  probes.push_back(reinterpret_cast<const void *>(&std::malloc));
+  probes.push_back(reinterpret_cast<const void *>(&main));
+  probes.push_back(&gImageData);
+  probes.push_back(&stackValue);
+  probes.push_back(reinterpret_cast<const void *>(uintptr_t{16}));
+  probes.push_back(reinterpret_cast<const void *>(uintptr_t{4095}));
+  for (size_t i = 0; i < 64; i++) {
+    heap.emplace_back(new char[16 << (i % 12)]);
+    probes.push_back(heap.back().get());
+  }
+
+  size_t failures = 0;
+  size_t inside = 0;
+  for (const void *probe : probes) {
+    bool expected = InImageByDladdr(probe);
+    bool actual = index.Contains(probe);
+    inside += actual ? 1 : 0;
+    if (expected != actual) {
+      if (failures++ < 10) {
+        std::fprintf(stderr, "mismatch for %p: index %d, dladdr %d\n", probe,
+                     actual, expected);
+      }
+    }
+  }
+
+  // Images loaded after the index was built are picked up by Refresh().
+#if defined(__linux__)
+  const char *kLateLibrary = "libm.so.6";
+  void *late = dlopen(kLateLibrary, RTLD_LAZY);
+  void *lateSymbol = late != nullptr ? dlsym(late, "cbrt") : nullptr;
+  index.Refresh();
+  if (lateSymbol != nullptr && !index.Contains(lateSymbol)) {
+    std::fprintf(stderr, "late-loaded %s not indexed\n", kLateLibrary);
+    failures++;
+  }
+#endif
+
+  std::printf("checked %zu addresses (%zu in images) against dladdr, %zu ranges: %s\n",
+              probes.size(), inside, index.RangeCount(),
+              failures == 0 ? "ok" : "FAILED");
+  if (failures != 0) return 1;
+
+  // MARK: - Timing
+  const size_t iterations = 2000000;
+  volatile size_t sink = 0;
+  auto probe = [&](size_t i) { return probes[(i * 7919) % probes.size()]; };
+  auto report = [&](const char *label, double ns) {
+    std::printf("%-26s %8.1f ns/query  %s\n", label, ns,
+                counters.PerOp(static_cast<double>(iterations)).c_str());
+  };
+  report("ImageRangeIndex::Contains", TimeNs(counters, iterations, [&](size_t i) {
+    sink = sink + (index.Contains(probe(i)) ? 1 : 0);
+  }));
+  report("dladdr", TimeNs(counters, iterations, [&](size_t i) {
+    sink = sink + (InImageByDladdr(probe(i)) ? 1 : 0);
+  }));
+  return 0;
+}
@@ -0,0 +1,273 @@
+// Hardware performance counters for the native unit benchmarks.
+//
+// Pass `--counters` to a benchmark to report, per operation, next to its
+// timing:
+//
+//   cycles, instructions, branch misses, L1d read misses, LLC misses and
+//   page faults
+//
+// On Linux the counters come from perf_event_open(2), user space only.
+// Events the kernel or CPU does not provide are shown as "n/a". Containers
+// and perf_event_paranoid > 2 usually block all hardware events. On macOS,
+// cycles and instructions come from the fixed counters through the private
+// kperf framework, which needs root. Branch and cache events there need
+// kpep event configuration and are not collected. Page faults come from
+// getrusage(2). Without `--counters` nothing is opened and Start/Stop do
+// nothing.
+
+#ifndef NOBJC_BENCH_PERF_COUNTERS_H
+#define NOBJC_BENCH_PERF_COUNTERS_H
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <dlfcn.h>
+#endif
+
+namespace nobjc::bench {
+
+enum CounterId : size_t {
+  kCycles,
+  kInstructions,
+  kBranchMisses,
+  kL1dMisses,
+  kLlcMisses,
+  kPageFaults,
+  kCounterCount,
+};
+
+constexpr std::array<const char *, kCounterCount> kCounterNames = {
+    "cyc", "ins", "br-miss", "L1d-miss", "LLC-miss", "faults"};
+
+#if defined(__linux__)
+struct PerfEventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t PerfCacheReadMiss(uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+/// perf_event_open(2) events, indexed by CounterId.
+constexpr std::array<PerfEventConfig, kCounterCount> kPerfEvents = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PerfCacheReadMiss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, PerfCacheReadMiss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+}};
+#endif
+
+/// True if `--counters` is among the arguments.
+inline bool CountersRequested(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--counters") == 0) return true;
+  }
+  return false;
+}
+
+/// The first argument that is not a `--` flag, or nullptr.
+inline const char *PositionalArgument(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--", 2) != 0) return argv[i];
+  }
+  return nullptr;
+}
+
+/**
+ * Counts events for the calling thread between Start() and Stop(). Several
+ * Start/Stop pairs accumulate until Reset().
+ */
+class PerfCounters {
+public:
+  explicit PerfCounters(bool enabled) : enabled_(enabled) {
+    if (enabled_) Open();
+  }
+
+  PerfCounters(int argc, char **argv)
+      : PerfCounters(CountersRequested(argc, argv)) {}
+
+  ~PerfCounters() {
+#if defined(__linux__)
+    for (int fd : fds_) {
+      if (fd >= 0) close(fd);
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  bool Enabled() const { return enabled_; }
+
+  void Reset() { totals_.fill(0); }
+
+  void Start() {
+    if (!enabled_) return;
+    Read(start_);
+  }
+
+  void Stop() {
+    if (!enabled_) return;
+    std::array<double, kCounterCount> end{};
+    Read(end);
+    for (size_t i = 0; i < kCounterCount; i++) totals_[i] += end[i] - start_[i];
+  }
+
+  /// Accumulated counts divided by `operations`, e.g.
+  /// "12.0 cyc  31.5 ins  0.02 br-miss  n/a L1d-miss ...". Empty if disabled.
+  std::string PerOp(double operations) const {
+    if (!enabled_ || operations <= 0) return {};
+    std::string out;
+    char cell[48];
+    for (size_t i = 0; i < kCounterCount; i++) {
+      if (available_[i]) {
+        const double value = totals_[i] / operations;
+        std::snprintf(cell, sizeof(cell), "%s%.*f %s", out.empty() ? "" : "  ",
+                      value < 10 ? 2 : 1, value, kCounterNames[i]);
+      } else {
+        std::snprintf(cell, sizeof(cell), "%sn/a %s", out.empty() ? "" : "  ",
+                      kCounterNames[i]);
+      }
+      out += cell;
+    }
+    return out;
+  }
+
+private:
+#if defined(__linux__)
+  // Events are opened separately rather than as one group so a missing
+  // event does not disable the rest. If the kernel multiplexes them, counts
+  // are scaled by enabled/running time.
+  void Open() {
+    int firstError = 0;
+    for (size_t i = 0; i < kCounterCount; i++) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = kPerfEvents[i].type;
+      attr.config = kPerfEvents[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds_[i] = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0 /* this thread */,
+                  -1 /* any cpu */, -1 /* no group */, 0));
+      available_[i] = fds_[i] >= 0;
+      if (!available_[i] && firstError == 0) firstError = errno;
+    }
+    if (firstError != 0) {
+      std::fprintf(stderr,
+                   "note: some perf events are unavailable (%s); see "
+                   "/proc/sys/kernel/perf_event_paranoid\n",
+                   std::strerror(firstError));
+    }
+  }
+
+  void Read(std::array<double, kCounterCount> &out) {
+    for (size_t i = 0; i < kCounterCount; i++) {
+      uint64_t values[3] = {}; // value, time enabled, time running
+      if (!available_[i] ||
+          read(fds_[i], values, sizeof(values)) != sizeof(values)) {
+        out[i] = 0;
+        continue;
+      }
+      out[i] = values[2] == 0 ? 0
+                              : static_cast<double>(values[0]) *
+                                    (static_cast<double>(values[1]) /
+                                     static_cast<double>(values[2]));
+    }
+  }
+
+  std::array<int, kCounterCount> fds_ = {-1, -1, -1, -1, -1, -1};
+#elif defined(__APPLE__)
+  // kperf (private framework). Fixed counter classes only; configurable
+  // counters need a kpep event database.
+  static constexpr uint32_t kKpcClassFixedMask = 1;
+  using KpcSetCounting = int (*)(uint32_t);
+  using KpcGetCounterCount = uint32_t (*)(uint32_t);
+  using KpcGetThreadCounters = int (*)(uint32_t, uint32_t, uint64_t *);
+
+  void Open() {
+    available_[kPageFaults] = true;
+    void *kperf = dlopen(
+        "/System/Library/PrivateFrameworks/kperf.framework/kperf", RTLD_LAZY);
+    auto setCounting = kperf ? reinterpret_cast<KpcSetCounting>(
+                                   dlsym(kperf, "kpc_set_counting"))
+                             : nullptr;
+    auto setThreadCounting = kperf ? reinterpret_cast<KpcSetCounting>(
+                                         dlsym(kperf, "kpc_set_thread_counting"))
+                                   : nullptr;
+    auto counterCount = kperf ? reinterpret_cast<KpcGetCounterCount>(
+                                    dlsym(kperf, "kpc_get_counter_count"))
+                              : nullptr;
+    getThreadCounters_ = kperf ? reinterpret_cast<KpcGetThreadCounters>(
+                                     dlsym(kperf, "kpc_get_thread_counters"))
+                               : nullptr;
+    if (!setCounting || !setThreadCounting || !counterCount ||
+        !getThreadCounters_ || setCounting(kKpcClassFixedMask) != 0 ||
+        setThreadCounting(kKpcClassFixedMask) != 0) {
+      std::fprintf(stderr, "note: kperf counters are unavailable (run as root "
+                           "to collect cycles and instructions)\n");
+      getThreadCounters_ = nullptr;
+      return;
+    }
+    fixedCount_ = counterCount(kKpcClassFixedMask);
+    available_[kCycles] = available_[kInstructions] = fixedCount_ >= 2;
+  }
+
+  void Read(std::array<double, kCounterCount> &out) {
+    out.fill(0);
+    if (getThreadCounters_ != nullptr && fixedCount_ >= 2) {
+      uint64_t fixed[8] = {};
+      if (getThreadCounters_(0, fixedCount_ < 8 ? fixedCount_ : 8, fixed) == 0) {
+#if defined(__arm64__)
+        out[kCycles] = static_cast<double>(fixed[0]);
+        out[kInstructions] = static_cast<double>(fixed[1]);
+#else
+        out[kInstructions] = static_cast<double>(fixed[0]);
+        out[kCycles] = static_cast<double>(fixed[1]);
+#endif
+      }
+    }
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    out[kPageFaults] = static_cast<double>(usage.ru_minflt + usage.ru_majflt);
+  }
+
+  KpcGetThreadCounters getThreadCounters_ = nullptr;
+  uint32_t fixedCount_ = 0;
+#else
+  void Open() { available_[kPageFaults] = true; }
+
+  void Read(std::array<double, kCounterCount> &out) {
+    out.fill(0);
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    out[kPageFaults] = static_cast<double>(usage.ru_minflt + usage.ru_majflt);
+  }
+#endif
+
+  bool enabled_;
+  std::array<bool, kCounterCount> available_{};
+  std::array<double, kCounterCount> start_{};
+  std::array<double, kCounterCount> totals_{};
+};
+
+} // namespace nobjc::bench
+
+#endif // NOBJC_BENCH_PERF_COUNTERS_H
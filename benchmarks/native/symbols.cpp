@@ -0,0 +1,143 @@
+// Unit benchmark for src/native/symbol-index.h.
+//
+// Plain C++ with no Objective-C or N-API dependencies. On Linux it exercises
+// the ELF GNU/SysV hash path; on macOS the Mach-O export trie:
+//
+//   c++ -std=c++20 -O2 -Isrc/native benchmarks/native/symbols.cpp -o build/bench-symbols -ldl
+//   ./build/bench-symbols [--counters]
+//
+// Every exported name of a system library is first resolved through the
+// index and checked against dlsym on the same image handle, then lookups are
+// timed against dlsym(handle) and dlsym(RTLD_DEFAULT). `--counters` adds
+// hardware counters per lookup (see perf-counters.h).
+
+#include "symbol-index.h"
+#include "perf-counters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if defined(__APPLE__)
+const char *kLibrary = "/usr/lib/libSystem.B.dylib";
+const char *kSampleNames[] = {"malloc", "free", "strlen", "memcpy", "printf",
+                              "dispatch_async", "pthread_create", "open",
+                              "close", "qsort", "getenv", "nanosleep"};
+#else
+const char *kLibrary = "libc.so.6";
+#endif
+
+// MARK: - Name Corpus
+
+// All defined names in the library's dynamic symbol table (Linux), or a
+// fixed sample (macOS, where libSystem's exports are re-exports).
+std::vector<std::string> CollectNames() {
+  std::vector<std::string> names;
+#if defined(__linux__)
+  void *handle = dlopen(kLibrary, RTLD_LAZY);
+  link_map *map = nullptr;
+  dlinfo(handle, RTLD_DI_LINKMAP, &map);
+  nobjc::symbol_detail::ElfExports exports;
+  if (!nobjc::symbol_detail::LocateDynamicTables(map, exports) ||
+      exports.gnuBuckets == nullptr) {
+    std::fprintf(stderr, "no GNU hash table in %s\n", kLibrary);
+    std::exit(1);
+  }
+  for (uint32_t b = 0; b < exports.gnuBucketCount; b++) {
+    uint32_t index = exports.gnuBuckets[b];
+    if (index < exports.gnuSymOffset) continue;
+    for (;; index++) {
+      const ElfW(Sym) &sym = exports.symtab[index];
+      if (sym.st_shndx != SHN_UNDEF &&
+          (exports.versym == nullptr || (exports.versym[index] & 0x8000) == 0)) {
+        names.emplace_back(exports.strtab + sym.st_name);
+      }
+      if (exports.gnuChain[index - exports.gnuSymOffset] & 1) break;
+    }
+  }
+#else
+  for (const char *name : kSampleNames) names.emplace_back(name);
+#endif
+  return names;
+}
+
+template <typename F>
+double TimeNs(nobjc::bench::PerfCounters &counters, size_t iterations,
+              F &&body) {
+  counters.Reset();
+  counters.Start();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) body(i);
+  auto end = std::chrono::steady_clock::now();
+  counters.Stop();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  nobjc::bench::PerfCounters counters(argc, argv);
+  void *handle = dlopen(kLibrary, RTLD_LAZY);
+  if (handle == nullptr) {
+    std::fprintf(stderr, "cannot open %s: %s\n", kLibrary, dlerror());
+    return 1;
+  }
+  auto index = nobjc::ImageSymbolIndex::Open(kLibrary);
+  if (!index) {
+    std::fprintf(stderr, "cannot index %s\n", kLibrary);
+    return 1;
+  }
+
+  // MARK: - Correctness
+  std::vector<std::string> names = CollectNames();
+  size_t failures = 0;
+  size_t indirect = 0;
+  for (const std::string &name : names) {
+    void *address = nullptr;
+    if (index->Find(name.c_str(), &address) == nobjc::SymbolLookup::NeedsDlsym) {
+      indirect++;
+    }
+    void *expected = dlsym(handle, name.c_str());
+    void *actual = index->Resolve(name.c_str());
+    if (actual != expected) {
+      if (failures++ < 10) {
+        std::fprintf(stderr, "mismatch for %s: index %p, dlsym %p\n",
+                     name.c_str(), actual, expected);
+      }
+    }
+  }
+  const char *missing[] = {"nobjc_not_a_symbol", "", "mallocx", "strle"};
+  for (const char *name : missing) {
+    if (index->Resolve(name) != nullptr) {
+      std::fprintf(stderr, "unexpected hit for \"%s\"\n", name);
+      failures++;
+    }
+  }
+  std::printf("checked %zu names (%zu indirect) in %s: %s\n", names.size(),
+              indirect, kLibrary, failures == 0 ? "ok" : "FAILED");
+  if (failures != 0) return 1;
+
+  // MARK: - Timing
+  const size_t iterations = 200000;
+  volatile uintptr_t sink = 0;
+  auto name = [&](size_t i) { return names[(i * 7919) % names.size()].c_str(); };
+  auto report = [&](const char *label, double ns) {
+    std::printf("%-26s %8.1f ns/lookup  %s\n", label, ns,
+                counters.PerOp(static_cast<double>(iterations)).c_str());
+  };
+  report("ImageSymbolIndex::Resolve", TimeNs(counters, iterations, [&](size_t i) {
+    sink = sink + reinterpret_cast<uintptr_t>(index->Resolve(name(i)));
+  }));
+  report("dlsym(handle)", TimeNs(counters, iterations, [&](size_t i) {
+    sink = sink + reinterpret_cast<uintptr_t>(dlsym(handle, name(i)));
+  }));
+  report("dlsym(RTLD_DEFAULT)", TimeNs(counters, iterations, [&](size_t i) {
+    sink = sink + reinterpret_cast<uintptr_t>(dlsym(RTLD_DEFAULT, name(i)));
+  }));
+  return 0;
+}
@@ -0,0 +1,343 @@
+// Unit benchmark for src/native/string-transcode.h.
+//
+// Plain C++ with no Objective-C or N-API dependencies, so it builds and runs
+// on Linux as well as macOS:
+//
+//   c++ -std=c++20 -O2 -Isrc/native benchmarks/native/transcode.cpp -o build/bench-transcode
+//   ./build/bench-transcode [megabytes] [--counters]
+//
+// (or `npm run bench:native`). Every kernel is first checked against a
+// byte-at-a-time reference on a set of corpora, then timed against it.
+// `--counters` adds hardware counters per KiB of input (see
+// perf-counters.h).
+
+#include "string-transcode.h"
+#include "perf-counters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// MARK: - Reference Implementations
+
+size_t ReferenceAsciiPrefix(const std::string &s) {
+  size_t i = 0;
+  while (i < s.size() && static_cast<unsigned char>(s[i]) < 0x80) i++;
+  return i;
+}
+
+// Decode UTF-8 to code points, or return false if malformed.
+bool ReferenceDecode(const std::string &s, std::vector<uint32_t> &out) {
+  out.clear();
+  const auto *p = reinterpret_cast<const unsigned char *>(s.data());
+  size_t i = 0;
+  while (i < s.size()) {
+    uint32_t cp;
+    size_t len;
+    if (p[i] < 0x80) { cp = p[i]; len = 1; }
+    else if (p[i] >= 0xC2 && p[i] < 0xE0) { cp = p[i] & 0x1F; len = 2; }
+    else if (p[i] >= 0xE0 && p[i] < 0xF0) { cp = p[i] & 0x0F; len = 3; }
+    else if (p[i] >= 0xF0 && p[i] < 0xF5) { cp = p[i] & 0x07; len = 4; }
+    else return false;
+    if (i + len > s.size()) return false;
+    for (size_t k = 1; k < len; k++) {
+      if ((p[i + k] & 0xC0) != 0x80) return false;
+      cp = (cp << 6) | (p[i + k] & 0x3F);
+    }
+    if ((len == 3 && cp < 0x800) || (len == 4 && cp < 0x10000) ||
+        cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+      return false;
+    }
+    out.push_back(cp);
+    i += len;
+  }
+  return true;
+}
+
+std::u16string ReferenceUtf16(const std::vector<uint32_t> &cps) {
+  std::u16string out;
+  for (uint32_t cp : cps) {
+    if (cp >= 0x10000) {
+      cp -= 0x10000;
+      out.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+      out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+    } else {
+      out.push_back(static_cast<char16_t>(cp));
+    }
+  }
+  return out;
+}
+
+// MARK: - Corpora
+
+void AppendCodePoint(std::string &s, uint32_t cp) {
+  if (cp < 0x80) {
+    s.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    s.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    s.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    s.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+std::string ReferenceUtf8(const std::u16string &utf16) {
+  std::string out;
+  for (size_t i = 0; i < utf16.size(); i++) {
+    uint32_t cp = utf16[i];
+    if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < utf16.size() &&
+        utf16[i + 1] >= 0xDC00 && utf16[i + 1] <= 0xDFFF) {
+      cp = 0x10000 + ((cp - 0xD800) << 10) + (utf16[++i] - 0xDC00);
+    } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+      cp = 0xFFFD;
+    }
+    AppendCodePoint(out, cp);
+  }
+  return out;
+}
+
+struct Corpus {
+  const char *name;
+  std::string utf8;
+};
+
+// `nonAsciiEvery` controls how often a code point is drawn from `range`
+// instead of printable ASCII (0 = pure ASCII).
+std::string MakeText(size_t bytes, uint32_t lo, uint32_t hi, int nonAsciiEvery,
+                     uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<uint32_t> ascii(0x20, 0x7E);
+  std::uniform_int_distribution<uint32_t> wide(lo, hi);
+  std::string s;
+  s.reserve(bytes + 4);
+  int n = 0;
+  while (s.size() < bytes) {
+    uint32_t cp = (nonAsciiEvery > 0 && ++n % nonAsciiEvery == 0) ? wide(rng)
+                                                                  : ascii(rng);
+    if (cp >= 0xD800 && cp <= 0xDFFF) continue;
+    AppendCodePoint(s, cp);
+  }
+  return s;
+}
+
+std::vector<Corpus> MakeCorpora(size_t bytes) {
+  return {
+      {"ascii", MakeText(bytes, 0, 0, 0, 1)},
+      {"latin1 (1/40)", MakeText(bytes, 0xA0, 0xFF, 40, 2)},
+      {"mixed BMP (1/8)", MakeText(bytes, 0x400, 0x4FF, 8, 3)},
+      {"cjk", MakeText(bytes, 0x4E00, 0x9FFF, 1, 4)},
+      {"emoji (1/16)", MakeText(bytes, 0x1F300, 0x1F6FF, 16, 5)},
+  };
+}
+
+// MARK: - Correctness
+
+int failures = 0;
+
+void Check(bool ok, const char *what, const std::string &input) {
+  if (!ok) {
+    failures++;
+    std::fprintf(stderr, "FAIL: %s (input %zu bytes)\n", what, input.size());
+  }
+}
+
+void VerifyString(const std::string &s) {
+  Check(nobjc::AsciiPrefixLength(s.data(), s.size()) == ReferenceAsciiPrefix(s),
+        "AsciiPrefixLength", s);
+
+  std::vector<uint32_t> cps;
+  bool valid = ReferenceDecode(s, cps);
+
+  std::u16string utf16(s.size() + 1, u'\0');
+  size_t n16 = nobjc::Utf8ToUtf16(s.data(), s.size(), utf16.data());
+  Check(valid == (n16 != nobjc::kTranscodeInvalid), "Utf8ToUtf16 validity", s);
+  if (!valid) return;
+
+  std::u16string expected = ReferenceUtf16(cps);
+  utf16.resize(n16);
+  Check(utf16 == expected, "Utf8ToUtf16 output", s);
+
+  std::string back(utf16.size() * 3 + 1, '\0');
+  size_t n8 = nobjc::Utf16ToUtf8(utf16.data(), utf16.size(), back.data());
+  back.resize(n8);
+  Check(back == s, "Utf16ToUtf8 round trip", s);
+
+  bool allAscii = true, allLatin1 = true;
+  for (uint32_t cp : cps) {
+    if (cp >= 0x80) allAscii = false;
+    if (cp >= 0x100) allLatin1 = false;
+  }
+  nobjc::TextClass expectedClass = allAscii    ? nobjc::TextClass::Ascii
+                                   : allLatin1 ? nobjc::TextClass::Latin1
+                                               : nobjc::TextClass::Other;
+  Check(nobjc::ClassifyUtf8(s.data(), s.size()) == expectedClass, "ClassifyUtf8", s);
+  Check(nobjc::ClassifyUtf16(utf16.data(), utf16.size()) == expectedClass,
+        "ClassifyUtf16", s);
+  Check(nobjc::IsLatin1(utf16.data(), utf16.size()) == allLatin1, "IsLatin1", s);
+
+  std::string latin1(s.size(), '\0');
+  size_t nl = nobjc::Utf8ToLatin1(s.data(), s.size(), latin1.data());
+  Check((nl != nobjc::kTranscodeInvalid) == allLatin1, "Utf8ToLatin1 validity", s);
+  if (allLatin1) {
+    latin1.resize(nl);
+    bool same = latin1.size() == cps.size();
+    for (size_t i = 0; same && i < cps.size(); i++) {
+      same = static_cast<unsigned char>(latin1[i]) == cps[i];
+    }
+    Check(same, "Utf8ToLatin1 output", s);
+
+    std::u16string widened(nl, u'\0');
+    nobjc::Latin1ToUtf16(latin1.data(), nl, widened.data());
+    Check(widened == expected, "Latin1ToUtf16", s);
+
+    std::string narrowed(utf16.size(), '\0');
+    nobjc::Utf16ToLatin1(utf16.data(), utf16.size(), narrowed.data());
+    Check(narrowed == latin1, "Utf16ToLatin1", s);
+  }
+}
+
+void VerifyAll(const std::vector<Corpus> &corpora) {
+  // Every length and alignment around the vector widths.
+  for (const Corpus &corpus : corpora) {
+    for (size_t offset = 0; offset < 5; offset++) {
+      for (size_t len = 0; len < 200 && offset + len <= corpus.utf8.size(); len++) {
+        std::string slice = corpus.utf8.substr(offset, len);
+        VerifyString(slice);
+      }
+    }
+    VerifyString(corpus.utf8);
+  }
+
+  // Malformed input must be rejected, never mis-decoded.
+  const char *invalid[] = {
+      "\x80",             "abc\xC0\xAF",      "\xC2",
+      "\xE0\x80\xAF",     "\xED\xA0\x80",     "\xF4\x90\x80\x80",
+      "\xF0\x9F\x98",     "\xFF",             "valid prefix then \xC3",
+  };
+  for (const char *s : invalid) {
+    std::string str(s);
+    std::u16string out(str.size() + 1, u'\0');
+    Check(nobjc::Utf8ToUtf16(str.data(), str.size(), out.data()) ==
+              nobjc::kTranscodeInvalid,
+          "reject malformed UTF-8", str);
+    Check(nobjc::ClassifyUtf8(str.data(), str.size()) == nobjc::TextClass::Other,
+          "classify malformed UTF-8", str);
+  }
+
+  // Lone surrogates encode as U+FFFD.
+  const char16_t lone[] = {u'a', 0xD800, u'b', 0xDC00};
+  char encoded[16];
+  size_t n = nobjc::Utf16ToUtf8(lone, 4, encoded);
+  Check(std::string(encoded, n) == "a\xEF\xBF\xBD" "b\xEF\xBF\xBD",
+        "lone surrogates", "");
+}
+
+// MARK: - Timing
+
+struct Throughput {
+  double gbps;
+  std::string countersPerKiB; // Empty without --counters
+};
+
+Throughput Measure(nobjc::bench::PerfCounters &counters, size_t bytes,
+                   const std::function<void()> &fn) {
+  using Clock = std::chrono::steady_clock;
+  fn(); // warm up
+  size_t iterations = 0;
+  counters.Reset();
+  counters.Start();
+  auto start = Clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    fn();
+    iterations++;
+    elapsed = Clock::now() - start;
+  } while (elapsed.count() < 0.25);
+  counters.Stop();
+  const double total = static_cast<double>(bytes) * iterations;
+  return {total / elapsed.count() / 1e9, counters.PerOp(total / 1024)};
+}
+
+volatile size_t sink;
+
+void Bench(const std::vector<Corpus> &corpora,
+           nobjc::bench::PerfCounters &counters) {
+  std::printf("%-18s %-16s %10s %10s %8s\n", "corpus", "operation", "vector",
+              "scalar", "speedup");
+  for (const Corpus &corpus : corpora) {
+    const std::string &s = corpus.utf8;
+    std::u16string utf16(s.size(), u'\0');
+    size_t n16 = nobjc::Utf8ToUtf16(s.data(), s.size(), utf16.data());
+    utf16.resize(n16);
+    std::string out8(utf16.size() * 3, '\0');
+    std::u16string out16(s.size(), u'\0');
+    std::vector<uint32_t> cps;
+
+    auto row = [&](const char *op, const std::function<void()> &vec,
+                   const std::function<void()> &ref) {
+      Throughput v = Measure(counters, s.size(), vec);
+      Throughput r = Measure(counters, s.size(), ref);
+      std::printf("%-18s %-16s %8.2f GB/s %6.2f GB/s %7.1fx\n", corpus.name, op,
+                  v.gbps, r.gbps, v.gbps / r.gbps);
+      if (counters.Enabled()) {
+        std::printf("%35s per KiB: %s\n", "vector", v.countersPerKiB.c_str());
+        std::printf("%35s per KiB: %s\n", "scalar", r.countersPerKiB.c_str());
+      }
+    };
+
+    // Detection stops at the first byte that rules a class out, so it is
+    // only timed on corpora it has to scan end to end.
+    nobjc::TextClass textClass = nobjc::ClassifyUtf8(s.data(), s.size());
+    if (textClass == nobjc::TextClass::Ascii) {
+      row("ascii scan",
+          [&] { sink = nobjc::AsciiPrefixLength(s.data(), s.size()); },
+          [&] { sink = ReferenceAsciiPrefix(s); });
+    }
+    if (textClass != nobjc::TextClass::Other) {
+      row("classify utf8",
+          [&] { sink = static_cast<size_t>(nobjc::ClassifyUtf8(s.data(), s.size())); },
+          [&] { sink = ReferenceDecode(s, cps); });
+    }
+    row("utf8 -> utf16",
+        [&] { sink = nobjc::Utf8ToUtf16(s.data(), s.size(), out16.data()); },
+        [&] {
+          ReferenceDecode(s, cps);
+          sink = ReferenceUtf16(cps).size();
+        });
+    row("utf16 -> utf8",
+        [&] { sink = nobjc::Utf16ToUtf8(utf16.data(), utf16.size(), out8.data()); },
+        [&] { sink = ReferenceUtf8(utf16).size(); });
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const char *size = nobjc::bench::PositionalArgument(argc, argv);
+  size_t megabytes = size != nullptr ? std::strtoul(size, nullptr, 10) : 16;
+  nobjc::bench::PerfCounters counters(argc, argv);
+  std::vector<Corpus> corpora = MakeCorpora(megabytes << 20);
+
+  VerifyAll(MakeCorpora(4096));
+  if (failures) {
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("all transcoding checks passed\n\n");
+
+  Bench(corpora, counters);
+  return 0;
+}
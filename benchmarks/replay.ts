@@ -0,0 +1,425 @@
+/**
+ * Replay benchmark for call traces recorded with `Trace`.
+ *
+ * Synthetic benchmarks in bench.ts exercise each path in isolation. This
+ * tool instead replays the call mix of a real application: the recorded
+ * sequence of sends, C function calls and callbacks, with their argument
+ * and return kinds, against stand-in targets.
+ *
+ * Backends:
+ *   - foundation: each recorded shape is mapped to a Foundation method (or
+ *     C function) with the same argument and return kinds. Callbacks are
+ *     replayed through an enumeration bound once per shape, so the native
+ *     block is built once, and cross-thread callbacks through a concurrent
+ *     one. The enumeration send itself is timed separately on an empty
+ *     array and subtracted, so callback rows count only the callbacks.
+ *     Requires macOS.
+ *   - dry: a pure-JS stand-in runtime that converts argument and return
+ *     values of the recorded kinds and sizes and queues cross-thread
+ *     callbacks. It runs anywhere, including Linux CI. Its numbers show how
+ *     the call mix stresses the JS side only and are not comparable to the
+ *     foundation backend.
+ *
+ * Results are written to benchmarks/REPLAY.md.
+ *
+ * Usage:
+ *   bun run benchmarks/replay.ts <trace> [--backend foundation|dry] [--iterations N]
+ *
+ * Record a trace with:
+ *   Trace.start(); runWorkload(); fs.writeFileSync("calls.nobjctrace", Trace.stop());
+ */
+
+import { readFileSync, writeFileSync } from "node:fs";
+import { join, dirname } from "node:path";
+import { fileURLToPath } from "node:url";
+import { execSync } from "node:child_process";
+import { parseTrace, summarizeTrace } from "../dist/trace-format.js";
+import type { CallTrace, TraceCallKind, TraceShape, TraceValueShape } from "../dist/trace-format.js";
+
+// ---------------------------------------------------------------------------
+// Replay plan
+// ---------------------------------------------------------------------------
+
+/** Replays recorded calls. */
+interface Operation {
+  run: () => void;
+  /**
+   * `run` without the replayed calls (for callbacks, the send that
+   * triggers them). Its time is measured separately and subtracted.
+   */
+  overhead?: () => void;
+}
+
+/**
+ * One replay step: a shape's operation run `count` times. Consecutive
+ * cross-thread callbacks are batched into one step because they are
+ * replayed as one concurrent enumeration.
+ */
+interface Step extends Operation {
+  kind: TraceCallKind;
+  count: number;
+}
+
+interface Backend {
+  name: string;
+  /** Build the operation replaying one call of `shape`, `count` times. */
+  operation(shape: TraceShape, count: number): Operation;
+}
+
+function buildSteps(trace: CallTrace, backend: Backend): Step[] {
+  const steps: Step[] = [];
+  const cache = new Map<string, Operation>();
+  const operation = (shapeIndex: number, count: number) => {
+    const key = `${shapeIndex}x${count}`;
+    let op = cache.get(key);
+    if (!op) {
+      op = backend.operation(trace.shapes[shapeIndex], count);
+      cache.set(key, op);
+    }
+    return op;
+  };
+
+  const records = trace.records;
+  for (let i = 0; i < records.length; ) {
+    const shapeIndex = records[i].shape;
+    const kind = trace.shapes[shapeIndex].kind;
+    let count = 1;
+    if (kind === "crossThreadCallback") {
+      while (i + count < records.length && records[i + count].shape === shapeIndex) {
+        count++;
+      }
+    }
+    steps.push({ kind, ...operation(shapeIndex, count), count });
+    i += count;
+  }
+  return steps;
+}
+
+// ---------------------------------------------------------------------------
+// Kind families
+// ---------------------------------------------------------------------------
+
+/** o: object, i: integer, f: floating point, s: struct, p: pointer, v: void */
+type Family = "o" | "i" | "f" | "s" | "p" | "v";
+
+function family(value: TraceValueShape): Family {
+  const kind = value.kind;
+  if (kind === "@" || kind === "#") return "o";
+  if ("cCsSiIlLqQB".includes(kind)) return "i";
+  if (kind === "f" || kind === "d") return "f";
+  if (kind === "{") return "s";
+  if (kind === "v") return "v";
+  return "p";
+}
+
+function signatureOf(shape: TraceShape): string {
+  return `${shape.args.map(family).join("")}->${family(shape.returns)}`;
+}
+
+// ---------------------------------------------------------------------------
+// Foundation backend
+// ---------------------------------------------------------------------------
+
+async function createFoundationBackend(): Promise<Backend> {
+  const { NobjcLibrary, bind, callFunction, typedBlock } = await import("../dist/index.js");
+  const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+  const NSString = foundation["NSString"] as any;
+  const NSNumber = foundation["NSNumber"] as any;
+  const NSMutableArray = foundation["NSMutableArray"] as any;
+  const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+  const NSMutableString = foundation["NSMutableString"] as any;
+  const NSMutableData = foundation["NSMutableData"] as any;
+  const NSValue = foundation["NSValue"] as any;
+  const NSEnumerationConcurrent = 1;
+
+  const str = NSString.stringWithUTF8String$("replay");
+  const num = NSNumber.numberWithDouble$(1.5);
+  const array = NSMutableArray.array();
+  array.addObject$(str);
+  const dict = NSMutableDictionary.dictionary();
+  const mutableString = NSMutableString.string();
+  const data = NSMutableData.data();
+  const range = { location: 0, length: 1 };
+  const rangeValue = NSValue.valueWithRange$(range);
+
+  // Foundation stand-ins by family signature (see signatureOf)
+  const sends: Record<string, () => unknown> = {
+    "->i": () => str.length(),
+    "->o": () => str.uppercaseString(),
+    "->f": () => num.doubleValue(),
+    "->v": () => dict.removeAllObjects(),
+    "->s": () => rangeValue.rangeValue(),
+    "i->o": () => array.objectAtIndex$(0),
+    "i->i": () => str.characterAtIndex$(0),
+    "i->v": () => data.setLength$(16),
+    "f->o": () => NSNumber.numberWithDouble$(2.5),
+    "o->i": () => str.isEqualToString$(str),
+    "o->o": () => str.stringByAppendingString$(str),
+    "o->v": () => mutableString.setString$(str),
+    "o->s": () => str.rangeOfString$(str),
+    "s->o": () => str.substringWithRange$(range),
+    "oi->i": () => str.compare$options$(str, 0),
+    "oo->v": () => dict.setObject$forKey$(num, str)
+  };
+  const functions: Record<string, () => unknown> = {
+    "->f": () => callFunction("CFAbsoluteTimeGetCurrent", { returns: "d" }),
+    "o->i": () => callFunction("CFGetRetainCount", { returns: "q", args: ["@"] }, str)
+  };
+
+  // Closest stand-in: same signature, else same arity and return family,
+  // else the zero-argument send with the same return family.
+  const closest = (table: Record<string, () => unknown>, shape: TraceShape) => {
+    const signature = signatureOf(shape);
+    if (table[signature]) return table[signature];
+    const [args, ret] = signature.split("->");
+    const sameArity = Object.keys(table).find((key) => key.split("->")[0].length === args.length && key.endsWith(ret));
+    return table[sameArity ?? `->${ret}`] ?? table["->o"] ?? Object.values(table)[0];
+  };
+
+  const arrays = new Map<number, any>();
+  const arrayOfLength = (length: number) => {
+    let result = arrays.get(length);
+    if (!result) {
+      result = NSMutableArray.array();
+      for (let i = 0; i < length; i++) result.addObject$(num);
+      arrays.set(length, result);
+    }
+    return result;
+  };
+
+  // Binding converts the block once; each invoke reuses the native block.
+  const enumeration = (length: number, options?: number) => {
+    const block = typedBlock({ returns: "v", args: ["@", "Q", "^B"] }, () => {});
+    const enumerate = (target: any) =>
+      options === undefined
+        ? bind(target, "enumerateObjectsUsingBlock$", [block])
+        : bind(target, "enumerateObjectsWithOptions$usingBlock$", [options, block]);
+    const calls = enumerate(arrayOfLength(length));
+    const empty = enumerate(arrayOfLength(0));
+    return { run: () => calls.invoke(), overhead: () => empty.invoke() };
+  };
+
+  return {
+    name: "foundation",
+    operation(shape, count) {
+      switch (shape.kind) {
+        case "send":
+          return { run: closest(sends, shape) as () => void };
+        case "function":
+          return { run: closest(functions, shape) as () => void };
+        case "callback":
+          return enumeration(1);
+        case "crossThreadCallback":
+          return enumeration(count, NSEnumerationConcurrent);
+      }
+    }
+  };
+}
+
+// ---------------------------------------------------------------------------
+// Dry backend
+// ---------------------------------------------------------------------------
+
+function createDryBackend(): Backend {
+  const scratch = new DataView(new ArrayBuffer(4096));
+  const wrappers = new Map<number, object>();
+  const queue: Array<() => void> = [];
+
+  // Stand-in for converting one value to or from its native representation
+  const marshal = (value: TraceValueShape, seed: number): unknown => {
+    const size = Math.min(Math.max(value.size, 1), scratch.byteLength);
+    switch (family(value)) {
+      case "i":
+        scratch.setUint32(0, seed);
+        return scratch.getUint32(0);
+      case "f":
+        scratch.setFloat64(0, seed * 0.5);
+        return scratch.getFloat64(0);
+      case "s": {
+        const fields: number[] = [];
+        for (let offset = 0; offset + 8 <= size; offset += 8) {
+          scratch.setFloat64(offset, seed + offset);
+          fields.push(scratch.getFloat64(offset));
+        }
+        return fields;
+      }
+      case "o": {
+        let wrapper = wrappers.get(seed & 0xff);
+        if (!wrapper) {
+          wrapper = { seed };
+          wrappers.set(seed & 0xff, wrapper);
+        }
+        return wrapper;
+      }
+      case "p":
+        return BigInt(seed);
+      case "v":
+        return undefined;
+    }
+  };
+
+  let seed = 0;
+  return {
+    name: "dry",
+    operation(shape, count) {
+      const call = () => {
+        seed = (seed + 1) | 0;
+        const args = shape.args.map((arg) => marshal(arg, seed));
+        return marshal(shape.returns, args.length + seed);
+      };
+      if (shape.kind !== "crossThreadCallback") {
+        return { run: call };
+      }
+      return {
+        run: () => {
+          for (let i = 0; i < count; i++) queue.push(call);
+          while (queue.length > 0) queue.shift()!();
+        }
+      };
+    }
+  };
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+interface KindResult {
+  kind: TraceCallKind | "total";
+  calls: number;
+  /** Time spent in the replayed calls, with `overheadMs` already subtracted */
+  totalMs: number;
+  /** Time of the harness around the calls (e.g. enumeration sends) */
+  overheadMs: number;
+  callsPerSec: number;
+}
+
+function timeRuns(runs: Array<() => void>, iterations: number): number {
+  const start = performance.now();
+  for (let i = 0; i < iterations; i++) {
+    for (let j = 0; j < runs.length; j++) runs[j]();
+  }
+  return performance.now() - start;
+}
+
+function runSteps(steps: Step[], iterations: number): { calls: number; totalMs: number; overheadMs: number } {
+  let calls = 0;
+  for (const step of steps) calls += step.count;
+  const grossMs = timeRuns(steps.map((step) => step.run), iterations);
+  const overheads = steps.flatMap((step) => (step.overhead ? [step.overhead] : []));
+  const overheadMs = overheads.length > 0 ? timeRuns(overheads, iterations) : 0;
+  return { calls: calls * iterations, totalMs: Math.max(grossMs - overheadMs, 0), overheadMs };
+}
+
+function measure(steps: Step[], iterations: number): KindResult[] {
+  runSteps(steps, 1); // Warmup
+  const results: KindResult[] = [];
+  const kinds: TraceCallKind[] = ["send", "function", "callback", "crossThreadCallback"];
+  const result = (kind: KindResult["kind"], subset: Step[]): KindResult => {
+    const { calls, totalMs, overheadMs } = runSteps(subset, iterations);
+    return { kind, calls, totalMs, overheadMs, callsPerSec: totalMs > 0 ? calls / (totalMs / 1000) : 0 };
+  };
+  for (const kind of kinds) {
+    const subset = steps.filter((step) => step.kind === kind);
+    if (subset.length > 0) results.push(result(kind, subset));
+  }
+  results.push(result("total", steps));
+  return results;
+}
+
+// ---------------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------------
+
+function getGitHash(): string {
+  try {
+    return execSync("git rev-parse --short HEAD", { encoding: "utf-8" }).trim();
+  } catch {
+    return "unknown";
+  }
+}
+
+function generateMarkdown(tracePath: string, trace: CallTrace, backend: string, iterations: number, results: KindResult[]) {
+  const timestamp = new Date()
+    .toISOString()
+    .replace("T", " ")
+    .replace(/\.\d+Z$/, " UTC");
+  const runtime = typeof Bun !== "undefined" ? `Bun ${Bun.version}` : `Node ${process.version}`;
+
+  const lines: string[] = [];
+  lines.push("# Replay Benchmark Results");
+  lines.push("");
+  lines.push(`> Generated: ${timestamp}  `);
+  lines.push(`> Git: \`${getGitHash()}\`  `);
+  lines.push(`> Runtime: ${runtime}  `);
+  lines.push(`> Platform: ${process.platform} ${process.arch}  `);
+  lines.push(`> Trace: \`${tracePath}\` (${trace.records.length} calls, ${trace.shapes.length} shapes)  `);
+  lines.push(`> Backend: ${backend}, ${iterations} iteration(s)`);
+  lines.push("");
+  lines.push("| Kind | calls | total ms | overhead ms | calls/sec |");
+  lines.push("| :--- | ---: | ---: | ---: | ---: |");
+  for (const result of results) {
+    lines.push(
+      `| ${result.kind} | ${result.calls} | ${result.totalMs.toFixed(1)} | ${result.overheadMs.toFixed(1)} | ${Math.round(result.callsPerSec).toLocaleString("en-US")} |`
+    );
+  }
+  lines.push("");
+  lines.push("Overhead is the time of the sends that trigger replayed callbacks, measured on empty arrays and");
+  lines.push("subtracted from total ms.");
+  lines.push("");
+  lines.push("## Most frequent shapes");
+  lines.push("");
+  lines.push("| Kind | Call | Signature | Count |");
+  lines.push("| :--- | :--- | :--- | ---: |");
+  for (const { shape, count } of summarizeTrace(trace).slice(0, 20)) {
+    lines.push(`| ${shape.kind} | \`${shape.owner} ${shape.name}\` | \`${signatureOf(shape)}\` | ${count} |`);
+  }
+  lines.push("");
+  return lines.join("\n");
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+function option(name: string): string | undefined {
+  const index = process.argv.indexOf(`--${name}`);
+  return index >= 0 ? process.argv[index + 1] : undefined;
+}
+
+const tracePath = process.argv.slice(2).find((arg, i, args) => !arg.startsWith("--") && !args[i - 1]?.startsWith("--"));
+if (!tracePath) {
+  console.error("Usage: bun run benchmarks/replay.ts <trace> [--backend foundation|dry] [--iterations N]");
+  process.exit(1);
+}
+
+const trace = parseTrace(readFileSync(tracePath));
+const backendName = option("backend") ?? (process.platform === "darwin" ? "foundation" : "dry");
+const iterations = Number(option("iterations")) || 10;
+const backend =
+  backendName === "foundation"
+    ? await createFoundationBackend()
+    : backendName === "dry"
+      ? createDryBackend()
+      : (() => {
+          throw new Error(`Unknown backend "${backendName}" (expected foundation or dry)`);
+        })();
+
+console.log(
+  `Replaying ${trace.records.length} calls (${trace.shapes.length} shapes, ${trace.threadCount} threads` +
+    `${trace.droppedRecords > 0 ? `, ${trace.droppedRecords} dropped` : ""}) on the ${backend.name} backend`
+);
+const results = measure(buildSteps(trace, backend), iterations);
+
+console.log();
+for (const result of results) {
+  console.log(
+    `  ${result.kind.padEnd(20)} ${String(result.calls).padStart(10)} calls ${(result.totalMs.toFixed(1) + " ms").padStart(12)} ${Math.round(result.callsPerSec).toLocaleString("en-US").padStart(14)} calls/sec` +
+      (result.overheadMs > 0 ? `  (${result.overheadMs.toFixed(1)} ms send overhead subtracted)` : "")
+  );
+}
+console.log();
+
+const resultsPath = join(dirname(fileURLToPath(import.meta.url)), "REPLAY.md");
+writeFileSync(resultsPath, generateMarkdown(tracePath, trace, backend.name, iterations, results));
+console.log(`Results written to benchmarks/REPLAY.md`);
@@ -0,0 +1,158 @@
+/**
+ * Cold-start benchmark for nobjc.
+ *
+ * Time-to-first-call matters for short-lived CLI tools. Each run starts a
+ * fresh process and times, in order:
+ *   - runtime:       process start until the script's first line
+ *   - addon:         loading the native addon (dlopen + module init)
+ *   - module:        evaluating the TypeScript wrapper module
+ *   - classLookup:   loading Foundation and looking up the first class
+ *   - firstSend:     the first message send
+ *   - firstCallback: the first JS function called back as a block
+ *
+ * Results (median and p90 per phase over all runs) are written to
+ * benchmarks/STARTUP.md.
+ *
+ * Usage:
+ *   npm run bench:startup
+ *   bun run benchmarks/startup.ts [runs]
+ */
+
+import { writeFileSync } from "node:fs";
+import { join, dirname } from "node:path";
+import { fileURLToPath } from "node:url";
+import { execFileSync, execSync } from "node:child_process";
+
+const PHASES = ["runtime", "addon", "module", "classLookup", "firstSend", "firstCallback"] as const;
+type Phase = (typeof PHASES)[number];
+type Timings = Record<Phase, number>;
+
+const FOUNDATION = "/System/Library/Frameworks/Foundation.framework/Foundation";
+const DEFAULT_RUNS = 20;
+
+// ---------------------------------------------------------------------------
+// Child: one cold start
+// ---------------------------------------------------------------------------
+
+async function measureColdStart(): Promise<Timings> {
+  const timings = {} as Timings;
+  let last = performance.now();
+  timings.runtime = last;
+  const lap = (phase: Phase) => {
+    const now = performance.now();
+    timings[phase] = now - last;
+    last = now;
+  };
+
+  await import("../dist/native.js");
+  lap("addon");
+
+  const { NobjcLibrary } = await import("../dist/index.js");
+  lap("module");
+
+  const foundation = new NobjcLibrary(FOUNDATION);
+  const NSString = foundation["NSString"] as any;
+  lap("classLookup");
+
+  const str = NSString.stringWithUTF8String$("startup");
+  lap("firstSend");
+
+  // Setup for the callback phase is not part of it
+  const array = (foundation["NSMutableArray"] as any).array();
+  array.addObject$(str);
+  last = performance.now();
+
+  let calls = 0;
+  array.enumerateObjectsUsingBlock$(() => {
+    calls++;
+  });
+  lap("firstCallback");
+  if (calls !== 1) {
+    throw new Error(`Expected one callback, got ${calls}`);
+  }
+
+  return timings;
+}
+
+// ---------------------------------------------------------------------------
+// Parent: repeat in fresh processes and summarize
+// ---------------------------------------------------------------------------
+
+function percentile(sorted: number[], p: number): number {
+  const index = Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1);
+  return sorted[Math.max(0, index)];
+}
+
+function getGitHash(): string {
+  try {
+    return execSync("git rev-parse --short HEAD", { encoding: "utf-8" }).trim();
+  } catch {
+    return "unknown";
+  }
+}
+
+function runColdStarts(runs: number): Timings[] {
+  const script = fileURLToPath(import.meta.url);
+  const results: Timings[] = [];
+  for (let i = 0; i < runs; i++) {
+    const output = execFileSync(process.execPath, [script, "--child"], { encoding: "utf-8" });
+    results.push(JSON.parse(output.trim().split("\n").pop()!) as Timings);
+  }
+  return results;
+}
+
+function summarize(results: Timings[]) {
+  const rows = [...PHASES, "total"].map((phase) => {
+    const values = results
+      .map((t) => (phase === "total" ? PHASES.reduce((sum, p) => sum + t[p], 0) : t[phase as Phase]))
+      .sort((a, b) => a - b);
+    return { phase, median: percentile(values, 50), p90: percentile(values, 90) };
+  });
+  return rows;
+}
+
+function generateMarkdown(rows: ReturnType<typeof summarize>, runs: number): string {
+  const timestamp = new Date()
+    .toISOString()
+    .replace("T", " ")
+    .replace(/\.\d+Z$/, " UTC");
+  const runtime = typeof Bun !== "undefined" ? `Bun ${Bun.version}` : `Node ${process.version}`;
+
+  const lines: string[] = [];
+  lines.push("# Startup Benchmark Results");
+  lines.push("");
+  lines.push(`> Generated: ${timestamp}  `);
+  lines.push(`> Git: \`${getGitHash()}\`  `);
+  lines.push(`> Runtime: ${runtime}  `);
+  lines.push(`> Platform: ${process.platform} ${process.arch}  `);
+  lines.push(`> Runs: ${runs} (fresh process each)`);
+  lines.push("");
+  lines.push("| Phase | median ms | p90 ms |");
+  lines.push("| :--- | ---: | ---: |");
+  for (const row of rows) {
+    lines.push(`| ${row.phase} | ${row.median.toFixed(2)} | ${row.p90.toFixed(2)} |`);
+  }
+  lines.push("");
+  return lines.join("\n");
+}
+
+if (process.argv.includes("--child")) {
+  console.log(JSON.stringify(await measureColdStart()));
+} else {
+  const runs = Number(process.argv[2]) || DEFAULT_RUNS;
+  console.log(`Measuring ${runs} cold starts...`);
+  const rows = summarize(runColdStarts(runs));
+
+  console.log();
+  console.log(`  ${"Phase".padEnd(16)} ${"median".padStart(10)} ${"p90".padStart(10)}`);
+  for (const row of rows) {
+    console.log(
+      `  ${row.phase.padEnd(16)} ${(row.median.toFixed(2) + " ms").padStart(10)} ${(row.p90.toFixed(2) + " ms").padStart(10)}`
+    );
+  }
+  console.log();
+
+  const resultsPath = join(dirname(fileURLToPath(import.meta.url)), "STARTUP.md");
+  writeFileSync(resultsPath, generateMarkdown(rows, runs));
+  console.log(`Results written to benchmarks/STARTUP.md`);
+}
@@ -8,7 +8,20 @@
                 "src/native/protocol-impl.mm",
                 "src/native/method-forwarding.mm",
                 "src/native/subclass-impl.mm",
-                "src/native/forwarding-common.mm"
+                "src/native/forwarding-common.mm",
+                "src/native/kvo-observation.mm",
+                "src/native/notification-subscription.mm",
+                "src/native/stream-adapters.mm",
+                "src/native/parallel-send.mm",
+                "src/native/string-intern.mm",
+                "src/native/library-loader.mm",
+                "src/native/symbol-resolution.mm",
+                "src/native/bound-invocation.mm",
+                "src/native/weak-reference.mm",
+                "src/native/lazy-view.mm",
+                "src/native/callback-dispatcher.mm",
+                "src/native/call-profiler.mm",
+                "src/native/call-trace.mm"
             ],
             "defines": [
                 "NODE_ADDON_API_CPP_EXCEPTIONS",
@@ -1,6 +1,8 @@
 #ifndef OBJCOBJECT_H
 #define OBJCOBJECT_H
 
+#include <cstdint>
+#include <memory>
 #include <napi.h>
 #include <objc/objc.h>
 #include <objc/runtime.h>
@@ -37,6 +39,7 @@ struct PreparedSend {
   const char *returnType;     // simplified return type encoding (interned, lives in sig)
   bool isStructReturn;
   bool canUseFastPath;        // true if direct objc_msgSend cast is possible
+  bool canUseStructFastPath = false;  // small struct return/arg in registers
   char fastReturnTypeCode;    // first char of simplified return type, for fast dispatch
 
   // Per-argument info for fast path
@@ -47,20 +50,63 @@ struct PreparedSend {
   std::vector<ArgInfo> argInfos;
 };
 
+class NSStringInternCache;
+class ObjcObject;
+namespace nobjc {
+class CallbackDispatcher;
+}
+
+// MARK: - Borrow Scopes
+
+/**
+ * The wrappers created while one borrowScope is open. They hold their
+ * object without a retain; destroying the scope revokes every wrapper
+ * still registered (clears its object and makes further use throw).
+ * Wrappers that are finalized or promoted with $retain() earlier remove
+ * themselves in O(1) using their stored index.
+ */
+struct BorrowScope {
+  std::vector<ObjcObject *> wrappers;
+  void Add(ObjcObject *wrapper);
+  void Remove(ObjcObject *wrapper);
+  ~BorrowScope();
+};
+
 struct NobjcEnvData {
   Napi::FunctionReference objcObjectConstructor;
+  // Opt-in JS string -> NSString cache for `@` arguments (null = disabled).
+  std::shared_ptr<NSStringInternCache> stringInternCache;
+  // Open borrowScope frames, innermost last. Wrappers created while any is
+  // open are borrowed by the innermost one.
+  std::vector<std::unique_ptr<BorrowScope>> borrowScopes;
+  // Prioritized native -> JS delivery queue (created on first use).
+  std::shared_ptr<nobjc::CallbackDispatcher> callbackDispatcher;
 };
 
+/**
+ * How NewInstance wraps an object. Borrowable wrappers are borrowed by the
+ * innermost open borrowScope; only send results and converted return values
+ * use it. Retained wrappers always take their own retain, for callers that
+ * give up their reference right after wrapping.
+ */
+enum class WrapMode : uint8_t { Borrowable, Retained };
+
 class ObjcObject : public Napi::ObjectWrap<ObjcObject> {
 public:
   __strong id objcObject;
+  // Non-null while this wrapper is borrowed (holds objcObject unretained).
+  BorrowScope *borrowScope = nullptr;
+  size_t borrowIndex = 0;
+  // Set when the owning borrowScope closed before the wrapper was retained.
+  bool revoked = false;
   static void Init(Napi::Env env, Napi::Object exports);
   static NobjcEnvData *GetEnvData(Napi::Env env);
   static Napi::FunctionReference &GetConstructorRef(Napi::Env env);
   static bool IsInstance(Napi::Env env, const Napi::Value &value);
   ObjcObject(const Napi::CallbackInfo &info)
       : Napi::ObjectWrap<ObjcObject>(info), objcObject(nil) {
-    if (info.Length() == 1 && info[0].IsExternal()) {
+    // (External<id>[, retained: boolean]); see WrapMode.
+    if ((info.Length() == 1 || info.Length() == 2) && info[0].IsExternal()) {
       // This better be an Napi::External<id>! We lost the type info at runtime.
       Napi::External<id> external = info[0].As<Napi::External<id>>();
       objcObject = *(external.Data());
@@ -71,15 +117,46 @@ public:
       // Note: ARC is not enabled for .mm files in this project (the -fobjc-arc
       // flag is in OTHER_CFLAGS, not OTHER_CPLUSPLUSFLAGS), so __strong has
       // no effect — we must manage retain/release manually.
-      if (objcObject) objc_retain(objcObject);
+      // Inside a borrowScope the wrapper borrows the object instead; the
+      // scope revokes it on exit unless it is promoted with $retain().
+      if (objcObject) {
+        const bool retained = info.Length() == 2 && info[1].ToBoolean();
+        NobjcEnvData *data = info.Env().GetInstanceData<NobjcEnvData>();
+        if (!retained && data != nullptr && !data->borrowScopes.empty()) {
+          data->borrowScopes.back()->Add(this);
+        } else {
+          objc_retain(objcObject);
+        }
+      }
       return;
     }
     // If someone tries `new ObjcObject()` from JS, forbid it:
     Napi::TypeError::New(info.Env(), "Cannot construct directly")
         .ThrowAsJavaScriptException();
   }
-  static Napi::Object NewInstance(Napi::Env env, id obj);
+  static Napi::Object NewInstance(Napi::Env env, id obj,
+                                  WrapMode mode = WrapMode::Borrowable);
+  // Throw if this wrapper was borrowed by a borrowScope that has closed.
+  void ThrowIfRevoked(Napi::Env env) const {
+    if (revoked) {
+      throw Napi::Error::New(
+          env, "Object was borrowed inside a borrowScope that has exited. "
+               "Call $retain() on it inside the scope to keep using it.");
+    }
+  }
+  // The object behind `value`, which must be an ObjcObject instance. Throws
+  // for a revoked wrapper, so it is never mistaken for nil.
+  static id UnwrapObject(Napi::Env env, const Napi::Value &value) {
+    ObjcObject *wrapper = Unwrap(value.As<Napi::Object>());
+    wrapper->ThrowIfRevoked(env);
+    return wrapper->objcObject;
+  }
   ~ObjcObject() {
+    if (borrowScope != nullptr) {
+      borrowScope->Remove(this);
+      objcObject = nil;
+      return;
+    }
     if (objcObject) {
       objc_release(objcObject);
       objcObject = nil;
@@ -91,6 +168,8 @@ private:
   Napi::Value $RespondsToSelector(const Napi::CallbackInfo &info);
   Napi::Value $PrepareSend(const Napi::CallbackInfo &info);
   Napi::Value $MsgSendPrepared(const Napi::CallbackInfo &info);
+  Napi::Value $ToString(const Napi::CallbackInfo &info);
+  Napi::Value $Retain(const Napi::CallbackInfo &info);
   Napi::Value GetPointer(const Napi::CallbackInfo &info);
 };
 
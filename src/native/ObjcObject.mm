@@ -1,12 +1,20 @@
 #include "ObjcObject.h"
 #include "bridge.h"
+#include "call-profiler.h"
+#include "call-trace.h"
+#include "callback-dispatcher.h"
+#include "fast-msgsend.h"
 #include "pointer-utils.h"
+#include "string-utils.h"
+#include "struct-registers.h"
 #include "struct-utils.h"
 #include "nobjc_block.h"
 #include <Foundation/Foundation.h>
 #include <napi.h>
 #include <objc/objc.h>
 #include <objc/message.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string_view>
 #include <unordered_map>
@@ -14,117 +22,6 @@
 
 // MARK: - Fast Path: Direct objc_msgSend (H1)
 
-/**
- * Check if a type code is eligible for the direct objc_msgSend fast path.
- * All pointer-sized or smaller integer types, float, double, id, class, SEL,
- * bool, and void are eligible. Structs, C strings, and pointers are not
- * (structs need special handling, C strings need lifetime management).
- */
-static inline bool IsFastPathTypeCode(char typeCode) {
-  switch (typeCode) {
-    // Integer types (all fit in a register)
-    case 'c': case 'i': case 's': case 'l': case 'q':
-    case 'C': case 'I': case 'S': case 'L': case 'Q':
-    // Floating point
-    case 'f': case 'd':
-    // Bool
-    case 'B':
-    // Object types (pointer-sized)
-    case '@': case '#': case ':':
-    // Void (for return type only)
-    case 'v':
-      return true;
-    default:
-      return false;
-  }
-}
-
-/**
- * Check if a type code is eligible as a fast-path argument.
- * Slightly more restrictive than return types — excludes void.
- */
-static inline bool IsFastPathArgTypeCode(char typeCode) {
-  return typeCode != 'v' && IsFastPathTypeCode(typeCode);
-}
-
-/**
- * Convert a JS value to a register-sized integer for passing to objc_msgSend.
- * Handles id (@), Class (#), SEL (:), bool (B), and all integer types.
- * Returns the value as a uintptr_t that can be passed in a general register.
- */
-static inline uintptr_t JSValueToRegister(Napi::Env env,
-                                          const Napi::Value &value,
-                                          char typeCode,
-                                          const ObjcArgumentContext &context) {
-  switch (typeCode) {
-    case '@': {
-      id obj = ConvertToNativeValue<id>(value, context);
-      return reinterpret_cast<uintptr_t>(obj);
-    }
-    case '#': {
-      // Class is also an id
-      id obj = ConvertToNativeValue<id>(value, context);
-      return reinterpret_cast<uintptr_t>(obj);
-    }
-    case ':': {
-      SEL sel = ConvertToNativeValue<SEL>(value, context);
-      return reinterpret_cast<uintptr_t>(sel);
-    }
-    case 'B': {
-      bool b = ConvertToNativeValue<bool>(value, context);
-      return static_cast<uintptr_t>(b ? 1 : 0);
-    }
-    case 'c': return static_cast<uintptr_t>(
-                   static_cast<unsigned char>(ConvertToNativeValue<char>(value, context)));
-    case 'i': return static_cast<uintptr_t>(
-                   static_cast<unsigned int>(ConvertToNativeValue<int>(value, context)));
-    case 's': return static_cast<uintptr_t>(
-                   static_cast<unsigned short>(ConvertToNativeValue<short>(value, context)));
-    case 'l': return static_cast<uintptr_t>(
-                   static_cast<unsigned long>(ConvertToNativeValue<long>(value, context)));
-    case 'q': return static_cast<uintptr_t>(ConvertToNativeValue<long long>(value, context));
-    case 'C': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned char>(value, context));
-    case 'I': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned int>(value, context));
-    case 'S': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned short>(value, context));
-    case 'L': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned long>(value, context));
-    case 'Q': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned long long>(value, context));
-    default:
-      throw Napi::TypeError::New(env, "Unsupported fast-path argument type");
-  }
-}
-
-/**
- * Convert a raw objc_msgSend integer return value to a JS value.
- */
-static inline Napi::Value RegisterToJSValue(Napi::Env env, uintptr_t raw,
-                                            char typeCode) {
-  switch (typeCode) {
-    case 'v': return env.Undefined();
-    case '@': case '#': {
-      id obj = reinterpret_cast<id>(raw);
-      if (obj == nil) return env.Null();
-      return ObjcObject::NewInstance(env, obj);
-    }
-    case ':': {
-      SEL sel = reinterpret_cast<SEL>(raw);
-      if (sel == nullptr) return env.Null();
-      return Napi::String::New(env, sel_getName(sel));
-    }
-    case 'B': return Napi::Boolean::New(env, raw != 0);
-    case 'c': return Napi::Number::New(env, static_cast<double>(static_cast<char>(raw)));
-    case 'i': return Napi::Number::New(env, static_cast<double>(static_cast<int>(raw)));
-    case 's': return Napi::Number::New(env, static_cast<double>(static_cast<short>(raw)));
-    case 'l': return Napi::Number::New(env, static_cast<double>(static_cast<long>(raw)));
-    case 'q': return Napi::Number::New(env, static_cast<double>(static_cast<long long>(raw)));
-    case 'C': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned char>(raw)));
-    case 'I': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned int>(raw)));
-    case 'S': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned short>(raw)));
-    case 'L': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned long>(raw)));
-    case 'Q': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned long long>(raw)));
-    default:  return env.Undefined();
-  }
-}
-
 /**
  * Attempt direct objc_msgSend fast path for 0-3 non-float args.
  * Returns true and sets result if handled; false to fall through to NSInvocation.
@@ -186,71 +83,9 @@ static bool TryFastMsgSend(Napi::Env env, id target, SEL selector,
       argCtx.argumentIndex = static_cast<int>(i);
       args[i] = JSValueToRegister(env, info[i + 1], argTypeCodes[i], argCtx);
     }
-
-    if (returnTypeCode == 'f') {
-      // Float return
-      float result;
-      switch (expectedArgCount) {
-        case 0:
-          result = ((float(*)(id, SEL))objc_msgSend)(target, selector);
-          break;
-        case 1:
-          result = ((float(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
-          break;
-        case 2:
-          result = ((float(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1]);
-          break;
-        case 3:
-          result = ((float(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1], args[2]);
-          break;
-      }
-      outResult = Napi::Number::New(env, static_cast<double>(result));
-      return true;
-    } else if (returnTypeCode == 'd') {
-      // Double return
-      double result;
-      switch (expectedArgCount) {
-        case 0:
-          result = ((double(*)(id, SEL))objc_msgSend)(target, selector);
-          break;
-        case 1:
-          result = ((double(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
-          break;
-        case 2:
-          result = ((double(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1]);
-          break;
-        case 3:
-          result = ((double(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1], args[2]);
-          break;
-      }
-      outResult = Napi::Number::New(env, result);
-      return true;
-    } else {
-      // Integer/pointer/void return
-      uintptr_t result;
-      switch (expectedArgCount) {
-        case 0:
-          result = ((uintptr_t(*)(id, SEL))objc_msgSend)(target, selector);
-          break;
-        case 1:
-          result = ((uintptr_t(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
-          break;
-        case 2:
-          result = ((uintptr_t(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1]);
-          break;
-        case 3:
-          result = ((uintptr_t(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
-              target, selector, args[0], args[1], args[2]);
-          break;
-      }
-      outResult = RegisterToJSValue(env, result, returnTypeCode);
-      return true;
-    }
+    outResult = MsgSendRegisters(env, target, selector, args, expectedArgCount,
+                                 returnTypeCode);
+    return true;
   }
 
   // For float/double arguments, we need exact ABI-correct casts.
@@ -258,34 +93,18 @@ static bool TryFastMsgSend(Napi::Env env, id target, SEL selector,
   if (expectedArgCount == 1 && argTypeCodes[0] == 'd') {
     ObjcArgumentContext argCtx = context;
     argCtx.argumentIndex = 0;
-    double arg0 = ConvertToNativeValue<double>(info[1], argCtx);
-    if (returnTypeCode == 'd') {
-      double result = ((double(*)(id, SEL, double))objc_msgSend)(target, selector, arg0);
-      outResult = Napi::Number::New(env, result);
-    } else if (returnTypeCode == 'f') {
-      float result = ((float(*)(id, SEL, double))objc_msgSend)(target, selector, arg0);
-      outResult = Napi::Number::New(env, static_cast<double>(result));
-    } else {
-      uintptr_t result = ((uintptr_t(*)(id, SEL, double))objc_msgSend)(target, selector, arg0);
-      outResult = RegisterToJSValue(env, result, returnTypeCode);
-    }
+    outResult = MsgSendFloatArgument(
+        env, target, selector, ConvertToNativeValue<double>(info[1], argCtx),
+        returnTypeCode);
     return true;
   }
 
   if (expectedArgCount == 1 && argTypeCodes[0] == 'f') {
     ObjcArgumentContext argCtx = context;
     argCtx.argumentIndex = 0;
-    float arg0 = ConvertToNativeValue<float>(info[1], argCtx);
-    if (returnTypeCode == 'd') {
-      double result = ((double(*)(id, SEL, float))objc_msgSend)(target, selector, arg0);
-      outResult = Napi::Number::New(env, result);
-    } else if (returnTypeCode == 'f') {
-      float result = ((float(*)(id, SEL, float))objc_msgSend)(target, selector, arg0);
-      outResult = Napi::Number::New(env, static_cast<double>(result));
-    } else {
-      uintptr_t result = ((uintptr_t(*)(id, SEL, float))objc_msgSend)(target, selector, arg0);
-      outResult = RegisterToJSValue(env, result, returnTypeCode);
-    }
+    outResult = MsgSendFloatArgument(
+        env, target, selector, ConvertToNativeValue<float>(info[1], argCtx),
+        returnTypeCode);
     return true;
   }
 
@@ -293,6 +112,102 @@ static bool TryFastMsgSend(Napi::Env env, id target, SEL selector,
   return false;
 }
 
+// MARK: - Fast Path: Register-Passed Structs
+
+/**
+ * Direct objc_msgSend for the common small-struct signatures:
+ *
+ * - a register struct return with 0-2 integer-register args
+ *   (frame, bounds, rangeOfString:, rangeOfString:options:)
+ * - a register struct as the only arg, or followed by one integer-register
+ *   arg, with a fast-path scalar or void return
+ *   (setFrame:, valueWithRange:, substringWithRange:, setFrame:display:)
+ *
+ * Struct values go through the PackJSValueAsStruct / UnpackStructToJSValue
+ * fast paths. Returns false to fall through to NSInvocation.
+ */
+static bool TryFastStructMsgSend(Napi::Env env, id target, SEL selector,
+                                 const Napi::CallbackInfo &info,
+                                 NSMethodSignature *methodSignature,
+                                 const char *returnType, size_t expectedArgCount,
+                                 const char *classNameCStr,
+                                 std::string_view selectorView,
+                                 Napi::Value &outResult) {
+  if (expectedArgCount > 2) return false;
+
+  const char *argTypes[2];
+  for (size_t i = 0; i < expectedArgCount; i++) {
+    argTypes[i] = SimplifyTypeEncoding([methodSignature getArgumentTypeAtIndex:i + 2]);
+  }
+  const ObjcArgumentContext context = {
+    .className = classNameCStr,
+    .selectorName = selectorView,
+    .argumentIndex = 0,
+  };
+
+  if (*returnType == '{') {
+    const RegisterStructClass returnClass = ClassifyRegisterStruct(returnType);
+    if (returnClass.kind == RegisterStructKind::None) return false;
+    uintptr_t args[2];
+    for (size_t i = 0; i < expectedArgCount; i++) {
+      if (!IsIntegerRegisterTypeCode(*argTypes[i]) ||
+          (*argTypes[i] == '@' && argTypes[i][1] == '?')) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < expectedArgCount; i++) {
+      ObjcArgumentContext argCtx = context;
+      argCtx.argumentIndex = static_cast<int>(i);
+      args[i] = JSValueToRegister(env, info[i + 1], *argTypes[i], argCtx);
+    }
+    alignas(16) uint8_t buffer[32];
+    DispatchRegisterShape(returnClass, [&](auto shape) {
+      using Shape = typename decltype(shape)::type;
+      MsgSendStructReturn<Shape>(target, selector, args, expectedArgCount, buffer);
+    });
+    outResult = UnpackStructToJSValue(env, buffer, returnType);
+    return true;
+  }
+
+  if (expectedArgCount == 0 || *argTypes[0] != '{') return false;
+  const char returnTypeCode = *returnType;
+  if (!IsFastPathTypeCode(returnTypeCode)) return false;
+  const RegisterStructClass argClass = ClassifyRegisterStruct(argTypes[0]);
+  if (argClass.kind == RegisterStructKind::None) return false;
+  const bool hasArg1 = expectedArgCount == 2;
+  if (hasArg1 && (!IsIntegerRegisterTypeCode(*argTypes[1]) ||
+                  (*argTypes[1] == '@' && argTypes[1][1] == '?'))) {
+    return false;
+  }
+
+  std::vector<uint8_t> packed = PackJSValueAsStruct(env, info[1], argTypes[0]);
+  uintptr_t arg1 = 0;
+  if (hasArg1) {
+    ObjcArgumentContext argCtx = context;
+    argCtx.argumentIndex = 1;
+    arg1 = JSValueToRegister(env, info[2], *argTypes[1], argCtx);
+  }
+
+  outResult = DispatchRegisterShape(argClass, [&](auto shape) -> Napi::Value {
+    using Shape = typename decltype(shape)::type;
+    Shape arg0{};
+    memcpy(&arg0, packed.data(), std::min(packed.size(), sizeof(Shape)));
+    if (returnTypeCode == 'd') {
+      return Napi::Number::New(env, MsgSendStructArgument<Shape, double>(
+                                        target, selector, arg0, hasArg1, arg1));
+    }
+    if (returnTypeCode == 'f') {
+      return Napi::Number::New(env, static_cast<double>(MsgSendStructArgument<Shape, float>(
+                                        target, selector, arg0, hasArg1, arg1)));
+    }
+    return RegisterToJSValue(env,
+                             MsgSendStructArgument<Shape, uintptr_t>(
+                                 target, selector, arg0, hasArg1, arg1),
+                             returnTypeCode);
+  });
+  return true;
+}
+
 // MARK: - Method Signature Cache
 
 /**
@@ -308,8 +223,15 @@ struct ClassSELHash {
   }
 };
 
-static std::unordered_map<std::pair<Class, SEL>, NSMethodSignature *, ClassSELHash>
-    methodSignatureCache;
+using MethodSignatureCache =
+    std::unordered_map<std::pair<Class, SEL>, NSMethodSignature *, ClassSELHash>;
+
+// Built on first send rather than at load, so loading the addon runs no
+// static initializers.
+static MethodSignatureCache &GetMethodSignatureCache() {
+  static MethodSignatureCache cache;
+  return cache;
+}
 
 NobjcEnvData *ObjcObject::GetEnvData(Napi::Env env) {
   NobjcEnvData *data = env.GetInstanceData<NobjcEnvData>();
@@ -338,23 +260,31 @@ void ObjcObject::Init(Napi::Env env, Napi::Object exports) {
                       InstanceMethod("$respondsToSelector", &ObjcObject::$RespondsToSelector),
                       InstanceMethod("$prepareSend", &ObjcObject::$PrepareSend),
                       InstanceMethod("$msgSendPrepared", &ObjcObject::$MsgSendPrepared),
+                      InstanceMethod("$toString", &ObjcObject::$ToString),
                       InstanceMethod("$getPointer", &ObjcObject::GetPointer),
+                      InstanceMethod("$retain", &ObjcObject::$Retain),
                   });
   GetConstructorRef(env) = Napi::Persistent(func);
   exports.Set("ObjcObject", func);
 }
 
-Napi::Object ObjcObject::NewInstance(Napi::Env env, id obj) {
+Napi::Object ObjcObject::NewInstance(Napi::Env env, id obj, WrapMode mode) {
   Napi::EscapableHandleScope scope(env);
   // `obj` is already a pointer, technically, but the Napi::External
   //  API expects a pointer, so we have to pointer to the pointer.
   Napi::Object jsObj =
-      GetConstructorRef(env).New({Napi::External<id>::New(env, &obj)});
+      mode == WrapMode::Retained
+          ? GetConstructorRef(env).New({Napi::External<id>::New(env, &obj),
+                                        Napi::Boolean::New(env, true)})
+          : GetConstructorRef(env).New({Napi::External<id>::New(env, &obj)});
   return scope.Escape(jsObj).ToObject();
 }
 
 Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
+  // Lets threads this send waits on call back into JS (see CallbackDispatcher)
+  nobjc::NativeCallScope nativeCall(env);
 
   if (info.Length() < 1 || !info[0].IsString()) {
     Napi::TypeError::New(env, "Expected at least one string argument")
@@ -383,9 +313,11 @@ Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
         .ThrowAsJavaScriptException();
     return env.Null();
   }
+  nobjc::ProfiledCall profiled(objcObject, selector);
 
   // Use cached method signature to avoid redundant ObjC runtime calls
   auto cacheKey = std::make_pair(object_getClass(objcObject), selector);
+  MethodSignatureCache &methodSignatureCache = GetMethodSignatureCache();
   auto cacheIt = methodSignatureCache.find(cacheKey);
   NSMethodSignature *methodSignature;
   if (cacheIt != methodSignatureCache.end()) {
@@ -401,6 +333,8 @@ Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
         .ThrowAsJavaScriptException();
     return env.Null();
   }
+  nobjc::TraceMethodCall(nobjc::TraceKind::Send, cacheKey.first, selector,
+                         [&] { return methodSignature; });
 
   // The first two arguments of the signature are the target and selector.
   const size_t expectedArgCount = [methodSignature numberOfArguments] - 2;
@@ -436,16 +370,23 @@ Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
   }
 
   // Fast path: direct objc_msgSend for simple signatures (H1)
-  // Skip NSInvocation overhead for 0-3 simple args with simple return types.
-  if (!isStructReturn) {
+  // Skip NSInvocation overhead for 0-3 simple args with simple return types,
+  // and for small structs that travel in registers.
+  {
     const char* classNameCStr = object_getClassName(objcObject);
     std::string_view selectorView(selectorCStr);
     Napi::Value fastResult;
-    if (TryFastMsgSend(env, objcObject, selector, info, methodSignature,
+    if (!isStructReturn &&
+        TryFastMsgSend(env, objcObject, selector, info, methodSignature,
                        returnType, expectedArgCount, classNameCStr, selectorView,
                        fastResult)) {
       return fastResult;
     }
+    if (TryFastStructMsgSend(env, objcObject, selector, info, methodSignature,
+                             returnType, expectedArgCount, classNameCStr,
+                             selectorView, fastResult)) {
+      return fastResult;
+    }
   }
 
   NSInvocation *invocation =
@@ -510,11 +451,11 @@ Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
       // Get extended encoding from method_getTypeEncoding() which preserves @?<...>
       // NSMethodSignature strips the extended encoding, so we use the runtime directly.
       // Argument index in NSInvocation is i+1 (0=self, 1=_cmd, 2+=user args)
-      std::string extEncoding = GetExtendedBlockEncoding(
+      const char *extEncoding = CachedExtendedBlockEncoding(
           object_getClass(objcObject), selector, i + 1);
-      const char *blockEncoding = extEncoding.empty()
+      const char *blockEncoding = extEncoding == nullptr
           ? [methodSignature getArgumentTypeAtIndex:i + 1]
-          : extEncoding.c_str();
+          : extEncoding;
       id block = CreateBlockFromJSFunction(env, info[i], blockEncoding);
       if (env.IsExceptionPending()) return env.Null();
       [invocation setArgument:&block atIndex:i + 1];
@@ -571,13 +512,79 @@ Napi::Value ObjcObject::$MsgSend(const Napi::CallbackInfo &info) {
 
 Napi::Value ObjcObject::GetPointer(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
   return PointerToBuffer(env, objcObject);
 }
 
+// MARK: - Borrow Scopes
+
+void BorrowScope::Add(ObjcObject *wrapper) {
+  wrapper->borrowScope = this;
+  wrapper->borrowIndex = wrappers.size();
+  wrappers.push_back(wrapper);
+}
+
+void BorrowScope::Remove(ObjcObject *wrapper) {
+  ObjcObject *last = wrappers.back();
+  wrappers[wrapper->borrowIndex] = last;
+  last->borrowIndex = wrapper->borrowIndex;
+  wrappers.pop_back();
+  wrapper->borrowScope = nullptr;
+}
+
+BorrowScope::~BorrowScope() {
+  for (ObjcObject *wrapper : wrappers) {
+    wrapper->objcObject = nil;
+    wrapper->borrowScope = nullptr;
+    wrapper->revoked = true;
+  }
+}
+
+/**
+ * $retain() -> this
+ *
+ * Promote a borrowed wrapper to an ordinary retained one so it can outlive
+ * its borrowScope. A no-op for wrappers that are already retained.
+ */
+Napi::Value ObjcObject::$Retain(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
+  if (borrowScope != nullptr) {
+    objc_retain(objcObject);
+    borrowScope->Remove(this);
+  }
+  return info.This();
+}
+
+// MARK: - $ToString (single crossing for toString / inspect)
+
+/**
+ * $toString() -> string
+ *
+ * NSString receivers are converted directly; anything else is converted via
+ * -description. Replaces the JS-side description send + wrapper + UTF8String
+ * send with one crossing and no intermediate wrapper. The pool drains the
+ * autoreleased description before returning.
+ */
+Napi::Value ObjcObject::$ToString(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
+  @autoreleasepool {
+    NSString *string = [objcObject isKindOfClass:[NSString class]]
+                           ? (NSString *)objcObject
+                           : [objcObject description];
+    if (string == nil) {
+      return CStringToJS(env, "(null)");
+    }
+    return NSStringToJS(env, string);
+  }
+}
+
 // MARK: - $RespondsToSelector (H4: avoid double FFI round-trip)
 
 Napi::Value ObjcObject::$RespondsToSelector(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
 
   if (info.Length() < 1 || !info[0].IsString()) {
     Napi::TypeError::New(env, "$respondsToSelector requires a string argument")
@@ -616,6 +623,7 @@ Napi::Value ObjcObject::$RespondsToSelector(const Napi::CallbackInfo &info) {
  */
 Napi::Value ObjcObject::$PrepareSend(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
 
   if (info.Length() < 1 || !info[0].IsString()) {
     Napi::TypeError::New(env, "$prepareSend requires a string argument")
@@ -648,6 +656,7 @@ Napi::Value ObjcObject::$PrepareSend(const Napi::CallbackInfo &info) {
 
   // Look up or cache method signature
   auto cacheKey = std::make_pair(object_getClass(objcObject), selector);
+  MethodSignatureCache &methodSignatureCache = GetMethodSignatureCache();
   auto cacheIt = methodSignatureCache.find(cacheKey);
   NSMethodSignature *methodSignature;
   if (cacheIt != methodSignatureCache.end()) {
@@ -703,6 +712,20 @@ Napi::Value ObjcObject::$PrepareSend(const Napi::CallbackInfo &info) {
 
   prepared->canUseFastPath = canFast;
 
+  // Register-passed struct eligibility: a small struct return with integer
+  // args, or a small struct first argument (see TryFastStructMsgSend).
+  if (!canFast && prepared->expectedArgCount <= 2) {
+    if (prepared->isStructReturn) {
+      prepared->canUseStructFastPath =
+          ClassifyRegisterStruct(returnType).kind != RegisterStructKind::None;
+    } else if (prepared->expectedArgCount >= 1 && prepared->argInfos[0].isStruct) {
+      prepared->canUseStructFastPath =
+          ClassifyRegisterStruct(SimplifyTypeEncoding(
+              [methodSignature getArgumentTypeAtIndex:2])).kind !=
+          RegisterStructKind::None;
+    }
+  }
+
   // Return as External with destructor
   return Napi::External<PreparedSend>::New(env, prepared,
       [](Napi::Env, PreparedSend *p) { delete p; });
@@ -717,6 +740,8 @@ Napi::Value ObjcObject::$PrepareSend(const Napi::CallbackInfo &info) {
  */
 Napi::Value ObjcObject::$MsgSendPrepared(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
+  ThrowIfRevoked(env);
+  nobjc::NativeCallScope nativeCall(env);
 
   if (info.Length() < 1 || !info[0].IsExternal()) {
     Napi::TypeError::New(env, "$msgSendPrepared requires a PreparedSend handle as first argument")
@@ -739,6 +764,10 @@ Napi::Value ObjcObject::$MsgSendPrepared(const Napi::CallbackInfo &info) {
     Napi::Error::New(env, errorMsg).ThrowAsJavaScriptException();
     return env.Null();
   }
+  nobjc::ProfiledCall profiled(objcObject, prepared->selector);
+  nobjc::TraceMethodCall(nobjc::TraceKind::Send, object_getClass(objcObject),
+                         prepared->selector,
+                         [&] { return prepared->methodSignature; });
 
   // Fast path: direct objc_msgSend
   if (prepared->canUseFastPath) {
@@ -753,6 +782,19 @@ Napi::Value ObjcObject::$MsgSendPrepared(const Napi::CallbackInfo &info) {
     }
   }
 
+  // Fast path: register-passed structs
+  if (prepared->canUseStructFastPath) {
+    const char *classNameCStr = object_getClassName(objcObject);
+    std::string_view selectorView(sel_getName(prepared->selector));
+    Napi::Value fastResult;
+    if (TryFastStructMsgSend(env, objcObject, prepared->selector, info,
+                             prepared->methodSignature, prepared->returnType,
+                             prepared->expectedArgCount, classNameCStr,
+                             selectorView, fastResult)) {
+      return fastResult;
+    }
+  }
+
   // Slow path: NSInvocation
   NSInvocation *invocation =
       [NSInvocation invocationWithMethodSignature:prepared->methodSignature];
@@ -807,11 +849,11 @@ Napi::Value ObjcObject::$MsgSendPrepared(const Napi::CallbackInfo &info) {
     if (IsBlockTypeEncoding(typeEncoding) && info[jsArgIdx].IsFunction()) {
       // Get extended encoding from method_getTypeEncoding() which preserves @?<...>
       // Argument index in NSInvocation is i+2 (0=self, 1=_cmd, 2+=user args)
-      std::string extEncoding = GetExtendedBlockEncoding(
+      const char *extEncoding = CachedExtendedBlockEncoding(
           object_getClass(objcObject), prepared->selector, i + 2);
-      const char *blockEncoding = extEncoding.empty()
+      const char *blockEncoding = extEncoding == nullptr
           ? [prepared->methodSignature getArgumentTypeAtIndex:i + 2]
-          : extEncoding.c_str();
+          : extEncoding;
       id block = CreateBlockFromJSFunction(env, info[jsArgIdx], blockEncoding);
       if (env.IsExceptionPending()) return env.Null();
       [invocation setArgument:&block atIndex:i + 2];
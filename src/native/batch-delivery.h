@@ -0,0 +1,181 @@
+#ifndef BATCH_DELIVERY_H
+#define BATCH_DELIVERY_H
+
+#include "callback-dispatcher.h"
+#include "debug.h"
+#include <dispatch/dispatch.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <vector>
+
+// MARK: - Batched Native -> JS Delivery
+
+/**
+ * Collects records produced on arbitrary threads and hands them to a JS
+ * callback in batches.
+ *
+ * Producers never block: Enqueue() appends under a short lock and, if no
+ * flush is pending yet, schedules one (immediately, or after the coalescing
+ * delay). A burst of N records therefore costs one thread hop and one JS call
+ * instead of N blocking round-trips through ForwardInvocationCommon.
+ *
+ * Records are plain native structs; `toJS` runs on the JS thread during the
+ * flush and `dispose` releases whatever a record still owns (for records that
+ * were merged, dropped after Stop(), or already converted).
+ *
+ * Flushes go through the env's CallbackDispatcher on the callback's lane
+ * (Interactive unless the callback was tagged with withPriority()), and the
+ * delivery counts as a dispatcher client until Stop() so the event loop
+ * stays alive while it is active.
+ */
+template <typename Record> class BatchDelivery
+    : public std::enable_shared_from_this<BatchDelivery<Record>> {
+public:
+  using ToJS = std::function<Napi::Value(Napi::Env, Record &)>;
+  using Dispose = std::function<void(Record &)>;
+
+  /// JS thread only.
+  static std::shared_ptr<BatchDelivery>
+  Create(Napi::Env env, const Napi::Function &callback, uint32_t delayMs,
+         ToJS toJS, Dispose dispose) {
+    std::shared_ptr<BatchDelivery> delivery(new BatchDelivery());
+    delivery->env_ = env;
+    delivery->delayMs_ = delayMs;
+    delivery->toJS_ = std::move(toJS);
+    delivery->dispose_ = std::move(dispose);
+    delivery->callback_ = Napi::Persistent(callback);
+    delivery->lane_ = nobjc::CallbackLaneForFunction(
+        callback, nobjc::CallbackLane::Interactive);
+    delivery->dispatcher_ = nobjc::CallbackDispatcher::ForEnv(env);
+    delivery->dispatcher_->AddClient(env);
+    return delivery;
+  }
+
+  ~BatchDelivery() {
+    for (auto &record : pending_) {
+      dispose_(record);
+    }
+  }
+
+  /**
+   * Append a record. `merge(last, incoming)` is called under the lock with the
+   * most recent pending record and returns true if it absorbed `incoming`
+   * (which is then disposed). Safe to call from any thread.
+   */
+  template <typename MergeFn> void Enqueue(Record &&record, MergeFn &&merge) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_) {
+        dispose_(record);
+        return;
+      }
+      if (!pending_.empty() && merge(pending_.back(), record)) {
+        dispose_(record);
+        return;
+      }
+      pending_.push_back(std::move(record));
+      if (flushScheduled_) {
+        return;
+      }
+      flushScheduled_ = true;
+    }
+    ScheduleFlush();
+  }
+
+  void Enqueue(Record &&record) {
+    Enqueue(std::move(record), [](Record &, Record &) { return false; });
+  }
+
+  /**
+   * Stop delivery and drop anything still pending. Idempotent; after this
+   * returns no further JS calls are made. JS thread only.
+   */
+  void Stop() {
+    std::vector<Record> dropped;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_) {
+        return;
+      }
+      stopped_ = true;
+      dropped.swap(pending_);
+    }
+    for (auto &record : dropped) {
+      dispose_(record);
+    }
+    callback_.Reset();
+    dispatcher_->RemoveClient(Napi::Env(env_));
+  }
+
+  uint32_t delayMs() const { return delayMs_; }
+
+private:
+  BatchDelivery() = default;
+
+  // Called without mutex_ held: the dispatcher may run the flush inline
+  // (with a null env) if the env is already gone.
+  void ScheduleFlush() {
+    if (delayMs_ == 0) {
+      PostFlush();
+      return;
+    }
+    std::shared_ptr<BatchDelivery> self = this->shared_from_this();
+    dispatch_after(
+        dispatch_time(DISPATCH_TIME_NOW, (int64_t)delayMs_ * NSEC_PER_MSEC),
+        dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+          self->PostFlush();
+        });
+  }
+
+  void PostFlush() {
+    std::shared_ptr<BatchDelivery> self = this->shared_from_this();
+    dispatcher_->Post(lane_, [self](Napi::Env env) { Flush(env, self); });
+  }
+
+  // Runs on the JS thread, or with a null env during teardown.
+  static void Flush(Napi::Env env, const std::shared_ptr<BatchDelivery> &self) {
+    std::vector<Record> batch;
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      self->flushScheduled_ = false;
+      batch.swap(self->pending_);
+      if (self->stopped_ || env == nullptr) {
+        for (auto &record : batch) {
+          self->dispose_(record);
+        }
+        return;
+      }
+    }
+    if (batch.empty()) {
+      return;
+    }
+
+    Napi::Array array = Napi::Array::New(env, batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+      array.Set(static_cast<uint32_t>(i), self->toJS_(env, batch[i]));
+      self->dispose_(batch[i]);
+    }
+
+    try {
+      self->callback_.Value().Call({array});
+    } catch (const Napi::Error &e) {
+      NOBJC_ERROR("BatchDelivery: error in JS callback: %s", e.what());
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<Record> pending_;
+  bool flushScheduled_ = false;
+  bool stopped_ = false;
+  uint32_t delayMs_ = 0;
+  napi_env env_ = nullptr;
+  Napi::FunctionReference callback_;  // JS thread only; reset by Stop()
+  nobjc::CallbackLane lane_ = nobjc::CallbackLane::Interactive;
+  std::shared_ptr<nobjc::CallbackDispatcher> dispatcher_;
+  ToJS toJS_;
+  Dispose dispose_;
+};
+
+#endif // BATCH_DELIVERY_H
@@ -0,0 +1,26 @@
+#ifndef BOUND_INVOCATION_H
+#define BOUND_INVOCATION_H
+
+#include <napi.h>
+
+// MARK: - Bound Invocations
+
+// Build a reusable invocation template for one receiver and selector.
+// Fixed arguments are converted once and stored in a retained NSInvocation;
+// only the variable slots are converted on each InvokeBound call.
+// Arguments:
+//   - receiver (ObjcObject): The target, retained by the template
+//   - handle (External<PreparedSend>): From $prepareSend on the receiver
+//   - args (any[]): One entry per selector argument. `undefined` marks a
+//     variable slot; every other value (including null for nil) is fixed.
+// Returns: External<BoundInvocation>
+Napi::Value BindInvocation(const Napi::CallbackInfo &info);
+
+// Invoke a bound template.
+// Arguments:
+//   - bound (External<BoundInvocation>)
+//   - ...args: One value per variable slot, in argument order
+// Returns: The converted return value
+Napi::Value InvokeBound(const Napi::CallbackInfo &info);
+
+#endif // BOUND_INVOCATION_H
@@ -0,0 +1,424 @@
+#include "bound-invocation.h"
+#include "ObjcObject.h"
+#include "bridge.h"
+#include "call-profiler.h"
+#include "call-trace.h"
+#include "callback-dispatcher.h"
+#include "fast-msgsend.h"
+#include "memory-utils.h"
+#include "nobjc_block.h"
+#include "struct-registers.h"
+#include "struct-utils.h"
+#include <Foundation/Foundation.h>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <napi.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// MARK: - Bound Invocation
+
+/**
+ * How InvokeBound sends the message. Every signature $msgSendPrepared sends
+ * with a direct objc_msgSend cast (see fast-msgsend.h) is sent the same way
+ * here; the rest go through the NSInvocation.
+ */
+enum class BoundDispatch : uint8_t {
+  Invocation,
+  Registers,       // 0-3 integer-register args
+  FloatArgument,   // one float or double arg
+  StructReturn,    // register struct return, 0-2 integer-register args
+  StructArgument,  // register struct first arg, optional integer second arg
+};
+
+/**
+ * An NSInvocation with retainArguments set, so the target and every object
+ * argument stay alive for the template's lifetime and C strings and blocks
+ * are copied when set. Converted argument values are also kept in `slots`,
+ * because pointer-typed arguments can refer into them.
+ *
+ * JS values backing fixed `^` (pointer) arguments are pinned with a
+ * reference, since the invocation only holds the raw buffer address.
+ *
+ * For direct dispatch, fixed arguments are also read back from the
+ * invocation once into `registers` (or `structArgument` / `floatArgument`),
+ * so each call converts only the variable slots and sends without the
+ * invocation. The invocation still owns the fixed values.
+ */
+struct BoundInvocation {
+  NSInvocation *invocation = nil;
+  NSMethodSignature *methodSignature = nil;
+  const char *returnType = nullptr;
+  bool isStructReturn = false;
+  std::string className;
+  std::string selectorName;
+  Class receiverClass = Nil;  // for the call profiler
+  SEL selector = nullptr;
+  std::vector<const char *> argTypes;    // simplified, per selector argument
+  std::vector<size_t> variableSlots;     // selector argument indices
+  std::vector<ObjcType> slots;           // converted values, per argument
+  std::vector<Napi::Reference<Napi::Value>> pinned;
+
+  BoundDispatch dispatch = BoundDispatch::Invocation;
+  id target = nil;                       // the invocation's target
+  RegisterStructClass structClass;       // StructReturn / StructArgument
+  uintptr_t registers[3] = {};           // integer-register args
+  double floatArgument = 0;              // FloatArgument, as a double
+  std::vector<uint8_t> structArgument;   // StructArgument, packed
+
+  ~BoundInvocation() {
+    [invocation release];
+    [methodSignature release];
+  }
+};
+
+/**
+ * Convert `value` for selector argument `index` and store it in the
+ * invocation. Block arguments are released after being set; the retaining
+ * invocation holds its own copy.
+ */
+static void SetBoundArgument(Napi::Env env, BoundInvocation &bound,
+                             Class receiverClass, SEL selector, size_t index,
+                             const Napi::Value &value) {
+  NSInvocation *invocation = bound.invocation;
+  const char *typeEncoding = bound.argTypes[index];
+  const NSUInteger invocationIndex = index + 2;
+
+  if (IsStructTypeEncoding(typeEncoding)) {
+    auto buffer = PackJSValueAsStruct(env, value, typeEncoding);
+    [invocation setArgument:buffer.data() atIndex:invocationIndex];
+    return;
+  }
+
+  if (IsBlockTypeEncoding(typeEncoding) && value.IsFunction()) {
+    const char *extEncoding =
+        CachedExtendedBlockEncoding(receiverClass, selector, invocationIndex);
+    const char *blockEncoding =
+        extEncoding == nullptr
+            ? [bound.methodSignature getArgumentTypeAtIndex:invocationIndex]
+            : extEncoding;
+    id block = CreateBlockFromJSFunction(env, value, blockEncoding);
+    if (env.IsExceptionPending()) {
+      throw Napi::Error(env, env.GetAndClearPendingException());
+    }
+    [invocation setArgument:&block atIndex:invocationIndex];
+    if (block != nil) {
+      _Block_release(block);
+    }
+    return;
+  }
+
+  const ObjcArgumentContext context = {
+      .className = bound.className,
+      .selectorName = bound.selectorName,
+      .argumentIndex = (int)index,
+  };
+  auto arg = AsObjCArgument(value, typeEncoding, context);
+  if (!arg.has_value()) {
+    throw Napi::TypeError::New(
+        env, std::string("Unsupported argument type ") + typeEncoding);
+  }
+  bound.slots[index] = std::move(*arg);
+  std::visit(
+      [&](auto &&outer) {
+        using OuterT = std::decay_t<decltype(outer)>;
+        if constexpr (std::is_same_v<OuterT, BaseObjcType>) {
+          std::visit(SetObjCArgumentVisitor{invocation, invocationIndex}, outer);
+        } else if constexpr (std::is_same_v<OuterT, BaseObjcType *>) {
+          if (outer)
+            std::visit(SetObjCArgumentVisitor{invocation, invocationIndex}, *outer);
+        }
+      },
+      bound.slots[index]);
+}
+
+// MARK: - Direct Dispatch
+
+static inline bool IsBlockArgument(const char *typeEncoding) {
+  return *typeEncoding == '@' && typeEncoding[1] == '?';
+}
+
+/**
+ * Pick the direct dispatch for `prepared`, mirroring the checks in
+ * TryFastMsgSend and TryFastStructMsgSend.
+ */
+static BoundDispatch ChooseDispatch(const PreparedSend &prepared,
+                                    const BoundInvocation &bound,
+                                    RegisterStructClass &structClass) {
+  const size_t argCount = bound.argTypes.size();
+  if (prepared.canUseFastPath) {
+    for (size_t i = 0; i < argCount; i++) {
+      const char code = *bound.argTypes[i];
+      if (code == 'f' || code == 'd') {
+        return argCount == 1 ? BoundDispatch::FloatArgument
+                             : BoundDispatch::Invocation;
+      }
+    }
+    return BoundDispatch::Registers;
+  }
+  if (!prepared.canUseStructFastPath) {
+    return BoundDispatch::Invocation;
+  }
+  const size_t firstRegister = bound.isStructReturn ? 0 : 1;
+  for (size_t i = firstRegister; i < argCount; i++) {
+    if (!IsIntegerRegisterTypeCode(*bound.argTypes[i]) ||
+        IsBlockArgument(bound.argTypes[i])) {
+      return BoundDispatch::Invocation;
+    }
+  }
+  if (bound.isStructReturn) {
+    structClass = ClassifyRegisterStruct(bound.returnType);
+    return structClass.kind == RegisterStructKind::None
+               ? BoundDispatch::Invocation
+               : BoundDispatch::StructReturn;
+  }
+  if (!IsFastPathTypeCode(*bound.returnType)) {
+    return BoundDispatch::Invocation;
+  }
+  structClass = ClassifyRegisterStruct(bound.argTypes[0]);
+  return structClass.kind == RegisterStructKind::None
+             ? BoundDispatch::Invocation
+             : BoundDispatch::StructArgument;
+}
+
+/**
+ * Copy fixed argument `index` from the invocation into the direct-dispatch
+ * storage. Integer-register values land zero-extended in a register word,
+ * like JSValueToRegister produces them.
+ */
+static void CaptureFixedArgument(BoundInvocation &bound, size_t index) {
+  NSInvocation *invocation = bound.invocation;
+  const NSInteger invocationIndex = static_cast<NSInteger>(index) + 2;
+  const char code = *bound.argTypes[index];
+  if (bound.dispatch == BoundDispatch::StructArgument && index == 0) {
+    NSUInteger size = 0;
+    NSGetSizeAndAlignment(bound.argTypes[0], &size, nullptr);
+    bound.structArgument.assign(size, 0);
+    [invocation getArgument:bound.structArgument.data() atIndex:invocationIndex];
+  } else if (code == 'd') {
+    [invocation getArgument:&bound.floatArgument atIndex:invocationIndex];
+  } else if (code == 'f') {
+    float value = 0;
+    [invocation getArgument:&value atIndex:invocationIndex];
+    bound.floatArgument = value;
+  } else {
+    const size_t slot = bound.dispatch == BoundDispatch::StructArgument
+                            ? index - 1
+                            : index;
+    uintptr_t value = 0;
+    [invocation getArgument:&value atIndex:invocationIndex];
+    bound.registers[slot] = value;
+  }
+}
+
+/**
+ * Convert the variable arguments and send through the objc_msgSend cast for
+ * `bound.dispatch`. Must not be called for BoundDispatch::Invocation.
+ */
+static Napi::Value InvokeDirect(Napi::Env env, BoundInvocation &bound,
+                                const Napi::CallbackInfo &info) {
+  const ObjcArgumentContext baseContext = {
+      .className = bound.className,
+      .selectorName = bound.selectorName,
+      .argumentIndex = 0,
+  };
+  uintptr_t registers[3] = {bound.registers[0], bound.registers[1],
+                            bound.registers[2]};
+  double floatArgument = bound.floatArgument;
+  std::vector<uint8_t> packedArgument;
+  const std::vector<uint8_t> *structArgument = &bound.structArgument;
+  for (size_t i = 0; i < bound.variableSlots.size(); i++) {
+    const size_t index = bound.variableSlots[i];
+    const Napi::Value &value = info[i + 1];
+    ObjcArgumentContext context = baseContext;
+    context.argumentIndex = static_cast<int>(index);
+    const char code = *bound.argTypes[index];
+    if (bound.dispatch == BoundDispatch::StructArgument && index == 0) {
+      packedArgument = PackJSValueAsStruct(env, value, bound.argTypes[0]);
+      structArgument = &packedArgument;
+    } else if (code == 'd') {
+      floatArgument = ConvertToNativeValue<double>(value, context);
+    } else if (code == 'f') {
+      floatArgument = ConvertToNativeValue<float>(value, context);
+    } else {
+      const size_t slot = bound.dispatch == BoundDispatch::StructArgument
+                              ? index - 1
+                              : index;
+      registers[slot] = JSValueToRegister(env, value, code, context);
+    }
+  }
+
+  nobjc::NativeCallScope nativeCall(env);
+  nobjc::ProfiledCall profiled(bound.receiverClass, bound.selector);
+  nobjc::TraceMethodCall(nobjc::TraceKind::Send, bound.receiverClass,
+                         bound.selector, [&] { return bound.methodSignature; });
+
+  id target = bound.target;
+  SEL selector = bound.selector;
+  const size_t argCount = bound.argTypes.size();
+  const char returnTypeCode = *bound.returnType;
+  switch (bound.dispatch) {
+    case BoundDispatch::Registers:
+      return MsgSendRegisters(env, target, selector, registers, argCount,
+                              returnTypeCode);
+    case BoundDispatch::FloatArgument:
+      if (*bound.argTypes[0] == 'f') {
+        return MsgSendFloatArgument(env, target, selector,
+                                    static_cast<float>(floatArgument),
+                                    returnTypeCode);
+      }
+      return MsgSendFloatArgument(env, target, selector, floatArgument,
+                                  returnTypeCode);
+    case BoundDispatch::StructReturn: {
+      alignas(16) uint8_t buffer[32];
+      DispatchRegisterShape(bound.structClass, [&](auto shape) {
+        using Shape = typename decltype(shape)::type;
+        MsgSendStructReturn<Shape>(target, selector, registers, argCount, buffer);
+      });
+      return UnpackStructToJSValue(env, buffer, bound.returnType);
+    }
+    default: {
+      const bool hasArg1 = argCount == 2;
+      return DispatchRegisterShape(bound.structClass, [&](auto shape) -> Napi::Value {
+        using Shape = typename decltype(shape)::type;
+        Shape arg0{};
+        memcpy(&arg0, structArgument->data(),
+               std::min(structArgument->size(), sizeof(Shape)));
+        if (returnTypeCode == 'd') {
+          return Napi::Number::New(env, MsgSendStructArgument<Shape, double>(
+                                            target, selector, arg0, hasArg1,
+                                            registers[0]));
+        }
+        if (returnTypeCode == 'f') {
+          return Napi::Number::New(
+              env, static_cast<double>(MsgSendStructArgument<Shape, float>(
+                       target, selector, arg0, hasArg1, registers[0])));
+        }
+        return RegisterToJSValue(env,
+                                 MsgSendStructArgument<Shape, uintptr_t>(
+                                     target, selector, arg0, hasArg1,
+                                     registers[0]),
+                                 returnTypeCode);
+      });
+    }
+  }
+}
+
+// MARK: - Exported Functions
+
+Napi::Value BindInvocation(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 3 || !info[0].IsObject() || !info[1].IsExternal() ||
+      !info[2].IsArray()) {
+    throw Napi::TypeError::New(
+        env, "Expected (receiver: ObjcObject, handle: PreparedSend, args: any[])");
+  }
+  Napi::Object receiverObject = info[0].As<Napi::Object>();
+  if (!ObjcObject::IsInstance(env, receiverObject)) {
+    throw Napi::TypeError::New(env, "Receiver must be an ObjcObject instance");
+  }
+  id receiver = ObjcObject::UnwrapObject(env, receiverObject);
+  if (receiver == nil) {
+    throw Napi::TypeError::New(env, "Cannot bind a method on nil");
+  }
+  PreparedSend *prepared = info[1].As<Napi::External<PreparedSend>>().Data();
+  Napi::Array args = info[2].As<Napi::Array>();
+  if (args.Length() != prepared->expectedArgCount) {
+    throw Napi::Error::New(
+        env, std::format("bind: {} expects {} arg(s), got {}",
+                         sel_getName(prepared->selector),
+                         prepared->expectedArgCount, args.Length()));
+  }
+
+  auto bound = std::make_unique<BoundInvocation>();
+  bound->methodSignature = [prepared->methodSignature retain];
+  bound->returnType = prepared->returnType;
+  bound->isStructReturn = prepared->isStructReturn;
+  bound->className = object_getClassName(receiver);
+  bound->selectorName = sel_getName(prepared->selector);
+  bound->receiverClass = object_getClass(receiver);
+  bound->selector = prepared->selector;
+  bound->invocation =
+      [[NSInvocation invocationWithMethodSignature:prepared->methodSignature] retain];
+  [bound->invocation retainArguments];
+  [bound->invocation setSelector:prepared->selector];
+  [bound->invocation setTarget:receiver];
+
+  const size_t argCount = prepared->expectedArgCount;
+  bound->argTypes.resize(argCount);
+  bound->slots.resize(argCount, BaseObjcType{std::monostate{}});
+  for (size_t i = 0; i < argCount; i++) {
+    bound->argTypes[i] = SimplifyTypeEncoding(
+        [prepared->methodSignature getArgumentTypeAtIndex:i + 2]);
+  }
+
+  bound->target = receiver;
+  bound->dispatch = ChooseDispatch(*prepared, *bound, bound->structClass);
+
+  Class receiverClass = object_getClass(receiver);
+  for (size_t i = 0; i < argCount; i++) {
+    Napi::Value value = args.Get(static_cast<uint32_t>(i));
+    if (value.IsUndefined()) {
+      bound->variableSlots.push_back(i);
+      continue;
+    }
+    SetBoundArgument(env, *bound, receiverClass, prepared->selector, i, value);
+    if (*bound->argTypes[i] == '^' && value.IsObject()) {
+      bound->pinned.push_back(Napi::Persistent(value));
+    }
+    if (bound->dispatch != BoundDispatch::Invocation) {
+      CaptureFixedArgument(*bound, i);
+    }
+  }
+
+  return Napi::External<BoundInvocation>::New(
+      env, bound.release(), [](Napi::Env, BoundInvocation *b) { delete b; });
+}
+
+Napi::Value InvokeBound(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsExternal()) {
+    throw Napi::TypeError::New(env, "Expected a BoundInvocation handle");
+  }
+  BoundInvocation *bound = info[0].As<Napi::External<BoundInvocation>>().Data();
+  const size_t provided = info.Length() - 1;
+  if (provided != bound->variableSlots.size()) {
+    throw Napi::Error::New(
+        env, std::format("invoke: {} expects {} variable arg(s), got {}",
+                         bound->selectorName, bound->variableSlots.size(),
+                         provided));
+  }
+
+  if (bound->dispatch != BoundDispatch::Invocation) {
+    return InvokeDirect(env, *bound, info);
+  }
+
+  NSInvocation *invocation = bound->invocation;
+  if (provided > 0) {
+    Class receiverClass = object_getClass([invocation target]);
+    SEL selector = [invocation selector];
+    for (size_t i = 0; i < provided; i++) {
+      SetBoundArgument(env, *bound, receiverClass, selector,
+                       bound->variableSlots[i], info[i + 1]);
+    }
+  }
+
+  {
+    nobjc::NativeCallScope nativeCall(env);
+    nobjc::ProfiledCall profiled(bound->receiverClass, bound->selector);
+    nobjc::TraceMethodCall(nobjc::TraceKind::Send, bound->receiverClass,
+                           bound->selector,
+                           [&] { return bound->methodSignature; });
+    [invocation invoke];
+  }
+
+  if (bound->isStructReturn) {
+    NSUInteger returnLength = [bound->methodSignature methodReturnLength];
+    std::vector<uint8_t> returnBuffer(returnLength, 0);
+    [invocation getReturnValue:returnBuffer.data()];
+    return UnpackStructToJSValue(env, returnBuffer.data(), bound->returnType);
+  }
+  return ConvertReturnValueToJSValue(env, invocation, bound->methodSignature);
+}
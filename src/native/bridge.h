@@ -1,4 +1,6 @@
 #include "ObjcObject.h"
+#include "string-intern.h"
+#include "string-utils.h"
 #include "type-conversion.h"
 #include <Foundation/Foundation.h>
 #include <format>
@@ -182,10 +184,13 @@ T ConvertToNativeValue(const Napi::Value &value,
     if (value.IsObject()) {
       Napi::Object obj = value.As<Napi::Object>();
       if (ObjcObject::IsInstance(value.Env(), obj)) {
-        ObjcObject *objcObj = Napi::ObjectWrap<ObjcObject>::Unwrap(obj);
-        return objcObj->objcObject;
+        return ObjcObject::UnwrapObject(value.Env(), obj);
       }
     }
+    // JS strings become (possibly interned) immutable NSStrings
+    if (value.IsString()) {
+      return NSStringForJSArgument(value.Env(), value);
+    }
   }
   if constexpr (std::is_same_v<T, SEL>) {
     // Handle null/undefined as NULL selector
@@ -218,7 +223,7 @@ T ConvertToNativeValue(const Napi::Value &value,
       throw Napi::TypeError::New(value.Env(),
                                  CONVERT_ARG_ERROR_MSG("Expected a string"));
     }
-    return value.As<Napi::String>().Utf8Value();
+    return JSStringToUtf8(value.Env(), value);
   } else if constexpr (std::is_arithmetic_v<T>) {
     // Handle null/undefined as 0
     if (value.IsNull() || value.IsUndefined()) {
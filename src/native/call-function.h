@@ -5,8 +5,10 @@
 // ============================================================================
 //
 // Provides the ability to call C functions (like NSLog, CGRectMake, etc.)
-// exported from loaded frameworks. Uses dlsym to look up the function
-// symbol and libffi to perform the call with correct ABI handling.
+// exported from loaded frameworks. Uses dlsym (through the resolved-symbol
+// cache in symbol-resolution.h), one image's export index, or an address
+// already returned by ResolveSymbols to find the function, and libffi to
+// perform the call with correct ABI handling.
 //
 // NOTE: No @autoreleasepool is used here. C functions like NSHomeDirectory()
 // return autoreleased objects, and wrapping the call in @autoreleasepool would
@@ -15,10 +17,14 @@
 // pool (from Node's/Bun's event loop) handles cleanup instead.
 //
 
+#include "call-profiler.h"
+#include "call-trace.h"
+#include "callback-dispatcher.h"
 #include "constants.h"
 #include "debug.h"
 #include "ffi-utils.h"
 #include "struct-utils.h"
+#include "symbol-resolution.h"
 #include "type-conversion.h"
 #include <Foundation/Foundation.h>
 #include <dlfcn.h>
@@ -101,12 +107,88 @@ inline Napi::Value ConvertFunctionReturnToJS(Napi::Env env, void *returnBuffer,
   return ConvertFFIReturnToJS(env, returnBuffer, typeEncoding.c_str());
 }
 
+// MARK: - Function Lookup
+
+/// Resolve CallFunction's first argument to a function pointer. `target` is
+/// either the function name, or `{ name, image?, address? }` where `image`
+/// scopes the lookup to that loaded library's export index and `address` (a
+/// bigint from ResolveSymbols) skips lookup entirely. Sets `functionName` for
+/// error messages and tracing. Throws if the function cannot be found.
+inline void *ResolveFunctionTarget(Napi::Env env, const Napi::Value &target,
+                                   std::string &functionName) {
+  if (target.IsString()) {
+    functionName = target.As<Napi::String>().Utf8Value();
+    void *funcPtr = LookupFunctionSymbol(functionName);
+    if (!funcPtr) {
+      throw Napi::Error::New(
+          env, "Function '" + functionName +
+                   "' not found. Make sure the framework is loaded first. "
+                   "dlsym error: " +
+                   std::string(dlerror() ?: "unknown"));
+    }
+    return funcPtr;
+  }
+
+  if (!target.IsObject()) {
+    throw Napi::TypeError::New(
+        env, "First argument must be a function name or "
+             "{ name, image?, address? }");
+  }
+  Napi::Object options = target.As<Napi::Object>();
+  Napi::Value name = options.Get("name");
+  if (!name.IsString()) {
+    throw Napi::TypeError::New(env, "Function target name must be a string");
+  }
+  functionName = name.As<Napi::String>().Utf8Value();
+
+  Napi::Value address = options.Get("address");
+  Napi::Value image = options.Get("image");
+  bool hasAddress = !address.IsUndefined() && !address.IsNull();
+  bool hasImage = !image.IsUndefined() && !image.IsNull();
+  if (hasAddress && hasImage) {
+    throw Napi::TypeError::New(
+        env, "Pass either image or address for function '" + functionName +
+                 "', not both");
+  }
+
+  if (hasAddress) {
+    if (!address.IsBigInt()) {
+      throw Napi::TypeError::New(
+          env, "Function address must be a bigint from resolveSymbols");
+    }
+    bool lossless = false;
+    uint64_t raw = address.As<Napi::BigInt>().Uint64Value(&lossless);
+    if (!lossless || raw == 0) {
+      throw Napi::Error::New(env, "Invalid address for function '" +
+                                      functionName + "'");
+    }
+    return reinterpret_cast<void *>(static_cast<uintptr_t>(raw));
+  }
+
+  if (hasImage) {
+    if (!image.IsString()) {
+      throw Napi::TypeError::New(env, "Image must be a string path");
+    }
+    std::string imagePath = image.As<Napi::String>().Utf8Value();
+    void *funcPtr = LookupImageFunctionSymbol(env, imagePath, functionName);
+    if (!funcPtr) {
+      throw Napi::Error::New(env, "Function '" + functionName +
+                                      "' is not exported by '" + imagePath +
+                                      "'");
+    }
+    return funcPtr;
+  }
+
+  return ResolveFunctionTarget(env, name, functionName);
+}
+
 // MARK: - CallFunction Implementation
 
 /// Native implementation of CallFunction.
 ///
 /// Arguments:
-///   info[0]: function name (string)
+///   info[0]: function name (string) or { name, image?, address? } - see
+///            ResolveFunctionTarget
 ///   info[1]: return type encoding (string)
 ///   info[2]: argument type encodings (array of strings)
 ///   info[3]: fixed argument count (number) - if < total args, uses
@@ -123,12 +205,10 @@ inline Napi::Value CallFunction(const Napi::CallbackInfo &info) {
         "argTypes, fixedArgCount");
   }
 
-  // Parse function name
-  if (!info[0].IsString()) {
-    throw Napi::TypeError::New(env, "First argument (function name) must be "
-                                    "a string");
-  }
-  std::string functionName = info[0].As<Napi::String>().Utf8Value();
+  // Resolve the function before parsing types, so the name is available for
+  // error messages (RTLD_DEFAULT lookups are cached after the first success)
+  std::string functionName;
+  void *funcPtr = ResolveFunctionTarget(env, info[0], functionName);
 
   // Parse return type encoding
   if (!info[1].IsString()) {
@@ -173,22 +253,10 @@ inline Napi::Value CallFunction(const Napi::CallbackInfo &info) {
                  " for function '" + functionName + "'");
   }
 
-  NOBJC_LOG("CallFunction: Looking up '%s' (return=%s, %u args, %d fixed)",
-            functionName.c_str(), returnType.c_str(), argCount,
+  NOBJC_LOG("CallFunction: '%s' at %p (return=%s, %u args, %d fixed)",
+            functionName.c_str(), funcPtr, returnType.c_str(), argCount,
             fixedArgCount);
 
-  // Look up the function symbol
-  void *funcPtr = dlsym(RTLD_DEFAULT, functionName.c_str());
-  if (!funcPtr) {
-    throw Napi::Error::New(
-        env, "Function '" + functionName +
-                 "' not found. Make sure the framework is loaded first. "
-                 "dlsym error: " +
-                 std::string(dlerror() ?: "unknown"));
-  }
-
-  NOBJC_LOG("CallFunction: Found '%s' at %p", functionName.c_str(), funcPtr);
-
   // Build FFI type arrays
   FFITypeGuard guard;
 
@@ -261,8 +329,16 @@ inline Napi::Value CallFunction(const Napi::CallbackInfo &info) {
   // Make the FFI call
   NOBJC_LOG("CallFunction: Calling '%s' with %u args...",
             functionName.c_str(), argCount);
-  ffi_call(&cif, FFI_FN(funcPtr), returnBuffer ? returnBuffer.get() : nullptr,
-           argCount > 0 ? argValues.data() : nullptr);
+  {
+    nobjc::NativeCallScope nativeCall(env);
+    nobjc::ProfiledCall profiled(funcPtr);
+    nobjc::TraceEncodedCall(nobjc::TraceKind::Function, funcPtr, [&] {
+      return nobjc::DescribeEncodedShape("function", functionName,
+                                         returnType.c_str(), argTypes);
+    });
+    ffi_call(&cif, FFI_FN(funcPtr), returnBuffer ? returnBuffer.get() : nullptr,
+             argCount > 0 ? argValues.data() : nullptr);
+  }
   NOBJC_LOG("CallFunction: '%s' returned successfully", functionName.c_str());
 
   // Convert return value
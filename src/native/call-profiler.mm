@@ -0,0 +1,210 @@
+#include "call-profiler.h"
+#include "constants.h"
+#include <Foundation/Foundation.h>
+#include <algorithm>
+#include <chrono>
+#include <dlfcn.h>
+#include <format>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nobjc {
+
+std::atomic<bool> gCallProfilerActive{false};
+
+// MARK: - Slot Registry
+
+namespace {
+
+// Every thread that has published a frame. The sampler holds the mutex while
+// it reads, and a thread unregisters under it on exit, so the sampler never
+// reads a dead slot. Leaked so thread exits during shutdown stay safe.
+struct SlotRegistry {
+  std::mutex mutex;
+  std::vector<CallProfilerSlot *> slots;
+};
+
+SlotRegistry &GetSlotRegistry() {
+  static SlotRegistry *registry = new SlotRegistry();
+  return *registry;
+}
+
+struct SlotRegistration {
+  CallProfilerSlot slot;
+
+  SlotRegistration() {
+    SlotRegistry &registry = GetSlotRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.slots.push_back(&slot);
+  }
+
+  ~SlotRegistration() {
+    SlotRegistry &registry = GetSlotRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::erase(registry.slots, &slot);
+  }
+};
+
+} // namespace
+
+CallProfilerSlot &CurrentProfilerSlot() {
+  thread_local SlotRegistration registration;
+  return registration.slot;
+}
+
+// MARK: - Sampler
+
+namespace {
+
+using ProfileFrame = std::pair<uintptr_t, uintptr_t>;
+
+struct Sampler {
+  uint32_t hz = 0;
+  std::chrono::steady_clock::time_point started;
+  std::atomic<bool> stopping{false};
+  std::thread thread;
+
+  // Written by the sampler thread only; read after join()
+  uint64_t ticks = 0;
+  uint64_t samples = 0;
+  std::map<std::vector<ProfileFrame>, uint64_t> stacks;
+
+  void SampleOnce(std::vector<ProfileFrame> &stack) {
+    SlotRegistry &registry = GetSlotRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (CallProfilerSlot *slot : registry.slots) {
+      uint32_t depth = slot->depth.load(std::memory_order_acquire);
+      if (depth == 0) {
+        continue;
+      }
+      depth = std::min(depth, kProfilerMaxDepth);
+      stack.clear();
+      for (uint32_t i = 0; i < depth; i++) {
+        stack.emplace_back(slot->owners[i].load(std::memory_order_relaxed),
+                           slot->targets[i].load(std::memory_order_relaxed));
+      }
+      stacks[stack]++;
+      samples++;
+    }
+    ticks++;
+  }
+
+  void Run() {
+    const auto interval = std::chrono::nanoseconds(1'000'000'000 / hz);
+    auto next = std::chrono::steady_clock::now();
+    std::vector<ProfileFrame> stack;
+    stack.reserve(kProfilerMaxDepth);
+    while (!stopping.load(std::memory_order_relaxed)) {
+      next += interval;
+      const auto now = std::chrono::steady_clock::now();
+      if (next < now) {
+        next = now; // Fell behind (e.g. descheduled); don't burst to catch up
+      } else {
+        std::this_thread::sleep_until(next);
+      }
+      SampleOnce(stack);
+    }
+  }
+};
+
+std::mutex gSamplerMutex;
+std::unique_ptr<Sampler> gSampler; // guarded by gSamplerMutex
+
+std::string DescribeFrame(const ProfileFrame &frame) {
+  if (frame.first == kProfilerFunctionFrame) {
+    Dl_info dlInfo;
+    if (dladdr(reinterpret_cast<const void *>(frame.second), &dlInfo) != 0 &&
+        dlInfo.dli_sname != nullptr) {
+      return std::string(dlInfo.dli_sname) + "()";
+    }
+    return std::format("{:#x}()", frame.second);
+  }
+  Class cls = reinterpret_cast<Class>(frame.first);
+  SEL selector = reinterpret_cast<SEL>(frame.second);
+  const char *name = selector != nullptr ? sel_getName(selector) : "?";
+  if (cls == nil) {
+    return std::format("-[? {}]", name);
+  }
+  return std::format("{}[{} {}]", class_isMetaClass(cls) ? '+' : '-',
+                     class_getName(cls), name);
+}
+
+} // namespace
+
+} // namespace nobjc
+
+// MARK: - Exported Functions
+
+Napi::Value StartCallProfiler(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected a sampling rate in Hz (number)");
+  }
+  double hz = info[0].As<Napi::Number>().DoubleValue();
+  if (!(hz >= 1) || hz > nobjc::kProfilerMaxHz) {
+    throw Napi::RangeError::New(
+        env, std::format("Sampling rate must be between 1 and {} Hz",
+                         nobjc::kProfilerMaxHz));
+  }
+
+  std::lock_guard<std::mutex> lock(nobjc::gSamplerMutex);
+  if (nobjc::gSampler) {
+    throw Napi::Error::New(env, "The call profiler is already running");
+  }
+  auto sampler = std::make_unique<nobjc::Sampler>();
+  sampler->hz = static_cast<uint32_t>(hz);
+  sampler->started = std::chrono::steady_clock::now();
+  nobjc::Sampler *raw = sampler.get();
+  sampler->thread = std::thread([raw] { raw->Run(); });
+  nobjc::gSampler = std::move(sampler);
+  nobjc::gCallProfilerActive.store(true, std::memory_order_relaxed);
+  return env.Undefined();
+}
+
+Napi::Value StopCallProfiler(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  std::unique_ptr<nobjc::Sampler> sampler;
+  {
+    std::lock_guard<std::mutex> lock(nobjc::gSamplerMutex);
+    if (!nobjc::gSampler) {
+      throw Napi::Error::New(env, "The call profiler is not running");
+    }
+    sampler = std::move(nobjc::gSampler);
+  }
+  // Calls already in flight pop their frames normally; new ones stop pushing.
+  nobjc::gCallProfilerActive.store(false, std::memory_order_relaxed);
+  sampler->stopping.store(true, std::memory_order_relaxed);
+  sampler->thread.join();
+
+  const auto duration = std::chrono::steady_clock::now() - sampler->started;
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("durationMs",
+             Napi::Number::New(env, std::chrono::duration<double, std::milli>(duration).count()));
+  result.Set("hz", Napi::Number::New(env, sampler->hz));
+  result.Set("ticks", Napi::Number::New(env, static_cast<double>(sampler->ticks)));
+  result.Set("samples", Napi::Number::New(env, static_cast<double>(sampler->samples)));
+
+  Napi::Array stacks = Napi::Array::New(env, sampler->stacks.size());
+  uint32_t index = 0;
+  @autoreleasepool {
+    for (const auto &[frames, count] : sampler->stacks) {
+      Napi::Array names = Napi::Array::New(env, frames.size());
+      for (size_t i = 0; i < frames.size(); i++) {
+        names.Set(static_cast<uint32_t>(i),
+                  Napi::String::New(env, nobjc::DescribeFrame(frames[i])));
+      }
+      Napi::Object stack = Napi::Object::New(env);
+      stack.Set("frames", names);
+      stack.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+      stacks.Set(index++, stack);
+    }
+  }
+  result.Set("stacks", stacks);
+  return result;
+}
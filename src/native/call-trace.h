@@ -0,0 +1,117 @@
+#ifndef CALL_TRACE_H
+#define CALL_TRACE_H
+
+/**
+ * @file call-trace.h
+ * @brief Opt-in recording of the bridge's call mix as a compact binary trace.
+ *
+ * While a trace runs, every send, bound invocation, C function call,
+ * parallel send and JS callback is recorded. Each distinct call shape is
+ * stored once: its kind, class and selector (or function or block
+ * signature), and its argument and return kinds and sizes. After that, a
+ * call costs one 10-byte record (shape index, time offset, thread ordinal).
+ * Argument values are never recorded, so a trace can be shared and replayed
+ * by benchmarks/replay.ts on another machine.
+ *
+ * Recording takes one mutex per call. When no trace is running, the cost is
+ * one relaxed load and a branch.
+ *
+ * Buffer layout (little-endian):
+ *   header   "NOBJTRC\0", u16 version, u16 threadCount, u32 durationUs,
+ *            u32 droppedRecords, u32 shapeCount, u32 recordCount
+ *   shape    u8 kind, u8 returnKind, u16 argCount, u32 returnSize,
+ *            u16 ownerLength, owner, u16 nameLength, name,
+ *            argCount x (u8 argKind, u32 argSize)
+ *   record   u32 shape, u32 timeUs, u16 thread
+ * Kinds are simplified type-encoding characters. Thread 0 is the thread
+ * that started the trace.
+ */
+
+#include <Foundation/Foundation.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <napi.h>
+#include <objc/runtime.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nobjc {
+
+// MARK: - Shapes
+
+enum class TraceKind : uint8_t {
+  Send = 0,                // Message sent from JS (including bound and parallel sends)
+  Function = 1,            // C function called from JS
+  Callback = 2,            // JS method or block called on the JS thread
+  CrossThreadCallback = 3, // JS method or block called from another thread
+};
+
+/// Everything recorded about one distinct call site. Built once per shape.
+struct TraceShape {
+  TraceKind kind = TraceKind::Send;
+  std::string owner; // Class name, "function" or "block"
+  std::string name;  // Selector, function name or block signature
+  char returnKind = 'v';
+  uint32_t returnSize = 0;
+  std::vector<std::pair<char, uint32_t>> args; // (kind, size)
+};
+
+/// Shape of a method from its signature (arguments after self and _cmd).
+TraceShape DescribeMethodShape(Class cls, SEL selector,
+                               NSMethodSignature *signature);
+
+/// Shape of a function or block from its type encodings.
+TraceShape DescribeEncodedShape(std::string owner, std::string name,
+                                const char *returnType,
+                                const std::vector<std::string> &argTypes);
+
+// MARK: - Recording
+
+/// Set while a trace is being recorded.
+extern std::atomic<bool> gCallTraceActive;
+
+/**
+ * Record one call. (kind, owner, target) identifies the shape; `describe`
+ * runs only the first time a shape is seen in the current trace.
+ */
+void RecordTraceEvent(TraceKind kind, const void *owner, const void *target,
+                      const std::function<TraceShape()> &describe);
+
+/**
+ * Record a method call. `getSignature` is called only for a new shape, so
+ * call sites without a signature at hand can look it up lazily.
+ */
+template <typename GetSignature>
+inline void TraceMethodCall(TraceKind kind, Class cls, SEL selector,
+                            GetSignature &&getSignature) {
+  if (gCallTraceActive.load(std::memory_order_relaxed)) {
+    RecordTraceEvent(kind, cls, selector, [&] {
+      return DescribeMethodShape(cls, selector, getSignature());
+    });
+  }
+}
+
+/// Record a call described by type encodings (C functions and blocks).
+/// `key` identifies the shape, e.g. the function pointer.
+template <typename Describe>
+inline void TraceEncodedCall(TraceKind kind, const void *key,
+                             Describe &&describe) {
+  if (gCallTraceActive.load(std::memory_order_relaxed)) {
+    RecordTraceEvent(kind, nullptr, key, describe);
+  }
+}
+
+} // namespace nobjc
+
+// MARK: - Exported Functions
+
+// Start recording the call mix.
+Napi::Value StartCallTrace(const Napi::CallbackInfo &info);
+
+// Stop recording.
+// Returns: Buffer (see the layout above)
+Napi::Value StopCallTrace(const Napi::CallbackInfo &info);
+
+#endif // CALL_TRACE_H
@@ -0,0 +1,258 @@
+#include "call-trace.h"
+#include "constants.h"
+#include "type-conversion.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace nobjc {
+
+std::atomic<bool> gCallTraceActive{false};
+
+// MARK: - Shapes
+
+namespace {
+
+std::pair<char, uint32_t> DescribeEncoding(const char *encoding) {
+  const char *simplified = SimplifyTypeEncoding(encoding);
+  char kind = *simplified != '\0' ? *simplified : 'v';
+  NSUInteger size = 0;
+  if (kind != 'v') {
+    @try {
+      NSGetSizeAndAlignment(simplified, &size, nullptr);
+    } @catch (NSException *) {
+      size = 0; // Extended or unusual encodings; the kind is still recorded
+    }
+  }
+  return {kind, static_cast<uint32_t>(size)};
+}
+
+} // namespace
+
+TraceShape DescribeMethodShape(Class cls, SEL selector,
+                               NSMethodSignature *signature) {
+  TraceShape shape;
+  shape.owner = cls != Nil ? class_getName(cls) : "?";
+  shape.name = selector != nullptr ? sel_getName(selector) : "?";
+  if (signature == nil) {
+    return shape;
+  }
+  std::tie(shape.returnKind, shape.returnSize) =
+      DescribeEncoding([signature methodReturnType]);
+  const NSUInteger count = [signature numberOfArguments];
+  for (NSUInteger i = 2; i < count; i++) {
+    shape.args.push_back(DescribeEncoding([signature getArgumentTypeAtIndex:i]));
+  }
+  return shape;
+}
+
+TraceShape DescribeEncodedShape(std::string owner, std::string name,
+                                const char *returnType,
+                                const std::vector<std::string> &argTypes) {
+  TraceShape shape;
+  shape.owner = std::move(owner);
+  shape.name = std::move(name);
+  std::tie(shape.returnKind, shape.returnSize) = DescribeEncoding(returnType);
+  for (const std::string &argType : argTypes) {
+    shape.args.push_back(DescribeEncoding(argType.c_str()));
+  }
+  return shape;
+}
+
+// MARK: - Recorder
+
+namespace {
+
+struct TraceRecord {
+  uint32_t shape;
+  uint32_t timeUs;
+  uint16_t thread;
+};
+
+using TraceShapeKey = std::tuple<uint8_t, uintptr_t, uintptr_t>;
+
+struct TraceRecorder {
+  std::mutex mutex;
+  // All below guarded by `mutex`
+  uint64_t generation = 0; // Bumped per trace so thread ordinals restart
+  std::chrono::steady_clock::time_point started;
+  std::map<TraceShapeKey, uint32_t> shapeIndex;
+  std::vector<TraceShape> shapes;
+  std::vector<TraceRecord> records;
+  uint32_t dropped = 0;
+  uint16_t threadCount = 0;
+
+  // Caller holds `mutex`
+  uint16_t CurrentThreadOrdinal() {
+    thread_local uint64_t seenGeneration = 0;
+    thread_local uint16_t ordinal = 0;
+    if (seenGeneration != generation) {
+      seenGeneration = generation;
+      ordinal = threadCount < std::numeric_limits<uint16_t>::max()
+                    ? threadCount++
+                    : threadCount;
+    }
+    return ordinal;
+  }
+};
+
+// Leaked so worker threads recording during shutdown stay safe.
+TraceRecorder &GetTraceRecorder() {
+  static TraceRecorder *recorder = new TraceRecorder();
+  return *recorder;
+}
+
+class TraceWriter {
+public:
+  void U8(uint8_t value) { bytes_.push_back(value); }
+
+  void U16(uint16_t value) {
+    U8(static_cast<uint8_t>(value));
+    U8(static_cast<uint8_t>(value >> 8));
+  }
+
+  void U32(uint32_t value) {
+    U16(static_cast<uint16_t>(value));
+    U16(static_cast<uint16_t>(value >> 16));
+  }
+
+  void String(const std::string &value) {
+    const size_t length = std::min<size_t>(value.size(), 0xFFFF);
+    U16(static_cast<uint16_t>(length));
+    bytes_.insert(bytes_.end(), value.begin(), value.begin() + length);
+  }
+
+  std::vector<uint8_t> &Bytes() { return bytes_; }
+
+private:
+  std::vector<uint8_t> bytes_;
+};
+
+constexpr char kTraceMagic[8] = {'N', 'O', 'B', 'J', 'T', 'R', 'C', '\0'};
+constexpr uint16_t kTraceVersion = 1;
+
+} // namespace
+
+void RecordTraceEvent(TraceKind kind, const void *owner, const void *target,
+                      const std::function<TraceShape()> &describe) {
+  TraceRecorder &recorder = GetTraceRecorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  // Re-checked under the lock: the trace may have stopped since the caller's
+  // unlocked check.
+  if (!gCallTraceActive.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (recorder.records.size() >= kTraceMaxRecords) {
+    recorder.dropped++;
+    return;
+  }
+
+  const TraceShapeKey key{static_cast<uint8_t>(kind),
+                          reinterpret_cast<uintptr_t>(owner),
+                          reinterpret_cast<uintptr_t>(target)};
+  auto [it, inserted] = recorder.shapeIndex.try_emplace(
+      key, static_cast<uint32_t>(recorder.shapes.size()));
+  if (inserted) {
+    TraceShape shape = describe();
+    shape.kind = kind;
+    recorder.shapes.push_back(std::move(shape));
+  }
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - recorder.started);
+  recorder.records.push_back(
+      {it->second,
+       static_cast<uint32_t>(std::min<int64_t>(
+           elapsed.count(), std::numeric_limits<uint32_t>::max())),
+       recorder.CurrentThreadOrdinal()});
+}
+
+} // namespace nobjc
+
+// MARK: - Exported Functions
+
+Napi::Value StartCallTrace(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  nobjc::TraceRecorder &recorder = nobjc::GetTraceRecorder();
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  if (nobjc::gCallTraceActive.load(std::memory_order_relaxed)) {
+    throw Napi::Error::New(env, "A call trace is already being recorded");
+  }
+  recorder.generation++;
+  recorder.started = std::chrono::steady_clock::now();
+  recorder.shapeIndex.clear();
+  recorder.shapes.clear();
+  recorder.records.clear();
+  recorder.dropped = 0;
+  recorder.threadCount = 0;
+  recorder.CurrentThreadOrdinal(); // The starting thread is thread 0
+  nobjc::gCallTraceActive.store(true, std::memory_order_relaxed);
+  return env.Undefined();
+}
+
+Napi::Value StopCallTrace(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  nobjc::TraceRecorder &recorder = nobjc::GetTraceRecorder();
+  std::vector<nobjc::TraceShape> shapes;
+  std::vector<nobjc::TraceRecord> records;
+  uint32_t durationUs;
+  uint32_t dropped;
+  uint16_t threadCount;
+  {
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    if (!nobjc::gCallTraceActive.load(std::memory_order_relaxed)) {
+      throw Napi::Error::New(env, "No call trace is being recorded");
+    }
+    nobjc::gCallTraceActive.store(false, std::memory_order_relaxed);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - recorder.started);
+    durationUs = static_cast<uint32_t>(std::min<int64_t>(
+        elapsed.count(), std::numeric_limits<uint32_t>::max()));
+    dropped = recorder.dropped;
+    threadCount = recorder.threadCount;
+    shapes = std::move(recorder.shapes);
+    records = std::move(recorder.records);
+    recorder.shapes.clear();
+    recorder.records.clear();
+    recorder.shapeIndex.clear();
+  }
+
+  nobjc::TraceWriter writer;
+  for (char c : nobjc::kTraceMagic) {
+    writer.U8(static_cast<uint8_t>(c));
+  }
+  writer.U16(nobjc::kTraceVersion);
+  writer.U16(threadCount);
+  writer.U32(durationUs);
+  writer.U32(dropped);
+  writer.U32(static_cast<uint32_t>(shapes.size()));
+  writer.U32(static_cast<uint32_t>(records.size()));
+  for (const nobjc::TraceShape &shape : shapes) {
+    writer.U8(static_cast<uint8_t>(shape.kind));
+    writer.U8(static_cast<uint8_t>(shape.returnKind));
+    writer.U16(static_cast<uint16_t>(shape.args.size()));
+    writer.U32(shape.returnSize);
+    writer.String(shape.owner);
+    writer.String(shape.name);
+    for (const auto &[kind, size] : shape.args) {
+      writer.U8(static_cast<uint8_t>(kind));
+      writer.U32(size);
+    }
+  }
+  writer.Bytes().reserve(writer.Bytes().size() + records.size() * 10);
+  for (const nobjc::TraceRecord &record : records) {
+    writer.U32(record.shape);
+    writer.U32(record.timeUs);
+    writer.U16(record.thread);
+  }
+
+  std::vector<uint8_t> &bytes = writer.Bytes();
+  return Napi::Buffer<uint8_t>::Copy(env, bytes.data(), bytes.size());
+}
@@ -0,0 +1,176 @@
+#ifndef CALLBACK_DEADLINE_H
+#define CALLBACK_DEADLINE_H
+
+/**
+ * @file callback-deadline.h
+ * @brief Bounded waits for synchronous cross-thread callbacks.
+ *
+ * A native thread that calls a JS-backed method or block from off the JS
+ * thread parks in a run loop pump until the JS thread has run the callback.
+ * With a deadline, the thread gives up if the JS thread has not *started*
+ * the callback in time: it returns a precomputed default value (zero, nil,
+ * NO, or a configured scalar) and the queued callback is skipped when the
+ * JS thread reaches it.
+ *
+ * A callback that has already started is always waited for, because it
+ * reads the caller's arguments (and may write through out-parameters)
+ * directly from the suspended frame.
+ *
+ * The waiter and the queued task share a CallCompletion, so whichever side
+ * finishes last frees it.
+ */
+
+#include "callback-dispatcher.h"
+#include "constants.h"
+#include "type-dispatch.h"
+#include <CoreFoundation/CoreFoundation.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+
+// MARK: - Completion State
+
+/**
+ * Hand-off between a waiting native thread and the JS-thread task that
+ * serves it. The task's Claim() and the waiter's timeout race under the
+ * mutex; exactly one of them moves the state out of Pending.
+ */
+struct CallCompletion {
+  enum class State : uint8_t { Pending, Running, Done, Abandoned };
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  State state = State::Pending;
+
+  /// JS thread: take the call. False if the waiter already gave up, in which
+  /// case the task must not touch the caller's arguments or return slot.
+  bool Claim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == State::Abandoned) {
+      return false;
+    }
+    state = State::Running;
+    return true;
+  }
+
+  void Finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state != State::Abandoned) {
+      state = State::Done;
+    }
+    cv.notify_one();
+  }
+};
+
+// MARK: - Deadlines
+
+/// Function properties read by CallbackDeadlineForFunction (set by
+/// withTimeout()).
+constexpr const char *kCallbackTimeoutProperty = "__nobjcCallbackTimeoutMs";
+constexpr const char *kCallbackDefaultReturnProperty =
+    "__nobjcCallbackDefaultReturn";
+
+/**
+ * Per-callback deadline settings, resolved on the JS thread when the method
+ * or block is created so a timed-out waiter never needs JS.
+ */
+struct CallbackDeadline {
+  // < 0: use the env's default timeout; 0: wait forever; > 0: milliseconds
+  int64_t timeoutMs = -1;
+  // Return bytes handed back on timeout (scalar returns; zero otherwise)
+  uint8_t defaultReturn[16] = {};
+
+  uint32_t Resolve(const nobjc::CallbackDispatcher &dispatcher) const {
+    return timeoutMs < 0 ? dispatcher.DefaultTimeoutMs()
+                         : static_cast<uint32_t>(timeoutMs);
+  }
+
+  /// Fill a return slot of `size` bytes with the default value.
+  void ApplyTo(void *returnSlot, size_t size) const {
+    if (returnSlot == nullptr || size == 0) {
+      return;
+    }
+    std::memset(returnSlot, 0, size);
+    std::memcpy(returnSlot, defaultReturn,
+                size < sizeof(defaultReturn) ? size : sizeof(defaultReturn));
+  }
+};
+
+/**
+ * Read a callback's timeout and default return value. `returnCode` is the
+ * simplified return type code. Numbers and booleans are accepted for
+ * numeric returns; object, pointer and struct returns only default to
+ * nil/NULL/zero. JS thread only.
+ */
+inline CallbackDeadline CallbackDeadlineForFunction(const Napi::Function &fn,
+                                                    char returnCode) {
+  CallbackDeadline deadline;
+  Napi::Env env = fn.Env();
+  Napi::Value timeout = fn.Get(kCallbackTimeoutProperty);
+  if (timeout.IsNumber()) {
+    double ms = timeout.As<Napi::Number>().DoubleValue();
+    deadline.timeoutMs = ms > 0 ? static_cast<int64_t>(ms) : 0;
+  }
+
+  Napi::Value value = fn.Get(kCallbackDefaultReturnProperty);
+  if (value.IsUndefined() || value.IsNull()) {
+    return deadline;
+  }
+  if (!value.IsNumber() && !value.IsBoolean()) {
+    throw Napi::TypeError::New(env, "defaultReturn must be a number, boolean or null");
+  }
+  double number = value.IsBoolean() ? (value.As<Napi::Boolean>().Value() ? 1 : 0)
+                                    : value.As<Napi::Number>().DoubleValue();
+  bool stored = DispatchNumericType(
+      returnCode,
+      [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        T converted = static_cast<T>(number);
+        std::memcpy(deadline.defaultReturn, &converted, sizeof(T));
+        return true;
+      },
+      false);
+  if (!stored) {
+    throw Napi::TypeError::New(
+        env, "defaultReturn is only supported for numeric and BOOL returns");
+  }
+  return deadline;
+}
+
+// MARK: - Waiting
+
+/**
+ * Pump the run loop until `completion` is done or, if `timeoutMs` is
+ * non-zero, until the deadline passes while the call is still queued.
+ * Returns false if the call was abandoned; the caller then writes the
+ * default return value itself. Wait time is recorded on `dispatcher`.
+ */
+inline bool WaitForCallback(CallCompletion &completion,
+                            nobjc::CallbackDispatcher &dispatcher,
+                            uint32_t timeoutMs) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + std::chrono::milliseconds(timeoutMs);
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> lock(completion.mutex);
+      if (completion.state == CallCompletion::State::Done) {
+        break;
+      }
+      if (timeoutMs != 0 && completion.state == CallCompletion::State::Pending &&
+          std::chrono::steady_clock::now() >= deadline) {
+        completion.state = CallCompletion::State::Abandoned;
+        dispatcher.RecordWait(std::chrono::steady_clock::now() - start, true);
+        return false;
+      }
+    }
+    CFRunLoopRunInMode(kCFRunLoopDefaultMode, nobjc::kRunLoopPumpInterval, true);
+  }
+  dispatcher.RecordWait(std::chrono::steady_clock::now() - start, false);
+  return true;
+}
+
+#endif // CALLBACK_DEADLINE_H
@@ -0,0 +1,201 @@
+#ifndef CALLBACK_DISPATCHER_H
+#define CALLBACK_DISPATCHER_H
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+
+// MARK: - Callback Lanes
+
+namespace nobjc {
+
+/**
+ * Delivery priority for work posted to the JS thread from other threads.
+ * Lower values are served first.
+ */
+enum class CallbackLane : uint8_t {
+  Blocking,     // A native thread is parked until the callback returns
+  Interactive,  // Nobody waits, but latency is visible (notifications, KVO)
+  Background,   // Bulk work that may wait behind everything else
+};
+
+constexpr size_t kCallbackLaneCount = 3;
+
+/// Function property read by CallbackLaneForFunction (set by withPriority()).
+constexpr const char *kCallbackPriorityProperty = "__nobjcCallbackPriority";
+
+/// "blocking", "interactive" or "background".
+const char *CallbackLaneName(CallbackLane lane);
+
+/// The lane named by `fn[kCallbackPriorityProperty]`, or `fallback` when the
+/// property is missing or unrecognized. JS thread only.
+CallbackLane CallbackLaneForFunction(const Napi::Function &fn,
+                                     CallbackLane fallback);
+
+// MARK: - Dispatcher
+
+/**
+ * One prioritized queue of JS-thread work per env.
+ *
+ * Forwarded methods, blocks called off the JS thread and batched
+ * notification/KVO delivery all post here instead of through their own
+ * ThreadSafeFunctions. A single TSFN schedules a drain; the drain runs tasks
+ * lane by lane (every Blocking task before any Interactive one, and so on)
+ * until kCallbackDrainBudgetMs has passed, then reschedules itself so timers
+ * and I/O get a turn. A thread waiting in WaitForCallback therefore
+ * only queues behind other waiters, not behind a flood of notifications.
+ *
+ * Tasks receive a null env when the env is shutting down; they must then
+ * release whatever they own (and signal any waiter) without touching JS.
+ *
+ * The TSFN does not keep the event loop alive by itself. Long-lived
+ * consumers that should (subscriptions) register with AddClient().
+ *
+ * While the JS thread is inside a native call (NativeCallScope), the TSFN
+ * drain cannot run. If that call spins the run loop (a modal session,
+ * -[NSRunLoop runMode:beforeDate:], a main-thread wait that services
+ * sources), the Blocking lane is served from a run loop source on the JS
+ * thread instead, so a delegate called back from the thread the native call
+ * is waiting on completes instead of deadlocking. Waits that never run the
+ * run loop (semaphores, dispatch_sync) still need a callback timeout.
+ */
+class CallbackDispatcher
+    : public std::enable_shared_from_this<CallbackDispatcher> {
+public:
+  using Task = std::function<void(Napi::Env)>;
+
+  /// The env's dispatcher, created on first use. JS thread only.
+  static std::shared_ptr<CallbackDispatcher> ForEnv(Napi::Env env);
+
+  /**
+   * Queue `task` on `lane`. Safe from any thread. If the env is gone the
+   * task runs immediately, on the calling thread, with a null env.
+   */
+  void Post(CallbackLane lane, Task task);
+
+  /// Keep the event loop alive while at least one client is registered.
+  /// JS thread only.
+  void AddClient(Napi::Env env);
+  void RemoveClient(Napi::Env env);
+
+  /// Bracket a native call made from the JS thread. Enter wakes the nested
+  /// drain if waiters are already queued. JS thread only.
+  void EnterNativeCall();
+  void LeaveNativeCall() {
+    nativeDepth_.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  /// Deadline for synchronous callbacks that don't set their own
+  /// (0 = wait forever). Any thread.
+  uint32_t DefaultTimeoutMs() const {
+    return defaultTimeoutMs_.load(std::memory_order_relaxed);
+  }
+  void SetDefaultTimeoutMs(uint32_t ms) {
+    defaultTimeoutMs_.store(ms, std::memory_order_relaxed);
+  }
+
+  /// Record how long a native thread waited for a synchronous callback.
+  /// Any thread.
+  void RecordWait(std::chrono::steady_clock::duration waited, bool timedOut);
+
+  /// Returns: { drains, yields, nested, lanes: { <name>: { posted,
+  ///   delivered, pending, maxPending } }, waits: { count, timeouts,
+  ///   histogram: [{ upToMs, count }] } }
+  Napi::Object Stats(Napi::Env env);
+
+  ~CallbackDispatcher();
+
+private:
+  struct LaneState {
+    std::deque<Task> queue;
+    uint64_t posted = 0;
+    uint64_t delivered = 0;
+    size_t maxPending = 0;
+  };
+
+  CallbackDispatcher() = default;
+
+  bool ScheduleDrainLocked();
+  std::deque<Task> TakeAllLocked();
+  void RunDrain(Napi::Env env);
+  void RunNested();
+  void WakeNested();
+
+  static void PerformNested(void *info);
+
+  static void Drain(Napi::Env env, Napi::Function,
+                    std::shared_ptr<CallbackDispatcher> *ref);
+  static void Finalize(Napi::Env, std::shared_ptr<CallbackDispatcher> *self,
+                       std::shared_ptr<CallbackDispatcher> *);
+
+  std::mutex mutex_;
+  std::array<LaneState, kCallbackLaneCount> lanes_;  // guarded by mutex_
+  bool drainScheduled_ = false;                      // guarded by mutex_
+  bool closed_ = false;                              // guarded by mutex_
+  uint64_t drains_ = 0;                              // guarded by mutex_
+  uint64_t yields_ = 0;                              // guarded by mutex_
+  size_t clients_ = 0;                               // guarded by mutex_
+  uint64_t nested_ = 0;                              // guarded by mutex_
+  Napi::ThreadSafeFunction tsfn_;
+
+  // Nested delivery: a run loop source on the JS thread, signalled for
+  // Blocking posts while nativeDepth_ > 0. blockingQueued_ mirrors the
+  // Blocking lane's length so EnterNativeCall need not take the mutex.
+  napi_env env_ = nullptr;
+  CFRunLoopRef runLoop_ = nullptr;
+  CFRunLoopSourceRef nestedSource_ = nullptr;
+  std::atomic<uint32_t> nativeDepth_{0};
+  std::atomic<size_t> blockingQueued_{0};
+
+  // Upper bounds (microseconds) of the wait histogram buckets; one more
+  // bucket counts everything slower.
+  static constexpr std::array<uint32_t, 9> kWaitBucketsUs = {
+      100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000};
+
+  std::atomic<uint32_t> defaultTimeoutMs_{0};
+  std::atomic<uint64_t> waits_{0};
+  std::atomic<uint64_t> timeouts_{0};
+  std::array<std::atomic<uint64_t>, kWaitBucketsUs.size() + 1> waitBuckets_{};
+};
+
+// MARK: - Native Call Scope
+
+/**
+ * Marks the JS thread as inside a native call for the scope's lifetime (see
+ * CallbackDispatcher). A no-op until the env's dispatcher exists.
+ */
+class NativeCallScope {
+public:
+  explicit NativeCallScope(Napi::Env env);
+  ~NativeCallScope() {
+    if (dispatcher_ != nullptr) {
+      dispatcher_->LeaveNativeCall();
+    }
+  }
+
+  NativeCallScope(const NativeCallScope &) = delete;
+  NativeCallScope &operator=(const NativeCallScope &) = delete;
+
+private:
+  CallbackDispatcher *dispatcher_;
+};
+
+} // namespace nobjc
+
+// MARK: - Exported Functions
+
+// Returns: CallbackDispatcher::Stats for this env
+Napi::Value GetCallbackDispatcherStats(const Napi::CallbackInfo &info);
+
+// Set the default deadline for synchronous cross-thread callbacks.
+// Arguments: timeoutMs (0 = wait forever)
+Napi::Value ConfigureCallbackTimeout(const Napi::CallbackInfo &info);
+
+#endif // CALLBACK_DISPATCHER_H
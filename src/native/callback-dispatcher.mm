@@ -0,0 +1,426 @@
+#include "callback-dispatcher.h"
+#include "ObjcObject.h"
+#include "constants.h"
+#include "debug.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <napi.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nobjc {
+
+// MARK: - Lanes
+
+const char *CallbackLaneName(CallbackLane lane) {
+  switch (lane) {
+    case CallbackLane::Blocking: return "blocking";
+    case CallbackLane::Interactive: return "interactive";
+    case CallbackLane::Background: return "background";
+  }
+  return "blocking";
+}
+
+CallbackLane CallbackLaneForFunction(const Napi::Function &fn,
+                                     CallbackLane fallback) {
+  Napi::Value value = fn.Get(kCallbackPriorityProperty);
+  if (!value.IsString()) {
+    return fallback;
+  }
+  std::string name = value.As<Napi::String>().Utf8Value();
+  for (size_t i = 0; i < kCallbackLaneCount; i++) {
+    CallbackLane lane = static_cast<CallbackLane>(i);
+    if (name == CallbackLaneName(lane)) {
+      return lane;
+    }
+  }
+  return fallback;
+}
+
+// MARK: - Borrow Scopes
+
+namespace {
+
+/**
+ * Hides the env's open borrowScope frames for the lifetime of the guard.
+ * A queued task can run while the JS thread is inside a borrowScope (nested
+ * delivery during a native call, or a drain inside it), but its arguments
+ * belong to the callback, not to that scope: JS may keep them, and the scope
+ * closing must not revoke them. Frames the task opens and leaves open are
+ * discarded when the outer ones are restored.
+ */
+class SuspendedBorrowScopes {
+public:
+  explicit SuspendedBorrowScopes(Napi::Env env)
+      : data_(env.GetInstanceData<NobjcEnvData>()) {
+    if (data_ != nullptr) {
+      std::swap(data_->borrowScopes, saved_);
+    }
+  }
+
+  ~SuspendedBorrowScopes() {
+    if (data_ != nullptr) {
+      std::swap(data_->borrowScopes, saved_);
+    }
+  }
+
+  SuspendedBorrowScopes(const SuspendedBorrowScopes &) = delete;
+  SuspendedBorrowScopes &operator=(const SuspendedBorrowScopes &) = delete;
+
+private:
+  NobjcEnvData *data_;
+  std::vector<std::unique_ptr<BorrowScope>> saved_;
+};
+
+} // namespace
+
+// MARK: - Dispatcher
+
+std::shared_ptr<CallbackDispatcher> CallbackDispatcher::ForEnv(Napi::Env env) {
+  NobjcEnvData *data = ObjcObject::GetEnvData(env);
+  if (data->callbackDispatcher) {
+    return data->callbackDispatcher;
+  }
+  std::shared_ptr<CallbackDispatcher> dispatcher(new CallbackDispatcher());
+  // The TSFN owns a reference so the dispatcher outlives every queued drain,
+  // however the env data and the TSFN are torn down relative to each other.
+  auto *owner = new std::shared_ptr<CallbackDispatcher>(dispatcher);
+  dispatcher->tsfn_ = Napi::ThreadSafeFunction::New(
+      env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}),
+      "CallbackDispatcher", 0, 1, owner, Finalize, owner);
+  dispatcher->tsfn_.Unref(env);
+
+  // ForEnv runs on the JS thread, so this is the run loop a native call
+  // made from JS would spin.
+  dispatcher->env_ = env;
+  dispatcher->runLoop_ = static_cast<CFRunLoopRef>(CFRetain(CFRunLoopGetCurrent()));
+  CFRunLoopSourceContext context = {};
+  context.info = dispatcher.get();
+  context.perform = PerformNested;
+  dispatcher->nestedSource_ = CFRunLoopSourceCreate(kCFAllocatorDefault, 0, &context);
+  CFRunLoopAddSource(dispatcher->runLoop_, dispatcher->nestedSource_,
+                     kCFRunLoopCommonModes);
+
+  data->callbackDispatcher = dispatcher;
+  return dispatcher;
+}
+
+CallbackDispatcher::~CallbackDispatcher() {
+  if (nestedSource_ != nullptr) {
+    CFRunLoopSourceInvalidate(nestedSource_);
+    CFRelease(nestedSource_);
+  }
+  if (runLoop_ != nullptr) {
+    CFRelease(runLoop_);
+  }
+}
+
+void CallbackDispatcher::Post(CallbackLane lane, Task task) {
+  std::deque<Task> cancelled;
+  bool queued = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!closed_) {
+      LaneState &state = lanes_[static_cast<size_t>(lane)];
+      state.queue.push_back(std::move(task));
+      state.posted++;
+      state.maxPending = std::max(state.maxPending, state.queue.size());
+      if (lane == CallbackLane::Blocking) {
+        blockingQueued_.fetch_add(1, std::memory_order_seq_cst);
+      }
+      if (drainScheduled_ || ScheduleDrainLocked()) {
+        queued = true;
+      } else {
+        closed_ = true;
+        cancelled = TakeAllLocked();
+      }
+    } else {
+      cancelled.push_back(std::move(task));
+    }
+  }
+  if (queued) {
+    // Pairs with EnterNativeCall: either we see the depth, or it sees the
+    // queued task.
+    if (lane == CallbackLane::Blocking &&
+        nativeDepth_.load(std::memory_order_seq_cst) > 0) {
+      WakeNested();
+    }
+    return;
+  }
+  for (Task &pending : cancelled) {
+    pending(Napi::Env(nullptr));
+  }
+}
+
+void CallbackDispatcher::EnterNativeCall() {
+  if (nativeDepth_.fetch_add(1, std::memory_order_seq_cst) == 0 &&
+      blockingQueued_.load(std::memory_order_seq_cst) > 0) {
+    WakeNested();
+  }
+}
+
+void CallbackDispatcher::WakeNested() {
+  CFRunLoopSourceSignal(nestedSource_);
+  CFRunLoopWakeUp(runLoop_);
+}
+
+void CallbackDispatcher::AddClient(Napi::Env env) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!closed_ && clients_++ == 0) {
+    tsfn_.Ref(env);
+  }
+}
+
+void CallbackDispatcher::RemoveClient(Napi::Env env) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (clients_ == 0) {
+    return;
+  }
+  if (--clients_ == 0 && !closed_) {
+    tsfn_.Unref(env);
+  }
+}
+
+void CallbackDispatcher::RecordWait(std::chrono::steady_clock::duration waited,
+                                    bool timedOut) {
+  const auto us =
+      std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+  size_t bucket = 0;
+  while (bucket < kWaitBucketsUs.size() &&
+         us > static_cast<int64_t>(kWaitBucketsUs[bucket])) {
+    bucket++;
+  }
+  waitBuckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  waits_.fetch_add(1, std::memory_order_relaxed);
+  if (timedOut) {
+    timeouts_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+Napi::Object CallbackDispatcher::Stats(Napi::Env env) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Napi::Object stats = Napi::Object::New(env);
+  stats.Set("drains", Napi::Number::New(env, static_cast<double>(drains_)));
+  stats.Set("yields", Napi::Number::New(env, static_cast<double>(yields_)));
+  stats.Set("nested", Napi::Number::New(env, static_cast<double>(nested_)));
+  Napi::Object lanes = Napi::Object::New(env);
+  for (size_t i = 0; i < kCallbackLaneCount; i++) {
+    const LaneState &state = lanes_[i];
+    Napi::Object lane = Napi::Object::New(env);
+    lane.Set("posted", Napi::Number::New(env, static_cast<double>(state.posted)));
+    lane.Set("delivered", Napi::Number::New(env, static_cast<double>(state.delivered)));
+    lane.Set("pending", Napi::Number::New(env, static_cast<double>(state.queue.size())));
+    lane.Set("maxPending", Napi::Number::New(env, static_cast<double>(state.maxPending)));
+    lanes.Set(CallbackLaneName(static_cast<CallbackLane>(i)), lane);
+  }
+  stats.Set("lanes", lanes);
+
+  Napi::Object waits = Napi::Object::New(env);
+  waits.Set("count", Napi::Number::New(env, static_cast<double>(waits_.load())));
+  waits.Set("timeouts", Napi::Number::New(env, static_cast<double>(timeouts_.load())));
+  Napi::Array histogram = Napi::Array::New(env, waitBuckets_.size());
+  for (size_t i = 0; i < waitBuckets_.size(); i++) {
+    Napi::Object bucket = Napi::Object::New(env);
+    bucket.Set("upToMs", i < kWaitBucketsUs.size()
+                             ? Napi::Number::New(env, kWaitBucketsUs[i] / 1000.0)
+                             : Napi::Number::New(env, INFINITY));
+    bucket.Set("count", Napi::Number::New(env, static_cast<double>(waitBuckets_[i].load())));
+    histogram.Set(static_cast<uint32_t>(i), bucket);
+  }
+  waits.Set("histogram", histogram);
+  stats.Set("waits", waits);
+  return stats;
+}
+
+bool CallbackDispatcher::ScheduleDrainLocked() {
+  auto *ref = new std::shared_ptr<CallbackDispatcher>(shared_from_this());
+  napi_status status = tsfn_.NonBlockingCall(ref, Drain);
+  if (status != napi_ok) {
+    NOBJC_ERROR("CallbackDispatcher: failed to schedule drain (status: %d)",
+                status);
+    delete ref;
+    drainScheduled_ = false;
+    return false;
+  }
+  drainScheduled_ = true;
+  return true;
+}
+
+std::deque<CallbackDispatcher::Task> CallbackDispatcher::TakeAllLocked() {
+  std::deque<Task> taken;
+  for (LaneState &state : lanes_) {
+    for (Task &task : state.queue) {
+      taken.push_back(std::move(task));
+    }
+    state.queue.clear();
+  }
+  blockingQueued_.store(0, std::memory_order_seq_cst);
+  return taken;
+}
+
+// Runs on the JS thread (or with a null env while the TSFN is torn down).
+void CallbackDispatcher::RunDrain(Napi::Env env) {
+  if (env == nullptr) {
+    std::deque<Task> cancelled;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      drainScheduled_ = false;
+      cancelled = TakeAllLocked();
+    }
+    for (Task &task : cancelled) {
+      task(env);
+    }
+    return;
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kCallbackDrainBudgetMs);
+  size_t ran = 0;
+  bool bounded = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drains_++;
+  }
+  for (;;) {
+    Task task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      LaneState *next = nullptr;
+      for (LaneState &state : lanes_) {
+        if (!state.queue.empty()) {
+          next = &state;
+          break;
+        }
+      }
+      if (next == nullptr) {
+        drainScheduled_ = false;
+        return;
+      }
+      // Always make progress, then yield to the event loop once the budget
+      // is spent. The next drain starts again from the Blocking lane.
+      if (bounded && ran > 0 && std::chrono::steady_clock::now() >= deadline) {
+        yields_++;
+        if (ScheduleDrainLocked()) {
+          return;
+        }
+        // The TSFN is closing; nothing else will drain, so finish here.
+        drainScheduled_ = true;
+        bounded = false;
+      }
+      task = std::move(next->queue.front());
+      next->queue.pop_front();
+      next->delivered++;
+      if (next == &lanes_[static_cast<size_t>(CallbackLane::Blocking)]) {
+        blockingQueued_.fetch_sub(1, std::memory_order_seq_cst);
+      }
+    }
+    try {
+      Napi::HandleScope scope(env);
+      SuspendedBorrowScopes borrowed(env);
+      task(env);
+    } catch (const Napi::Error &e) {
+      NOBJC_ERROR("CallbackDispatcher: error in callback: %s", e.what());
+    } catch (const std::exception &e) {
+      NOBJC_ERROR("CallbackDispatcher: exception in callback: %s", e.what());
+    }
+    ran++;
+  }
+}
+
+// Runs on the JS thread from the run loop source. Only the Blocking lane is
+// served here: those callers are parked, possibly on the very thread the
+// enclosing native call waits for, while notification batches can wait for
+// the regular drain.
+void CallbackDispatcher::RunNested() {
+  if (nativeDepth_.load(std::memory_order_seq_cst) == 0) {
+    return; // Not inside a native call; the TSFN drain will run
+  }
+  Napi::Env env(env_);
+  LaneState &state = lanes_[static_cast<size_t>(CallbackLane::Blocking)];
+  for (;;) {
+    Task task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_ || state.queue.empty()) {
+        return;
+      }
+      task = std::move(state.queue.front());
+      state.queue.pop_front();
+      state.delivered++;
+      nested_++;
+      blockingQueued_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    try {
+      Napi::HandleScope scope(env);
+      SuspendedBorrowScopes borrowed(env);
+      task(env);
+    } catch (const Napi::Error &e) {
+      NOBJC_ERROR("CallbackDispatcher: error in nested callback: %s", e.what());
+    } catch (const std::exception &e) {
+      NOBJC_ERROR("CallbackDispatcher: exception in nested callback: %s", e.what());
+    }
+  }
+}
+
+void CallbackDispatcher::PerformNested(void *info) {
+  static_cast<CallbackDispatcher *>(info)->RunNested();
+}
+
+void CallbackDispatcher::Drain(Napi::Env env, Napi::Function,
+                               std::shared_ptr<CallbackDispatcher> *ref) {
+  std::shared_ptr<CallbackDispatcher> self = std::move(*ref);
+  delete ref;
+  self->RunDrain(env);
+}
+
+void CallbackDispatcher::Finalize(Napi::Env,
+                                  std::shared_ptr<CallbackDispatcher> *self,
+                                  std::shared_ptr<CallbackDispatcher> *) {
+  std::deque<Task> cancelled;
+  {
+    std::lock_guard<std::mutex> lock((*self)->mutex_);
+    (*self)->closed_ = true;
+    cancelled = (*self)->TakeAllLocked();
+  }
+  // Finalize runs on the JS thread; stop nested delivery before the env goes
+  CFRunLoopSourceInvalidate((*self)->nestedSource_);
+  for (Task &task : cancelled) {
+    task(Napi::Env(nullptr));
+  }
+  delete self;
+}
+
+// MARK: - Native Call Scope
+
+NativeCallScope::NativeCallScope(Napi::Env env) : dispatcher_(nullptr) {
+  NobjcEnvData *data = env.GetInstanceData<NobjcEnvData>();
+  if (data != nullptr && data->callbackDispatcher) {
+    dispatcher_ = data->callbackDispatcher.get();
+    dispatcher_->EnterNativeCall();
+  }
+}
+
+} // namespace nobjc
+
+// MARK: - Exported Functions
+
+Napi::Value GetCallbackDispatcherStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  return nobjc::CallbackDispatcher::ForEnv(env)->Stats(env);
+}
+
+Napi::Value ConfigureCallbackTimeout(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected a timeout in milliseconds (number)");
+  }
+  double ms = info[0].As<Napi::Number>().DoubleValue();
+  if (!(ms >= 0) || ms > UINT32_MAX) {
+    throw Napi::RangeError::New(env, "Timeout must be between 0 and 2^32 - 1 ms");
+  }
+  nobjc::CallbackDispatcher::ForEnv(env)->SetDefaultTimeoutMs(
+      static_cast<uint32_t>(ms));
+  return env.Undefined();
+}
@@ -9,6 +9,7 @@
 //
 
 #include <cstddef>
+#include <cstdint>
 #include <CoreFoundation/CoreFoundation.h>
 
 namespace nobjc {
@@ -39,4 +40,67 @@ constexpr size_t kDefaultArgBufferSize = sizeof(void*);
 /// Size of pointer storage for out-parameters (e.g., NSError**).
 constexpr size_t kOutParamPointerSize = sizeof(void*);
 
+// MARK: - Stream Adapters
+
+/// Default number of bytes requested per read:maxLength: call.
+constexpr size_t kDefaultStreamChunkSize = 64 * 1024;
+
+/// Maximum number of idle chunk buffers kept for reuse per reader.
+constexpr size_t kStreamBufferPoolSize = 8;
+
+/// Upper bound, in seconds, on one run-loop wait in a stream reader thread.
+constexpr double kStreamReaderRunLoopSeconds = 1.0;
+
+// MARK: - Strings
+
+/// NSStrings with at least this many UTF-16 code units are handed to JS as
+/// external strings (sharing the NSString's storage) when the runtime
+/// supports it. Below this, copying is cheaper than the finalizer bookkeeping.
+constexpr long kExternalStringMinLength = 64 * 1024;
+
+/// Longest JS string (in UTF-16 code units) the NSString intern cache will
+/// hold. Interning targets keys and names; longer strings bypass it.
+constexpr size_t kStringInternMaxLength = 128;
+
+// MARK: - Parallel Send
+
+/// Receivers claimed by a worker at a time in ParallelSendMap. Each claim
+/// runs inside its own autorelease pool.
+constexpr size_t kParallelSendChunkSize = 64;
+
+// MARK: - Blocks
+
+/// Consecutive identical object/scalar classifications after which an
+/// untyped block parameter slot stops running the pointer heuristic.
+constexpr uint8_t kBlockArgMemoStreak = 8;
+
+// MARK: - Lazy Views
+
+/// Elements fetched per getObjects:range: call in a lazy collection view.
+constexpr size_t kLazyViewChunkSize = 64;
+
+/// Chunks a lazy view keeps (direct-mapped by chunk index). Each holds
+/// retains on its elements until evicted or the view is collected.
+constexpr size_t kLazyViewCacheChunks = 4;
+
+// MARK: - Callback Dispatcher
+
+/// Time (ms) one drain of the callback dispatcher may run JS callbacks
+/// before yielding to the event loop. At least one callback always runs.
+constexpr int kCallbackDrainBudgetMs = 4;
+
+// MARK: - Call Profiler
+
+/// Native-call frames recorded per thread; deeper frames are dropped.
+constexpr uint32_t kProfilerMaxDepth = 32;
+
+/// Highest sampling rate accepted by StartCallProfiler.
+constexpr uint32_t kProfilerMaxHz = 10000;
+
+// MARK: - Call Trace
+
+/// Records kept by one trace (10 bytes each); later calls are counted as
+/// dropped.
+constexpr size_t kTraceMaxRecords = 1 << 22;
+
 }  // namespace nobjc
@@ -0,0 +1,290 @@
+#ifndef FAST_MSGSEND_H
+#define FAST_MSGSEND_H
+
+/**
+ * @file fast-msgsend.h
+ * @brief Direct objc_msgSend casts shared by $msgSend, $msgSendPrepared and
+ * bound invocations.
+ *
+ * Arguments are converted to registers (or register-shaped structs) by the
+ * caller, and the send goes through a function-pointer cast with the exact
+ * signature, so the call follows the platform ABI without an NSInvocation.
+ */
+
+#include "ObjcObject.h"
+#include "bridge.h"
+#include "string-utils.h"
+#include "struct-registers.h"
+#include <Foundation/Foundation.h>
+#include <cstdint>
+#include <cstring>
+#include <napi.h>
+#include <objc/message.h>
+
+// MARK: - Register Conversion
+
+/**
+ * Check if a type code is eligible for the direct objc_msgSend fast path.
+ * All pointer-sized or smaller integer types, float, double, id, class, SEL,
+ * bool, and void are eligible. Structs, C strings, and pointers are not
+ * (structs need special handling, C strings need lifetime management).
+ */
+inline bool IsFastPathTypeCode(char typeCode) {
+  switch (typeCode) {
+    // Integer types (all fit in a register)
+    case 'c': case 'i': case 's': case 'l': case 'q':
+    case 'C': case 'I': case 'S': case 'L': case 'Q':
+    // Floating point
+    case 'f': case 'd':
+    // Bool
+    case 'B':
+    // Object types (pointer-sized)
+    case '@': case '#': case ':':
+    // Void (for return type only)
+    case 'v':
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Check if a type code is eligible as a fast-path argument.
+ * Slightly more restrictive than return types — excludes void.
+ */
+inline bool IsFastPathArgTypeCode(char typeCode) {
+  return typeCode != 'v' && IsFastPathTypeCode(typeCode);
+}
+
+/**
+ * Convert a JS value to a register-sized integer for passing to objc_msgSend.
+ * Handles id (@), Class (#), SEL (:), bool (B), and all integer types.
+ * Returns the value as a uintptr_t that can be passed in a general register.
+ */
+inline uintptr_t JSValueToRegister(Napi::Env env,
+                                   const Napi::Value &value,
+                                   char typeCode,
+                                   const ObjcArgumentContext &context) {
+  switch (typeCode) {
+    case '@': {
+      id obj = ConvertToNativeValue<id>(value, context);
+      return reinterpret_cast<uintptr_t>(obj);
+    }
+    case '#': {
+      // Class is also an id
+      id obj = ConvertToNativeValue<id>(value, context);
+      return reinterpret_cast<uintptr_t>(obj);
+    }
+    case ':': {
+      SEL sel = ConvertToNativeValue<SEL>(value, context);
+      return reinterpret_cast<uintptr_t>(sel);
+    }
+    case 'B': {
+      bool b = ConvertToNativeValue<bool>(value, context);
+      return static_cast<uintptr_t>(b ? 1 : 0);
+    }
+    case 'c': return static_cast<uintptr_t>(
+                   static_cast<unsigned char>(ConvertToNativeValue<char>(value, context)));
+    case 'i': return static_cast<uintptr_t>(
+                   static_cast<unsigned int>(ConvertToNativeValue<int>(value, context)));
+    case 's': return static_cast<uintptr_t>(
+                   static_cast<unsigned short>(ConvertToNativeValue<short>(value, context)));
+    case 'l': return static_cast<uintptr_t>(
+                   static_cast<unsigned long>(ConvertToNativeValue<long>(value, context)));
+    case 'q': return static_cast<uintptr_t>(ConvertToNativeValue<long long>(value, context));
+    case 'C': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned char>(value, context));
+    case 'I': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned int>(value, context));
+    case 'S': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned short>(value, context));
+    case 'L': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned long>(value, context));
+    case 'Q': return static_cast<uintptr_t>(ConvertToNativeValue<unsigned long long>(value, context));
+    default:
+      throw Napi::TypeError::New(env, "Unsupported fast-path argument type");
+  }
+}
+
+/**
+ * Convert a raw objc_msgSend integer return value to a JS value.
+ */
+inline Napi::Value RegisterToJSValue(Napi::Env env, uintptr_t raw,
+                                     char typeCode) {
+  switch (typeCode) {
+    case 'v': return env.Undefined();
+    case '@': case '#': {
+      id obj = reinterpret_cast<id>(raw);
+      if (obj == nil) return env.Null();
+      return ObjcObject::NewInstance(env, obj);
+    }
+    case ':': {
+      SEL sel = reinterpret_cast<SEL>(raw);
+      if (sel == nullptr) return env.Null();
+      return CStringToJS(env, sel_getName(sel));
+    }
+    case 'B': return Napi::Boolean::New(env, raw != 0);
+    case 'c': return Napi::Number::New(env, static_cast<double>(static_cast<char>(raw)));
+    case 'i': return Napi::Number::New(env, static_cast<double>(static_cast<int>(raw)));
+    case 's': return Napi::Number::New(env, static_cast<double>(static_cast<short>(raw)));
+    case 'l': return Napi::Number::New(env, static_cast<double>(static_cast<long>(raw)));
+    case 'q': return Napi::Number::New(env, static_cast<double>(static_cast<long long>(raw)));
+    case 'C': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned char>(raw)));
+    case 'I': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned int>(raw)));
+    case 'S': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned short>(raw)));
+    case 'L': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned long>(raw)));
+    case 'Q': return Napi::Number::New(env, static_cast<double>(static_cast<unsigned long long>(raw)));
+    default:  return env.Undefined();
+  }
+}
+
+// MARK: - Register Sends
+
+/**
+ * Send with 0-3 integer-register args already converted to registers, and a
+ * fast-path return (integer, pointer, float, double or void).
+ */
+inline Napi::Value MsgSendRegisters(Napi::Env env, id target, SEL selector,
+                                    const uintptr_t *args, size_t argCount,
+                                    char returnTypeCode) {
+  if (returnTypeCode == 'f') {
+    float result = 0;
+    switch (argCount) {
+      case 0:
+        result = ((float(*)(id, SEL))objc_msgSend)(target, selector);
+        break;
+      case 1:
+        result = ((float(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
+        break;
+      case 2:
+        result = ((float(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
+            target, selector, args[0], args[1]);
+        break;
+      case 3:
+        result = ((float(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
+            target, selector, args[0], args[1], args[2]);
+        break;
+    }
+    return Napi::Number::New(env, static_cast<double>(result));
+  }
+  if (returnTypeCode == 'd') {
+    double result = 0;
+    switch (argCount) {
+      case 0:
+        result = ((double(*)(id, SEL))objc_msgSend)(target, selector);
+        break;
+      case 1:
+        result = ((double(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
+        break;
+      case 2:
+        result = ((double(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
+            target, selector, args[0], args[1]);
+        break;
+      case 3:
+        result = ((double(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
+            target, selector, args[0], args[1], args[2]);
+        break;
+    }
+    return Napi::Number::New(env, result);
+  }
+  uintptr_t result = 0;
+  switch (argCount) {
+    case 0:
+      result = ((uintptr_t(*)(id, SEL))objc_msgSend)(target, selector);
+      break;
+    case 1:
+      result = ((uintptr_t(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
+      break;
+    case 2:
+      result = ((uintptr_t(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
+          target, selector, args[0], args[1]);
+      break;
+    case 3:
+      result = ((uintptr_t(*)(id, SEL, uintptr_t, uintptr_t, uintptr_t))objc_msgSend)(
+          target, selector, args[0], args[1], args[2]);
+      break;
+  }
+  return RegisterToJSValue(env, result, returnTypeCode);
+}
+
+/**
+ * Send with a single float or double argument (numberWithDouble:,
+ * setAlphaValue:) and a fast-path return.
+ */
+template <typename Arg>
+Napi::Value MsgSendFloatArgument(Napi::Env env, id target, SEL selector,
+                                 Arg arg0, char returnTypeCode) {
+  if (returnTypeCode == 'd') {
+    return Napi::Number::New(
+        env, ((double(*)(id, SEL, Arg))objc_msgSend)(target, selector, arg0));
+  }
+  if (returnTypeCode == 'f') {
+    return Napi::Number::New(env, static_cast<double>(((float(*)(id, SEL, Arg))objc_msgSend)(
+                                      target, selector, arg0)));
+  }
+  return RegisterToJSValue(
+      env, ((uintptr_t(*)(id, SEL, Arg))objc_msgSend)(target, selector, arg0),
+      returnTypeCode);
+}
+
+// MARK: - Register-Passed Structs
+
+/**
+ * Send with a struct return that fits in registers and 0-2 integer-register
+ * args. The result bytes are copied from the shape into `out`, which must
+ * hold sizeof(Shape) bytes. On x86_64, aggregates over 16 bytes are returned
+ * in memory and go through objc_msgSend_stret.
+ */
+template <typename Shape>
+void MsgSendStructReturn(id target, SEL selector, const uintptr_t *args,
+                         size_t argCount, void *out) {
+#if defined(__x86_64__)
+  if constexpr (sizeof(Shape) > 16) {
+    switch (argCount) {
+      case 0:
+        ((void(*)(void *, id, SEL))objc_msgSend_stret)(out, target, selector);
+        break;
+      case 1:
+        ((void(*)(void *, id, SEL, uintptr_t))objc_msgSend_stret)(
+            out, target, selector, args[0]);
+        break;
+      case 2:
+        ((void(*)(void *, id, SEL, uintptr_t, uintptr_t))objc_msgSend_stret)(
+            out, target, selector, args[0], args[1]);
+        break;
+    }
+    return;
+  }
+#endif
+  Shape result;
+  switch (argCount) {
+    case 0:
+      result = ((Shape(*)(id, SEL))objc_msgSend)(target, selector);
+      break;
+    case 1:
+      result = ((Shape(*)(id, SEL, uintptr_t))objc_msgSend)(target, selector, args[0]);
+      break;
+    default:
+      result = ((Shape(*)(id, SEL, uintptr_t, uintptr_t))objc_msgSend)(
+          target, selector, args[0], args[1]);
+      break;
+  }
+  memcpy(out, &result, sizeof(Shape));
+}
+
+/**
+ * Send with a register-passed struct as the first argument, an optional
+ * integer-register second argument, and a non-struct return. Returns the
+ * raw return through the matching register class.
+ */
+template <typename Shape, typename Return>
+Return MsgSendStructArgument(id target, SEL selector, const Shape &arg0,
+                             bool hasArg1, uintptr_t arg1) {
+  if (hasArg1) {
+    return ((Return(*)(id, SEL, Shape, uintptr_t))objc_msgSend)(
+        target, selector, arg0, arg1);
+  }
+  return ((Return(*)(id, SEL, Shape))objc_msgSend)(target, selector, arg0);
+}
+
+inline bool IsIntegerRegisterTypeCode(char typeCode) {
+  return IsFastPathArgTypeCode(typeCode) && typeCode != 'f' && typeCode != 'd';
+}
+
+#endif // FAST_MSGSEND_H
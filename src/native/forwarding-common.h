@@ -1,6 +1,7 @@
 #ifndef FORWARDING_COMMON_H
 #define FORWARDING_COMMON_H
 
+#include "callback-dispatcher.h"
 #include "memory-utils.h"
 #include "protocol-storage.h"
 #include "constants.h"
@@ -8,6 +9,7 @@
 #include <cstring>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <napi.h>
 #include <optional>
@@ -80,9 +82,16 @@ struct ForwardingContext {
   // It remains valid as long as the implementation exists.
   Napi::FunctionReference* cachedJsCallback;
 
+  // Cross-thread calls are posted here, on the method's lane
+  std::shared_ptr<nobjc::CallbackDispatcher> dispatcher;
+  nobjc::CallbackLane lane;
+  // How long a cross-thread caller waits before returning a default
+  CallbackDeadline deadline;
+
   ForwardingContext()
       : js_thread(0), env(nullptr), skipDirectCallForElectron(false),
-        instancePtr(nullptr), superClassPtr(nullptr), cachedJsCallback(nullptr) {}
+        instancePtr(nullptr), superClassPtr(nullptr), cachedJsCallback(nullptr),
+        lane(nobjc::CallbackLane::Blocking) {}
 };
 
 /**
@@ -114,21 +123,20 @@ struct ForwardingCallbacks {
 // MARK: - Shared Helpers
 
 /**
- * Pump the CFRunLoop until a completion flag is set.
- * Used by protocol forwarding, subclass forwarding, and block invocation
- * to wait for cross-thread JS callbacks to complete.
+ * Pump the CFRunLoop until a callback has completed, with no deadline.
+ * Used by the ThreadSafeFunction paths (Electron and direct-call fallback);
+ * dispatcher posts wait in WaitForCallback instead.
  *
- * @param mutex      Mutex protecting the isComplete flag
- * @param isComplete Flag set to true when the JS callback completes
+ * @param completion State shared with the queued callback
  * @param label      Optional label for debug logging (nullptr to disable)
  */
-inline void PumpRunLoopUntilComplete(std::mutex &mutex, bool &isComplete,
+inline void PumpRunLoopUntilComplete(CallCompletion &completion,
                                      const char *label = nullptr) {
   int iterations = 0;
   while (true) {
     {
-      std::unique_lock<std::mutex> lock(mutex);
-      if (isComplete) break;
+      std::unique_lock<std::mutex> lock(completion.mutex);
+      if (completion.state == CallCompletion::State::Done) break;
     }
     iterations++;
     if (label && iterations % nobjc::kRunLoopDebugLogInterval == 0) {
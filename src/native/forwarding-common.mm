@@ -1,10 +1,12 @@
 #include "forwarding-common.h"
+#include "call-trace.h"
 #include "constants.h"
 #include "debug.h"
 #include "method-forwarding.h"
 #include <Foundation/Foundation.h>
 #include <atomic>
 #include <chrono>
+#include <vector>
 
 // MARK: - ForwardInvocationCommon Implementation
 
@@ -25,6 +27,10 @@ void ForwardInvocationCommon(NSInvocation *invocation,
 
   // Check if we're on the JS thread
   bool is_js_thread = pthread_equal(pthread_self(), ctx.js_thread);
+  nobjc::TraceMethodCall(is_js_thread ? nobjc::TraceKind::Callback
+                                      : nobjc::TraceKind::CrossThreadCallback,
+                         object_getClass([invocation target]), selector,
+                         [&] { return [invocation methodSignature]; });
 
   // Create invocation data with RAII guard
   auto data = new InvocationData();
@@ -52,10 +58,6 @@ void ForwardInvocationCommon(NSInvocation *invocation,
     // Release the TSFN since we're calling directly
     ctx.tsfn.Release();
 
-    data->completionMutex = nullptr;
-    data->completionCv = nullptr;
-    data->isComplete = nullptr;
-
     try {
       Napi::Env callEnv(ctx.env);
       Napi::HandleScope scope(callEnv);
@@ -109,34 +111,61 @@ void ForwardInvocationCommon(NSInvocation *invocation,
       // If we get here, fallbackGuard cleans up
     }
   } else {
-    // Cross-thread call via TSFN (or Electron forcing TSFN)
-    NOBJC_LOG("ForwardInvocationCommon: Using TSFN+runloop path for selector %s",
-              selectorCStr);
-
-    std::mutex completionMutex;
-    std::condition_variable completionCv;
-    bool isComplete = false;
-
-    data->completionMutex = &completionMutex;
-    data->completionCv = &completionCv;
-    data->isComplete = &isComplete;
-
-    // Transfer ownership to TSFN callback
-    status = ctx.tsfn.NonBlockingCall(dataGuard.release(), CallJSCallback);
-    ctx.tsfn.Release();
+    // Cross-thread call via the dispatcher (or Electron forcing TSFN)
+    NOBJC_LOG("ForwardInvocationCommon: Using %s+runloop path for selector %s",
+              is_js_thread ? "TSFN" : "dispatcher", selectorCStr);
+
+    auto completion = std::make_shared<CallCompletion>();
+    data->completion = completion;
+
+    if (is_js_thread || !ctx.dispatcher) {
+      // Electron on the JS thread: the TSFN call lands via the runloop pump
+      // below, so it cannot wait in the dispatcher's queue.
+      status = ctx.tsfn.NonBlockingCall(dataGuard.release(), CallJSCallback);
+      ctx.tsfn.Release();
+
+      if (status != napi_ok) {
+        NOBJC_ERROR("Failed to call ThreadSafeFunction for selector %s (status: %d)",
+                    selectorCStr, status);
+        // We already released from guard, so clean up manually
+        [invocation release];
+        delete data;
+        return;
+      }
 
-    if (status != napi_ok) {
-      NOBJC_ERROR("Failed to call ThreadSafeFunction for selector %s (status: %d)",
-                  selectorCStr, status);
-      // We already released from guard, so clean up manually
-      [invocation release];
-      delete data;
-      return;
+      // Wait for callback by pumping CFRunLoop
+      PumpRunLoopUntilComplete(*completion, "ForwardInvocationCommon");
+    } else {
+      ctx.tsfn.Release();
+      // Once claimed, the task is waited for, so it can borrow `callbacks`.
+      // The function is looked up again on the JS thread in case the
+      // implementation was disposed meanwhile. A task whose waiter timed out
+      // fails to claim and only releases the invocation.
+      InvocationData *owned = dataGuard.release();
+      const ForwardingCallbacks *callbacksPtr = &callbacks;
+      ctx.dispatcher->Post(ctx.lane, [owned, callbacksPtr, lookupKey,
+                                      selector](Napi::Env env) {
+        Napi::Function jsFn;
+        if (env != nullptr && owned->completion->Claim()) {
+          jsFn = callbacksPtr->getJSFunction(lookupKey, selector, env);
+        }
+        CallJSCallback(env, jsFn, owned); // signals completion either way
+      });
+
+      if (!WaitForCallback(*completion, *ctx.dispatcher,
+                           ctx.deadline.Resolve(*ctx.dispatcher))) {
+        // The JS thread never started the callback. Our own retain keeps the
+        // invocation alive until the queued task releases it.
+        NSUInteger length = [[invocation methodSignature] methodReturnLength];
+        if (length > 0) {
+          std::vector<uint8_t> value(length);
+          ctx.deadline.ApplyTo(value.data(), length);
+          [invocation setReturnValue:value.data()];
+        }
+        NOBJC_WARN("Callback for %s timed out; returned the default value",
+                   selectorCStr);
+      }
     }
-
-    // Wait for callback by pumping CFRunLoop
-    PumpRunLoopUntilComplete(completionMutex, isComplete,
-                            "ForwardInvocationCommon");
     // Data cleaned up in callback
   }
 
@@ -0,0 +1,39 @@
+#ifndef FOUNDATION_VALUES_H
+#define FOUNDATION_VALUES_H
+
+#include "ObjcObject.h"
+#include "string-utils.h"
+#include <CoreFoundation/CoreFoundation.h>
+#include <Foundation/Foundation.h>
+#include <napi.h>
+
+// MARK: - Foundation Value -> JS Conversion
+
+/**
+ * Convert a Foundation object to the most natural JS value.
+ *
+ * Used where the bridge unpacks values natively instead of handing JS a
+ * container to walk with individual sends (KVO change dictionaries,
+ * notification userInfo, collection views):
+ *   nil / NSNull  -> null
+ *   NSNumber      -> boolean (for CFBoolean) or number
+ *   NSString      -> string
+ *   anything else -> ObjcObject wrapper
+ */
+inline Napi::Value FoundationValueToJS(Napi::Env env, id value) {
+  if (value == nil || value == [NSNull null]) {
+    return env.Null();
+  }
+  if ([value isKindOfClass:[NSString class]]) {
+    return NSStringToJS(env, (NSString *)value);
+  }
+  if ([value isKindOfClass:[NSNumber class]]) {
+    if (CFGetTypeID((CFTypeRef)value) == CFBooleanGetTypeID()) {
+      return Napi::Boolean::New(env, [(NSNumber *)value boolValue]);
+    }
+    return Napi::Number::New(env, [(NSNumber *)value doubleValue]);
+  }
+  return ObjcObject::NewInstance(env, value);
+}
+
+#endif // FOUNDATION_VALUES_H
@@ -0,0 +1,251 @@
+#ifndef IMAGE_RANGE_INDEX_H
+#define IMAGE_RANGE_INDEX_H
+
+/**
+ * @file image-range-index.h
+ * @brief Lock-free "is this address inside a loaded image" queries.
+ *
+ * The block argument heuristic needs to know whether a pointer-sized value
+ * points into a mapped image (constant objects such as __NSArray0 live in the
+ * dyld shared cache, not the malloc heap). dladdr answers that, but it takes
+ * the dyld lock and searches images on every call.
+ *
+ * ImageRangeIndex keeps the readable segments of every loaded image as a
+ * sorted array of merged [start, end) intervals:
+ *
+ * - macOS: maintained by _dyld_register_func_for_add_image /
+ *   _dyld_register_func_for_remove_image, so it is always current.
+ * - Linux: built from dl_iterate_phdr. There are no load callbacks, so
+ *   Refresh() re-enumerates when the loader's add/remove counters changed.
+ *
+ * Writers rebuild the array under a mutex and publish it through an atomic
+ * pointer. Readers load the pointer and binary-search it without locking.
+ * Replaced snapshots are retired rather than freed, because a reader may
+ * still be searching one; that costs a few KB per image load or unload,
+ * which are rare after startup.
+ *
+ * This header is plain C++ with no Objective-C or N-API dependencies so it can
+ * be unit-benchmarked on any platform (see benchmarks/native/).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#include <mach-o/loader.h>
+#include <mach/vm_prot.h>
+#elif defined(__linux__)
+#include <link.h>
+#endif
+
+namespace nobjc {
+
+class ImageRangeIndex {
+public:
+  /// The process-wide index, created (and on macOS, subscribed to dyld) on
+  /// first use.
+  static ImageRangeIndex &Shared() {
+    static ImageRangeIndex *index = [] {
+      auto *created = new ImageRangeIndex();
+      instance_.store(created, std::memory_order_release);
+      created->Start();
+      return created;
+    }();
+    return *index;
+  }
+
+  /// True if `address` falls inside a readable segment of a loaded image.
+  bool Contains(const void *address) const {
+    const Snapshot *snapshot = snapshot_.load(std::memory_order_acquire);
+    const uintptr_t value = reinterpret_cast<uintptr_t>(address);
+    const std::vector<uintptr_t> &starts = snapshot->starts;
+    auto it = std::upper_bound(starts.begin(), starts.end(), value);
+    if (it == starts.begin()) {
+      return false;
+    }
+    const size_t slot = static_cast<size_t>(it - starts.begin()) - 1;
+    return value < snapshot->ends[slot];
+  }
+
+  /// Number of merged intervals in the current snapshot.
+  size_t RangeCount() const {
+    return snapshot_.load(std::memory_order_acquire)->starts.size();
+  }
+
+  /**
+   * Pick up images loaded or unloaded since the last refresh. A no-op on
+   * macOS, where dyld callbacks keep the index current.
+   */
+  void Refresh() {
+#if defined(__linux__)
+    std::lock_guard<std::mutex> lock(mutex_);
+    RescanLocked();
+#endif
+  }
+
+private:
+  struct Segment {
+    uintptr_t start;
+    uintptr_t end;
+    const void *image;
+  };
+
+  struct Snapshot {
+    std::vector<uintptr_t> starts;
+    std::vector<uintptr_t> ends;
+  };
+
+  ImageRangeIndex() {
+    retired_.push_back(std::make_unique<Snapshot>());
+    snapshot_.store(retired_.back().get(), std::memory_order_release);
+  }
+
+  // Sort, merge touching intervals and publish. Caller holds mutex_.
+  void PublishLocked() {
+    std::vector<Segment> sorted = segments_;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Segment &a, const Segment &b) { return a.start < b.start; });
+    auto snapshot = std::make_unique<Snapshot>();
+    for (const Segment &segment : sorted) {
+      if (!snapshot->ends.empty() && segment.start <= snapshot->ends.back()) {
+        snapshot->ends.back() = std::max(snapshot->ends.back(), segment.end);
+      } else {
+        snapshot->starts.push_back(segment.start);
+        snapshot->ends.push_back(segment.end);
+      }
+    }
+    snapshot_.store(snapshot.get(), std::memory_order_release);
+    retired_.push_back(std::move(snapshot));
+  }
+
+#if defined(__APPLE__)
+  void Start() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      registering_ = true;
+    }
+    // Registration calls the add hook once per already-loaded image on this
+    // thread. Those calls only record segments; one publish follows.
+    _dyld_register_func_for_add_image(OnAddImage);
+    _dyld_register_func_for_remove_image(OnRemoveImage);
+    std::lock_guard<std::mutex> lock(mutex_);
+    registering_ = false;
+    PublishLocked();
+  }
+
+  static void OnAddImage(const struct mach_header *header, intptr_t slide) {
+    ImageRangeIndex *index = instance_.load(std::memory_order_acquire);
+    if (header->magic != MH_MAGIC_64) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(index->mutex_);
+    const auto *header64 = reinterpret_cast<const mach_header_64 *>(header);
+    const uint8_t *cursor = reinterpret_cast<const uint8_t *>(header64 + 1);
+    for (uint32_t i = 0; i < header64->ncmds; i++) {
+      const auto *command = reinterpret_cast<const load_command *>(cursor);
+      if (command->cmd == LC_SEGMENT_64) {
+        const auto *segment = reinterpret_cast<const segment_command_64 *>(command);
+        // Skips __PAGEZERO and any other unreadable reservation.
+        if (segment->vmsize != 0 && (segment->initprot & VM_PROT_READ) != 0) {
+          const uintptr_t start = static_cast<uintptr_t>(segment->vmaddr + slide);
+          index->segments_.push_back(
+              {start, start + static_cast<uintptr_t>(segment->vmsize), header});
+        }
+      }
+      cursor += command->cmdsize;
+    }
+    if (!index->registering_) {
+      index->PublishLocked();
+    }
+  }
+
+  static void OnRemoveImage(const struct mach_header *header, intptr_t) {
+    ImageRangeIndex *index = instance_.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(index->mutex_);
+    auto &segments = index->segments_;
+    segments.erase(std::remove_if(segments.begin(), segments.end(),
+                                  [header](const Segment &segment) {
+                                    return segment.image == header;
+                                  }),
+                   segments.end());
+    index->PublishLocked();
+  }
+
+  bool registering_ = false;
+#elif defined(__linux__)
+  void Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RescanLocked();
+  }
+
+  // Re-enumerate every image if the loader's add/remove counters moved. The
+  // counters are read from the first callback, so an unchanged process stops
+  // after one image.
+  void RescanLocked() {
+    struct Scan {
+      ImageRangeIndex *index;
+      std::vector<Segment> segments;
+      unsigned long long adds = 0;
+      unsigned long long subs = 0;
+      bool unchanged = false;
+    } scan{this, {}};
+    dl_iterate_phdr(
+        [](dl_phdr_info *info, size_t size, void *context) -> int {
+          auto *scan = static_cast<Scan *>(context);
+          if (scan->segments.empty() &&
+              size >= offsetof(dl_phdr_info, dlpi_subs) + sizeof(info->dlpi_subs)) {
+            scan->adds = info->dlpi_adds;
+            scan->subs = info->dlpi_subs;
+            if (scan->index->scanned_ && scan->adds == scan->index->adds_ &&
+                scan->subs == scan->index->subs_) {
+              scan->unchanged = true;
+              return 1;
+            }
+          }
+          for (ElfW(Half) i = 0; i < info->dlpi_phnum; i++) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_LOAD || phdr.p_memsz == 0 ||
+                (phdr.p_flags & PF_R) == 0) {
+              continue;
+            }
+            const uintptr_t start = info->dlpi_addr + phdr.p_vaddr;
+            scan->segments.push_back({start, start + phdr.p_memsz,
+                                      reinterpret_cast<const void *>(info->dlpi_addr)});
+          }
+          return 0;
+        },
+        &scan);
+    if (scan.unchanged) {
+      return;
+    }
+    scanned_ = true;
+    adds_ = scan.adds;
+    subs_ = scan.subs;
+    segments_ = std::move(scan.segments);
+    PublishLocked();
+  }
+
+  bool scanned_ = false;
+  unsigned long long adds_ = 0;
+  unsigned long long subs_ = 0;
+#else
+  void Start() {}
+#endif
+
+  static inline std::atomic<ImageRangeIndex *> instance_{nullptr};
+
+  std::mutex mutex_;
+  std::vector<Segment> segments_;                 // guarded by mutex_
+  std::vector<std::unique_ptr<Snapshot>> retired_; // guarded by mutex_
+  std::atomic<const Snapshot *> snapshot_{nullptr};
+};
+
+} // namespace nobjc
+
+#endif // IMAGE_RANGE_INDEX_H
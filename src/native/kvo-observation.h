@@ -0,0 +1,22 @@
+#ifndef KVO_OBSERVATION_H
+#define KVO_OBSERVATION_H
+
+#include <napi.h>
+
+// MARK: - Public API
+
+// Start observing a key path with a native KVO observer.
+// Arguments:
+//   - target (ObjcObject): The object to observe (retained until stopped)
+//   - keyPath (string): The key path to observe
+//   - options (number): NSKeyValueObservingOptions bitmask
+//   - coalesceMs (number): Merge bursts of changes within this window (0 = off)
+//   - callback (function): Receives an array of change records per batch
+// Returns: An opaque subscription handle for StopObserving
+Napi::Value ObserveKeyPath(const Napi::CallbackInfo &info);
+
+// Remove the observer registered by ObserveKeyPath. Idempotent.
+// Arguments: handle
+Napi::Value StopObserving(const Napi::CallbackInfo &info);
+
+#endif // KVO_OBSERVATION_H
@@ -0,0 +1,224 @@
+#include "kvo-observation.h"
+#include "batch-delivery.h"
+#include "debug.h"
+#include "foundation-values.h"
+#include "ObjcObject.h"
+#include <Foundation/Foundation.h>
+#include <memory>
+#include <napi.h>
+
+// MARK: - Change Records
+
+// One KVO change, extracted natively from the change dictionary.
+// Object members are retained while the record is queued.
+struct KVORecord {
+  NSUInteger kind = NSKeyValueChangeSetting;
+  id newValue = nil;
+  id oldValue = nil;
+  id indexes = nil;
+  bool hasNew = false;
+  bool hasOld = false;
+  bool isPrior = false;
+  uint32_t count = 1;
+};
+
+static void DisposeKVORecord(KVORecord &record) {
+  if (record.newValue) objc_release(record.newValue);
+  if (record.oldValue) objc_release(record.oldValue);
+  if (record.indexes) objc_release(record.indexes);
+  record.newValue = nil;
+  record.oldValue = nil;
+  record.indexes = nil;
+}
+
+static Napi::Value KVORecordToJS(Napi::Env env, KVORecord &record) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("kind", Napi::Number::New(env, record.kind));
+  if (record.hasNew) {
+    obj.Set("newValue", FoundationValueToJS(env, record.newValue));
+  }
+  if (record.hasOld) {
+    obj.Set("oldValue", FoundationValueToJS(env, record.oldValue));
+  }
+  if (record.indexes) {
+    obj.Set("indexes", ObjcObject::NewInstance(env, record.indexes));
+  }
+  obj.Set("isPrior", Napi::Boolean::New(env, record.isPrior));
+  obj.Set("count", Napi::Number::New(env, record.count));
+  return obj;
+}
+
+// Coalescing: a pending "setting" change absorbs the next one by taking its
+// new value while keeping the original old value. Collection mutations and
+// prior notifications are never merged since their indexes/phases differ.
+static bool MergeSettingChanges(KVORecord &last, KVORecord &incoming) {
+  if (last.kind != NSKeyValueChangeSetting ||
+      incoming.kind != NSKeyValueChangeSetting || last.isPrior ||
+      incoming.isPrior) {
+    return false;
+  }
+  std::swap(last.newValue, incoming.newValue);
+  last.hasNew = last.hasNew || incoming.hasNew;
+  last.count += incoming.count;
+  return true;
+}
+
+using KVODelivery = BatchDelivery<KVORecord>;
+
+// Unique context pointer so we only handle our own registrations.
+static void *const kNobjcKVOContext = (void *)&kNobjcKVOContext;
+
+// MARK: - Native Observer
+
+@interface NobjcKVOObserver : NSObject {
+@public
+  std::shared_ptr<KVODelivery> delivery;
+  bool coalesce;
+}
+@end
+
+@implementation NobjcKVOObserver
+
+- (void)observeValueForKeyPath:(NSString *)keyPath
+                      ofObject:(id)object
+                        change:(NSDictionary *)change
+                       context:(void *)context {
+  if (context != kNobjcKVOContext) {
+    [super observeValueForKeyPath:keyPath
+                         ofObject:object
+                           change:change
+                          context:context];
+    return;
+  }
+  @autoreleasepool {
+    KVORecord record;
+    record.kind =
+        [[change objectForKey:NSKeyValueChangeKindKey] unsignedIntegerValue];
+    id newValue = [change objectForKey:NSKeyValueChangeNewKey];
+    if (newValue) {
+      record.hasNew = true;
+      record.newValue = objc_retain(newValue);
+    }
+    id oldValue = [change objectForKey:NSKeyValueChangeOldKey];
+    if (oldValue) {
+      record.hasOld = true;
+      record.oldValue = objc_retain(oldValue);
+    }
+    id indexes = [change objectForKey:NSKeyValueChangeIndexesKey];
+    if (indexes) {
+      record.indexes = objc_retain(indexes);
+    }
+    record.isPrior = [[change
+        objectForKey:NSKeyValueChangeNotificationIsPriorKey] boolValue];
+
+    if (coalesce) {
+      delivery->Enqueue(std::move(record), MergeSettingChanges);
+    } else {
+      delivery->Enqueue(std::move(record));
+    }
+  }
+}
+
+@end
+
+// MARK: - Subscription
+
+struct KVOSubscription {
+  id target = nil;
+  NSString *keyPath = nil;
+  NobjcKVOObserver *observer = nil;
+  std::shared_ptr<KVODelivery> delivery;
+
+  void Stop() {
+    if (observer == nil) {
+      return;
+    }
+    @autoreleasepool {
+      @try {
+        [target removeObserver:observer
+                    forKeyPath:keyPath
+                       context:kNobjcKVOContext];
+      } @catch (NSException *exception) {
+        NOBJC_WARN("StopObserving: removeObserver failed: %s",
+                   [[exception reason] UTF8String]);
+      }
+    }
+    delivery->Stop();
+    [observer release];
+    [keyPath release];
+    objc_release(target);
+    observer = nil;
+    keyPath = nil;
+    target = nil;
+  }
+};
+
+// MARK: - Exported Functions
+
+Napi::Value ObserveKeyPath(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 5 || !info[0].IsObject() || !info[1].IsString() ||
+      !info[2].IsNumber() || !info[3].IsNumber() || !info[4].IsFunction()) {
+    throw Napi::TypeError::New(
+        env, "Expected (target, keyPath, options, coalesceMs, callback)");
+  }
+  Napi::Object targetObj = info[0].As<Napi::Object>();
+  if (!ObjcObject::IsInstance(env, targetObj)) {
+    throw Napi::TypeError::New(env, "Target must be an ObjcObject instance");
+  }
+  id target = ObjcObject::UnwrapObject(env, targetObj);
+  if (target == nil) {
+    throw Napi::TypeError::New(env, "Cannot observe a nil object");
+  }
+
+  std::string keyPath = info[1].As<Napi::String>().Utf8Value();
+  NSKeyValueObservingOptions options =
+      (NSKeyValueObservingOptions)info[2].As<Napi::Number>().Uint32Value();
+  double coalesceMs = info[3].As<Napi::Number>().DoubleValue();
+  uint32_t delayMs = coalesceMs > 0 ? static_cast<uint32_t>(coalesceMs) : 0;
+
+  auto *subscription = new KVOSubscription();
+  subscription->delivery =
+      KVODelivery::Create(env, info[4].As<Napi::Function>(), delayMs,
+                          KVORecordToJS, DisposeKVORecord);
+
+  NobjcKVOObserver *observer = [[NobjcKVOObserver alloc] init];
+  observer->delivery = subscription->delivery;
+  observer->coalesce = delayMs > 0;
+
+  subscription->target = objc_retain(target);
+  subscription->keyPath =
+      [[NSString alloc] initWithUTF8String:keyPath.c_str()];
+  subscription->observer = observer;
+
+  @try {
+    [target addObserver:observer
+             forKeyPath:subscription->keyPath
+                options:options
+                context:kNobjcKVOContext];
+  } @catch (NSException *exception) {
+    std::string reason = [[exception reason] UTF8String] ?: "unknown";
+    subscription->delivery->Stop();
+    [observer release];
+    [subscription->keyPath release];
+    objc_release(target);
+    delete subscription;
+    throw Napi::Error::New(env, "Failed to observe key path '" + keyPath +
+                                    "': " + reason);
+  }
+
+  return Napi::External<KVOSubscription>::New(
+      env, subscription, [](Napi::Env, KVOSubscription *sub) {
+        sub->Stop();
+        delete sub;
+      });
+}
+
+Napi::Value StopObserving(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsExternal()) {
+    throw Napi::TypeError::New(env, "Expected a subscription handle");
+  }
+  info[0].As<Napi::External<KVOSubscription>>().Data()->Stop();
+  return env.Undefined();
+}
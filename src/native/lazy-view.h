@@ -0,0 +1,39 @@
+#ifndef LAZY_VIEW_H
+#define LAZY_VIEW_H
+
+#include <napi.h>
+
+// MARK: - Lazy Collection Views
+
+// Create a lazy view over an NSArray or NSDictionary. The collection is
+// retained; its mutation counter is snapshotted so later reads throw if it
+// changes.
+// Arguments: collection (ObjcObject)
+// Returns: { handle: External<LazyView>, kind: "array" | "dictionary",
+//   count: number }
+Napi::Value CreateLazyView(const Napi::CallbackInfo &info);
+
+// Element count (throws if the collection was mutated).
+// Arguments: handle
+Napi::Value LazyViewCount(const Napi::CallbackInfo &info);
+
+// Read one element. Array views take an index and serve it from an
+// aligned chunk of kLazyViewChunkSize elements fetched with
+// getObjects:range:. Dictionary views take a key (string or ObjcObject)
+// and use objectForKey:.
+// Arguments: handle, index | key
+// Returns: ObjcObject, or undefined when out of range / missing
+Napi::Value LazyViewGet(const Napi::CallbackInfo &info);
+
+// Read a contiguous range of an array view in one crossing (for iteration).
+// Arguments: handle, start, end (exclusive; clamped to the count)
+// Returns: ObjcObject[]
+Napi::Value LazyViewGetRange(const Napi::CallbackInfo &info);
+
+// Create an array view over a dictionary's keys. It is invalidated by
+// mutations of the dictionary.
+// Arguments: handle (dictionary view)
+// Returns: Same shape as CreateLazyView, with kind "array"
+Napi::Value LazyViewKeys(const Napi::CallbackInfo &info);
+
+#endif // LAZY_VIEW_H
@@ -0,0 +1,219 @@
+#include "lazy-view.h"
+#include "ObjcObject.h"
+#include "constants.h"
+#include "string-intern.h"
+#include <Foundation/Foundation.h>
+#include <algorithm>
+#include <napi.h>
+
+// MARK: - View State
+
+/**
+ * One aligned run of elements, retained while cached. `base` is the index
+ * of the first element, or NSNotFound while the slot is empty.
+ */
+struct LazyViewChunk {
+  NSUInteger base = NSNotFound;
+  NSUInteger length = 0;
+  id objects[nobjc::kLazyViewChunkSize];
+};
+
+/**
+ * A retained collection plus the mutation snapshot that guards it.
+ *
+ * Mutation detection reuses fast enumeration's contract: after one
+ * countByEnumeratingWithState: call, state.mutationsPtr points at a value
+ * that changes whenever the collection is mutated. Collections that never
+ * set it (some empty ones) fall back to comparing the count. The state is
+ * kept inside the view because mutationsPtr may point into it.
+ */
+struct LazyView {
+  id collection = nil;        // NSArray or NSDictionary, retained
+  id mutationSource = nil;    // the collection mutations are tracked on
+  bool isDictionary = false;
+  NSUInteger count = 0;
+  NSUInteger sourceCount = 0;
+  NSFastEnumerationState state = {};
+  unsigned long mutations = 0;
+  LazyViewChunk chunks[nobjc::kLazyViewCacheChunks];
+
+  LazyView(id collection, id mutationSource, bool isDictionary)
+      : collection([collection retain]),
+        mutationSource([mutationSource retain]),
+        isDictionary(isDictionary),
+        count([collection count]),
+        sourceCount([mutationSource count]) {
+    id scratch[1];
+    [mutationSource countByEnumeratingWithState:&state objects:scratch count:1];
+    if (state.mutationsPtr != nullptr) {
+      mutations = *state.mutationsPtr;
+    }
+  }
+
+  ~LazyView() {
+    for (LazyViewChunk &chunk : chunks) {
+      ReleaseChunk(chunk);
+    }
+    [collection release];
+    [mutationSource release];
+  }
+
+  bool WasMutated() const {
+    if (state.mutationsPtr != nullptr) {
+      return *state.mutationsPtr != mutations;
+    }
+    return [mutationSource count] != sourceCount;
+  }
+
+  static void ReleaseChunk(LazyViewChunk &chunk) {
+    for (NSUInteger i = 0; i < chunk.length; i++) {
+      [chunk.objects[i] release];
+    }
+    chunk.base = NSNotFound;
+    chunk.length = 0;
+  }
+
+  // The chunk containing `index`, fetching it if it is not cached.
+  const LazyViewChunk &ChunkFor(NSUInteger index) {
+    const NSUInteger chunkIndex = index / nobjc::kLazyViewChunkSize;
+    LazyViewChunk &chunk = chunks[chunkIndex % nobjc::kLazyViewCacheChunks];
+    const NSUInteger base = chunkIndex * nobjc::kLazyViewChunkSize;
+    if (chunk.base == base) {
+      return chunk;
+    }
+    ReleaseChunk(chunk);
+    const NSUInteger length = MIN(nobjc::kLazyViewChunkSize, count - base);
+    [(NSArray *)collection getObjects:chunk.objects range:NSMakeRange(base, length)];
+    for (NSUInteger i = 0; i < length; i++) {
+      [chunk.objects[i] retain];
+    }
+    chunk.base = base;
+    chunk.length = length;
+    return chunk;
+  }
+};
+
+static LazyView *UnwrapLazyView(Napi::Env env, const Napi::Value &value) {
+  if (!value.IsExternal()) {
+    throw Napi::TypeError::New(env, "Expected a lazy view handle");
+  }
+  LazyView *view = value.As<Napi::External<LazyView>>().Data();
+  if (view->WasMutated()) {
+    throw Napi::Error::New(
+        env, "Collection was mutated after the lazy view was created");
+  }
+  return view;
+}
+
+static Napi::Value WrapLazyView(Napi::Env env, LazyView *view) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("handle", Napi::External<LazyView>::New(
+                           env, view, [](Napi::Env, LazyView *v) { delete v; }));
+  result.Set("kind", Napi::String::New(env, view->isDictionary ? "dictionary" : "array"));
+  result.Set("count", Napi::Number::New(env, static_cast<double>(view->count)));
+  return result;
+}
+
+static Napi::Value WrapElement(Napi::Env env, id object) {
+  return object == nil ? env.Null() : Napi::Value(ObjcObject::NewInstance(env, object));
+}
+
+// MARK: - Exported Functions
+
+Napi::Value CreateLazyView(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !ObjcObject::IsInstance(env, info[0])) {
+    throw Napi::TypeError::New(env, "Expected a single ObjcObject argument");
+  }
+  id collection = ObjcObject::UnwrapObject(env, info[0]);
+  if ([collection isKindOfClass:[NSArray class]]) {
+    return WrapLazyView(env, new LazyView(collection, collection, false));
+  }
+  if ([collection isKindOfClass:[NSDictionary class]]) {
+    return WrapLazyView(env, new LazyView(collection, collection, true));
+  }
+  throw Napi::TypeError::New(env, "lazyView() expects an NSArray or NSDictionary");
+}
+
+Napi::Value LazyViewCount(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1) {
+    throw Napi::TypeError::New(env, "Expected a lazy view handle");
+  }
+  LazyView *view = UnwrapLazyView(env, info[0]);
+  return Napi::Number::New(env, static_cast<double>(view->count));
+}
+
+Napi::Value LazyViewGet(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 2) {
+    throw Napi::TypeError::New(env, "Expected (handle, index | key)");
+  }
+  LazyView *view = UnwrapLazyView(env, info[0]);
+
+  if (view->isDictionary) {
+    id key = nil;
+    if (info[1].IsString()) {
+      key = NSStringForJSArgument(env, info[1]);
+    } else if (ObjcObject::IsInstance(env, info[1])) {
+      key = ObjcObject::UnwrapObject(env, info[1]);
+    } else {
+      throw Napi::TypeError::New(env, "Dictionary view keys must be strings or ObjcObjects");
+    }
+    id value = key == nil ? nil : [(NSDictionary *)view->collection objectForKey:key];
+    return value == nil ? env.Undefined() : Napi::Value(ObjcObject::NewInstance(env, value));
+  }
+
+  if (!info[1].IsNumber()) {
+    throw Napi::TypeError::New(env, "Array view index must be a number");
+  }
+  double index = info[1].As<Napi::Number>().DoubleValue();
+  if (!(index >= 0) || index >= static_cast<double>(view->count)) {
+    return env.Undefined();
+  }
+  const NSUInteger position = static_cast<NSUInteger>(index);
+  const LazyViewChunk &chunk = view->ChunkFor(position);
+  return WrapElement(env, chunk.objects[position - chunk.base]);
+}
+
+Napi::Value LazyViewGetRange(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 3 || !info[1].IsNumber() || !info[2].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected (handle, start, end)");
+  }
+  LazyView *view = UnwrapLazyView(env, info[0]);
+  if (view->isDictionary) {
+    throw Napi::TypeError::New(env, "Ranges are only supported on array views");
+  }
+  const double count = static_cast<double>(view->count);
+  const double start = std::max(0.0, std::min(info[1].As<Napi::Number>().DoubleValue(), count));
+  const double end = std::max(start, std::min(info[2].As<Napi::Number>().DoubleValue(), count));
+  const NSUInteger from = static_cast<NSUInteger>(start);
+  const NSUInteger to = static_cast<NSUInteger>(end);
+
+  Napi::Array result = Napi::Array::New(env, to - from);
+  for (NSUInteger position = from; position < to;) {
+    const LazyViewChunk &chunk = view->ChunkFor(position);
+    const NSUInteger chunkEnd = MIN(to, chunk.base + chunk.length);
+    for (; position < chunkEnd; position++) {
+      result.Set(static_cast<uint32_t>(position - from),
+                 WrapElement(env, chunk.objects[position - chunk.base]));
+    }
+  }
+  return result;
+}
+
+Napi::Value LazyViewKeys(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1) {
+    throw Napi::TypeError::New(env, "Expected a lazy view handle");
+  }
+  LazyView *view = UnwrapLazyView(env, info[0]);
+  if (!view->isDictionary) {
+    throw Napi::TypeError::New(env, "keys() is only supported on dictionary views");
+  }
+  @autoreleasepool {
+    NSArray *keys = [(NSDictionary *)view->collection allKeys];
+    return WrapLazyView(env, new LazyView(keys, view->collection, false));
+  }
+}
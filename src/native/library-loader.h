@@ -0,0 +1,20 @@
+#ifndef LIBRARY_LOADER_H
+#define LIBRARY_LOADER_H
+
+#include <napi.h>
+
+// MARK: - Background Library Loading
+
+// dlopen several libraries in parallel off the JS thread. dyld serializes
+// the mapping itself, but image initializers (+load, C++ static ctors,
+// framework setup) run on the loading thread, so independent frameworks
+// overlap and the JS thread keeps evaluating modules meanwhile.
+// Arguments:
+//   - paths (string[]): Library or framework binary paths
+// Returns: Promise resolving to one { path, loaded, ms, error? } per path,
+//   in input order. A failed dlopen is reported in its entry instead of
+//   rejecting the promise, so one missing framework does not hide the
+//   timings of the others.
+Napi::Value LoadLibraryAsync(const Napi::CallbackInfo &info);
+
+#endif // LIBRARY_LOADER_H
@@ -0,0 +1,103 @@
+#include "library-loader.h"
+#include <chrono>
+#include <dispatch/dispatch.h>
+#include <dlfcn.h>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+// MARK: - Load Job
+
+struct LibraryLoadEntry {
+  std::string path;
+  bool loaded = false;
+  double milliseconds = 0;
+  std::string error;
+};
+
+/**
+ * Runs on a libuv worker thread and fans the dlopen calls out over the
+ * global concurrent queue with dispatch_apply_f, the same way
+ * ParallelSendMap spreads its receivers. Each entry is written by exactly
+ * one iteration, so no locking is needed; dlerror() is per-thread.
+ */
+class LibraryLoadWorker : public Napi::AsyncWorker {
+public:
+  LibraryLoadWorker(Napi::Env env, std::vector<LibraryLoadEntry> entries)
+      : Napi::AsyncWorker(env, "nobjc.loadLibraryAsync"),
+        deferred_(Napi::Promise::Deferred::New(env)),
+        entries_(std::move(entries)) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+  void Execute() override {
+    dispatch_apply_f(entries_.size(),
+                     dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0),
+                     entries_.data(), LoadOne);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::Array results = Napi::Array::New(env, entries_.size());
+    for (size_t i = 0; i < entries_.size(); i++) {
+      const LibraryLoadEntry &entry = entries_[i];
+      Napi::Object result = Napi::Object::New(env);
+      result.Set("path", Napi::String::New(env, entry.path));
+      result.Set("loaded", Napi::Boolean::New(env, entry.loaded));
+      result.Set("ms", Napi::Number::New(env, entry.milliseconds));
+      if (!entry.loaded) {
+        result.Set("error", Napi::String::New(env, entry.error));
+      }
+      results.Set(static_cast<uint32_t>(i), result);
+    }
+    deferred_.Resolve(results);
+  }
+
+  void OnError(const Napi::Error &error) override {
+    deferred_.Reject(error.Value());
+  }
+
+private:
+  static void LoadOne(void *context, size_t index) {
+    LibraryLoadEntry &entry = static_cast<LibraryLoadEntry *>(context)[index];
+    auto start = std::chrono::steady_clock::now();
+    // Same flags as LoadLibrary, so a later synchronous LoadLibrary of the
+    // same path just bumps the reference count.
+    void *handle = dlopen(entry.path.c_str(), RTLD_LAZY | RTLD_GLOBAL);
+    auto end = std::chrono::steady_clock::now();
+    entry.milliseconds =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    if (handle != nullptr) {
+      entry.loaded = true;
+    } else {
+      const char *message = dlerror();
+      entry.error = message ? message : "dlopen failed";
+    }
+  }
+
+  Napi::Promise::Deferred deferred_;
+  std::vector<LibraryLoadEntry> entries_;
+};
+
+// MARK: - Exported Function
+
+Napi::Value LoadLibraryAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsArray()) {
+    throw Napi::TypeError::New(env, "Expected an array of library paths");
+  }
+  Napi::Array paths = info[0].As<Napi::Array>();
+  std::vector<LibraryLoadEntry> entries(paths.Length());
+  for (uint32_t i = 0; i < paths.Length(); i++) {
+    Napi::Value path = paths.Get(i);
+    if (!path.IsString()) {
+      throw Napi::TypeError::New(env, "Library paths must be strings");
+    }
+    entries[i].path = path.As<Napi::String>().Utf8Value();
+  }
+
+  LibraryLoadWorker *worker = new LibraryLoadWorker(env, std::move(entries));
+  Napi::Promise promise = worker->Promise();
+  worker->Queue();
+  return promise;
+}
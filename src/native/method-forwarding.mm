@@ -30,6 +30,14 @@ void CallJSCallback(Napi::Env env, Napi::Function jsCallback,
     return;
   }
 
+  // The waiting thread gave up before we got here and has already returned
+  // a default value; its frame must not be touched.
+  if (data->completion && !data->completion->Claim()) {
+    NOBJC_LOG("CallJSCallback: Skipping %s, caller timed out",
+              data->selectorName.c_str());
+    return;  // guard cleans up
+  }
+
   NOBJC_LOG("CallJSCallback: Called for selector %s, callbackType=%d", 
             data->selectorName.c_str(), (int)data->callbackType);
 
@@ -139,13 +147,8 @@ void CallJSCallback(Napi::Env env, Napi::Function jsCallback,
 bool FallbackToTSFN(Napi::ThreadSafeFunction &tsfn, InvocationData *data,
                     const std::string &selectorName) {
   // Set up synchronization primitives
-  std::mutex completionMutex;
-  std::condition_variable completionCv;
-  bool isComplete = false;
-
-  data->completionMutex = &completionMutex;
-  data->completionCv = &completionCv;
-  data->isComplete = &isComplete;
+  auto completion = std::make_shared<CallCompletion>();
+  data->completion = completion;
 
   // Call via ThreadSafeFunction
   napi_status status = tsfn.NonBlockingCall(data, CallJSCallback);
@@ -158,7 +161,7 @@ bool FallbackToTSFN(Napi::ThreadSafeFunction &tsfn, InvocationData *data,
   }
 
   // Wait for callback by pumping CFRunLoop
-  PumpRunLoopUntilComplete(completionMutex, isComplete);
+  PumpRunLoopUntilComplete(*completion);
   
   return true;
 }
@@ -277,6 +280,9 @@ void ForwardInvocation(id self, SEL _cmd, NSInvocation *invocation) {
       ctx.skipDirectCallForElectron = it->second.isElectron;
       ctx.instancePtr = nullptr;   // Not used for protocols
       ctx.superClassPtr = nullptr; // Not used for protocols
+      ctx.dispatcher = it->second.dispatcher;
+      ctx.lane = methodIt->second.lane;
+      ctx.deadline = methodIt->second.deadline;
 
       // Cache the JS callback reference to avoid mutex re-acquisition
       ctx.cachedJsCallback = &methodIt->second.jsCallback;
@@ -1,9 +1,24 @@
 #include "ObjcObject.h"
+#include "bound-invocation.h"
 #include "call-function.h"
+#include "call-profiler.h"
+#include "call-trace.h"
+#include "callback-dispatcher.h"
+#include "kvo-observation.h"
+#include "lazy-view.h"
+#include "library-loader.h"
+#include "notification-subscription.h"
+#include "parallel-send.h"
 #include "pointer-utils.h"
 #include "protocol-impl.h"
+#include "stream-adapters.h"
+#include "string-intern.h"
+#include "string-utils.h"
 #include "subclass-impl.h"
+#include "symbol-resolution.h"
+#include "weak-reference.h"
 #include <Foundation/Foundation.h>
+#include <cstring>
 #include <dlfcn.h>
 #include <napi.h>
 
@@ -26,9 +41,7 @@ Napi::Value GetClassObject(const Napi::CallbackInfo &info) {
   if (info.Length() != 1 || !info[0].IsString()) {
     throw Napi::TypeError::New(env, "Expected a single string argument");
   }
-  std::string className = info[0].As<Napi::String>().Utf8Value();
-  Class cls =
-      NSClassFromString([NSString stringWithUTF8String:className.c_str()]);
+  Class cls = NSClassFromString(JSStringToNSString(env, info[0]));
   if (cls == nil) {
     return env.Undefined();
   }
@@ -47,8 +60,7 @@ Napi::Value GetPointer(const Napi::CallbackInfo &info) {
     throw Napi::TypeError::New(env, "Argument must be an ObjcObject instance");
   }
   
-  ObjcObject *objcObj = Napi::ObjectWrap<ObjcObject>::Unwrap(obj);
-  return PointerToBuffer(env, objcObj->objcObject);
+  return PointerToBuffer(env, ObjcObject::UnwrapObject(env, obj));
 }
 
 Napi::Value FromPointer(const Napi::CallbackInfo &info) {
@@ -79,6 +91,77 @@ Napi::Value FromPointer(const Napi::CallbackInfo &info) {
   return ObjcObject::NewInstance(env, reinterpret_cast<id>(ptr));
 }
 
+Napi::Value ToArrayBuffer(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsObject() ||
+      !ObjcObject::IsInstance(env, info[0]) ||
+      (info.Length() == 2 && !info[1].IsBoolean())) {
+    throw Napi::TypeError::New(env, "Expected (data, copy)");
+  }
+  const bool copyBytes =
+      info.Length() == 2 && info[1].As<Napi::Boolean>().Value();
+  id obj = ObjcObject::UnwrapObject(env, info[0]);
+  if (obj == nil || ![obj isKindOfClass:[NSData class]]) {
+    throw Napi::TypeError::New(env, "Argument must be an NSData instance");
+  }
+
+  if (copyBytes) {
+    NSData *data = (NSData *)obj;
+    NSUInteger length = [data length];
+    Napi::ArrayBuffer copy = Napi::ArrayBuffer::New(env, length);
+    if (length > 0) {
+      [data getBytes:copy.Data() length:length];
+    }
+    return copy;
+  }
+
+  // -copy is a retain for immutable data (including memory-mapped files) and
+  // a snapshot for NSMutableData, whose bytes may move when it is resized.
+  // The external buffer is writable as far as V8 knows, but the bytes are
+  // shared with ObjC (and read-only pages for mapped files), so JS must
+  // treat it as read-only; `copy` gives a private, writable buffer.
+  NSData *owned = [(NSData *)obj copy];
+  NSUInteger length = [owned length];
+  if (length == 0) {
+    [owned release];
+    return Napi::ArrayBuffer::New(env, 0);
+  }
+
+  napi_value result;
+  napi_status status = napi_create_external_arraybuffer(
+      env, const_cast<void *>([owned bytes]), length,
+      [](napi_env, void *, void *hint) { [(NSData *)hint release]; }, owned,
+      &result);
+  if (status == napi_ok) {
+    return Napi::ArrayBuffer(env, result);
+  }
+
+  // Runtimes with the V8 sandbox (Electron) reject external buffers.
+  Napi::ArrayBuffer copy = Napi::ArrayBuffer::New(env, length);
+  std::memcpy(copy.Data(), [owned bytes], length);
+  [owned release];
+  return copy;
+}
+
+// Open a borrowScope frame. Wrappers created until the matching
+// EndBorrowScope hold their objects without retaining them.
+Napi::Value BeginBorrowScope(const Napi::CallbackInfo &info) {
+  ObjcObject::GetEnvData(info.Env())
+      ->borrowScopes.push_back(std::make_unique<BorrowScope>());
+  return info.Env().Undefined();
+}
+
+// Close the innermost borrowScope frame, revoking its remaining wrappers.
+Napi::Value EndBorrowScope(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  NobjcEnvData *data = ObjcObject::GetEnvData(env);
+  if (data->borrowScopes.empty()) {
+    throw Napi::Error::New(env, "EndBorrowScope called without an open scope");
+  }
+  data->borrowScopes.pop_back();
+  return env.Undefined();
+}
+
 Napi::Value PumpRunLoop(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   
@@ -95,6 +178,7 @@ Napi::Value PumpRunLoop(const Napi::CallbackInfo &info) {
   // crashes under Bun's N-API implementation (segfault in the CF call).
   // NSRunLoop.runMode:beforeDate: is functionally equivalent and works
   // correctly in both Node.js and Bun.
+  nobjc::NativeCallScope nativeCall(env);
   @autoreleasepool {
     NSRunLoop *mainLoop = [NSRunLoop mainRunLoop];
     NSDate *limitDate = [NSDate dateWithTimeIntervalSinceNow:timeout];
@@ -111,15 +195,56 @@ Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
   napi_set_instance_data(env, new NobjcEnvData(), CleanupEnvData, nullptr);
   ObjcObject::Init(env, exports);
   exports.Set("LoadLibrary", Napi::Function::New(env, LoadLibrary));
+  exports.Set("LoadLibraryAsync", Napi::Function::New(env, LoadLibraryAsync));
   exports.Set("GetClassObject", Napi::Function::New(env, GetClassObject));
   exports.Set("GetPointer", Napi::Function::New(env, GetPointer));
   exports.Set("FromPointer", Napi::Function::New(env, FromPointer));
+  exports.Set("BeginBorrowScope", Napi::Function::New(env, BeginBorrowScope));
+  exports.Set("EndBorrowScope", Napi::Function::New(env, EndBorrowScope));
+  exports.Set("CreateWeakReference",
+              Napi::Function::New(env, CreateWeakReference));
+  exports.Set("LoadWeakReference", Napi::Function::New(env, LoadWeakReference));
+  exports.Set("LoadWeakReferences",
+              Napi::Function::New(env, LoadWeakReferences));
+  exports.Set("ToArrayBuffer", Napi::Function::New(env, ToArrayBuffer));
   exports.Set("CreateProtocolImplementation",
               Napi::Function::New(env, CreateProtocolImplementation));
   exports.Set("DefineClass", Napi::Function::New(env, DefineClass));
   exports.Set("CallSuper", Napi::Function::New(env, CallSuper));
   exports.Set("CallFunction", Napi::Function::New(env, CallFunction));
+  exports.Set("ResolveSymbols", Napi::Function::New(env, ResolveSymbols));
   exports.Set("PumpRunLoop", Napi::Function::New(env, PumpRunLoop));
+  exports.Set("ObserveKeyPath", Napi::Function::New(env, ObserveKeyPath));
+  exports.Set("StopObserving", Napi::Function::New(env, StopObserving));
+  exports.Set("SubscribeNotification",
+              Napi::Function::New(env, SubscribeNotification));
+  exports.Set("Unsubscribe", Napi::Function::New(env, Unsubscribe));
+  exports.Set("InputStreamOpen", Napi::Function::New(env, InputStreamOpen));
+  exports.Set("InputStreamRead", Napi::Function::New(env, InputStreamRead));
+  exports.Set("InputStreamClose", Napi::Function::New(env, InputStreamClose));
+  exports.Set("OutputStreamOpen", Napi::Function::New(env, OutputStreamOpen));
+  exports.Set("OutputStreamWrite", Napi::Function::New(env, OutputStreamWrite));
+  exports.Set("OutputStreamClose", Napi::Function::New(env, OutputStreamClose));
+  exports.Set("ParallelSendMap", Napi::Function::New(env, ParallelSendMap));
+  exports.Set("BindInvocation", Napi::Function::New(env, BindInvocation));
+  exports.Set("CreateLazyView", Napi::Function::New(env, CreateLazyView));
+  exports.Set("LazyViewCount", Napi::Function::New(env, LazyViewCount));
+  exports.Set("LazyViewGet", Napi::Function::New(env, LazyViewGet));
+  exports.Set("LazyViewGetRange", Napi::Function::New(env, LazyViewGetRange));
+  exports.Set("LazyViewKeys", Napi::Function::New(env, LazyViewKeys));
+  exports.Set("InvokeBound", Napi::Function::New(env, InvokeBound));
+  exports.Set("ConfigureStringIntern",
+              Napi::Function::New(env, ConfigureStringIntern));
+  exports.Set("GetStringInternStats",
+              Napi::Function::New(env, GetStringInternStats));
+  exports.Set("GetCallbackDispatcherStats",
+              Napi::Function::New(env, GetCallbackDispatcherStats));
+  exports.Set("ConfigureCallbackTimeout",
+              Napi::Function::New(env, ConfigureCallbackTimeout));
+  exports.Set("StartCallProfiler", Napi::Function::New(env, StartCallProfiler));
+  exports.Set("StopCallProfiler", Napi::Function::New(env, StopCallProfiler));
+  exports.Set("StartCallTrace", Napi::Function::New(env, StartCallTrace));
+  exports.Set("StopCallTrace", Napi::Function::New(env, StopCallTrace));
   return exports;
 }
 
@@ -23,6 +23,8 @@
  *   stored in a global registry and never freed (v1 simplification).
  *   The block itself is heap-copied via _Block_copy and stored as `id`
  *   in the ObjcType variant, so ARC manages the block pointer lifetime.
+ *   Parsed signatures (converters plus a prepared ffi_cif) are compiled once
+ *   per encoding and shared by every block with that encoding.
  *
  * Thread safety:
  *   Blocks may be called from background threads (e.g., completion handlers).
@@ -30,6 +32,8 @@
  *   forwarding. Direct invocation is used when already on the JS thread.
  */
 
+#include "call-trace.h"
+#include "callback-dispatcher.h"
 #include "debug.h"
 #include "constants.h"
 #include "forwarding-common.h"
@@ -37,6 +41,7 @@
 #include "type-conversion.h"
 #include "struct-utils.h"
 #include "ffi-utils.h"
+#include "image-range-index.h"
 #include <Block.h>
 #include <Foundation/Foundation.h>
 #include <atomic>
@@ -51,6 +56,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 // MARK: - Block ABI Structures
 
@@ -258,32 +264,206 @@ inline std::string GetExtendedBlockEncoding(Class cls, SEL selector, size_t argI
   return encoding;
 }
 
+// MARK: - Block Encoding Caches
+
+struct BlockEncodingKey {
+  Class cls;
+  SEL selector;
+  size_t argIndex;
+  bool operator==(const BlockEncodingKey &other) const {
+    return cls == other.cls && selector == other.selector &&
+           argIndex == other.argIndex;
+  }
+};
+
+struct BlockEncodingKeyHash {
+  size_t operator()(const BlockEncodingKey &key) const {
+    auto h1 = std::hash<void *>{}((__bridge void *)key.cls);
+    auto h2 = std::hash<void *>{}(key.selector);
+    return h1 ^ (h2 << 1) ^ (key.argIndex << 3);
+  }
+};
+
+/**
+ * GetExtendedBlockEncoding, cached by (Class, SEL, argument index).
+ *
+ * Returns the encoding, or nullptr when the method exposes no encoding for
+ * that argument. Returned strings live for the rest of the process. Misses
+ * where the method itself was not found are not cached, so methods added
+ * later are still seen.
+ */
+inline const char *CachedExtendedBlockEncoding(Class cls, SEL selector,
+                                               size_t argIndex) {
+  static std::mutex mutex;
+  static std::unordered_map<BlockEncodingKey, std::string, BlockEncodingKeyHash>
+      cache;
+
+  const BlockEncodingKey key{cls, selector, argIndex};
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    if (!class_getInstanceMethod(cls, selector) &&
+        !class_getClassMethod(cls, selector)) {
+      return nullptr;
+    }
+    it = cache.emplace(key, GetExtendedBlockEncoding(cls, selector, argIndex)).first;
+  }
+  return it->second.empty() ? nullptr : it->second.c_str();
+}
+
+// MARK: - Compiled Block Signatures
+
+/**
+ * How one block parameter converts to JS, decided once per signature so the
+ * invoke path switches on a type code instead of re-simplifying strings.
+ */
+struct BlockParamConverter {
+  char code;              // Simplified type code; '?' means heuristic
+  bool isBlock;           // @? — passed through as an opaque object
+  std::string encoding;   // Simplified encoding (struct layouts)
+};
+
+/**
+ * A parsed block signature with its converters and a prepared ffi_cif.
+ *
+ * Shared by every block created with the same encoding. Compiled signatures
+ * are cached for the life of the process and never freed, so BlockInfo and
+ * the FFI closures that point at `cif` can hold plain pointers.
+ */
+struct CompiledBlockSignature {
+  BlockSignature signature;
+  std::vector<BlockParamConverter> params;
+  char returnCode;
+  ffi_cif cif;
+  std::vector<ffi_type *> argFFITypes;  // Includes block self (pointer) as arg[0]
+  FFITypeGuard ffiTypeGuard;            // Struct types allocated for argFFITypes
+};
+
+/**
+ * Build a CompiledBlockSignature. Returns nullptr if ffi_prep_cif fails.
+ */
+inline std::unique_ptr<CompiledBlockSignature>
+CompileBlockSignature(const BlockSignature &sig) {
+  auto compiled = std::make_unique<CompiledBlockSignature>();
+  compiled->signature = sig;
+  compiled->returnCode = SimplifyTypeEncoding(sig.returnType.c_str())[0];
+
+  // Block invoke signature: returnType (blockSelf, param1, param2, ...)
+  // blockSelf is always a pointer (the block literal)
+  compiled->argFFITypes.push_back(&ffi_type_pointer);
+  for (const auto &paramType : sig.paramTypes) {
+    const char *simplified = SimplifyTypeEncoding(paramType.c_str());
+    BlockParamConverter converter{simplified[0],
+                                  simplified[0] == '@' && simplified[1] == '?',
+                                  simplified};
+    ffi_type *ffiType;
+    if (converter.code == '?') {
+      // Unknown type (inferred from JS function.length) — treat as pointer
+      ffiType = &ffi_type_pointer;
+    } else if (converter.code == '{') {
+      // Struct type — need full parsing
+      size_t structSize = 0;
+      ffiType = GetFFITypeForEncoding(simplified, &structSize, compiled->ffiTypeGuard);
+    } else {
+      ffiType = GetFFITypeForSimpleEncoding(converter.code);
+    }
+    compiled->argFFITypes.push_back(ffiType);
+    compiled->params.push_back(std::move(converter));
+  }
+
+  ffi_status status = ffi_prep_cif(
+      &compiled->cif, FFI_DEFAULT_ABI,
+      static_cast<unsigned int>(compiled->argFFITypes.size()),
+      GetFFITypeForSimpleEncoding(compiled->returnCode),
+      compiled->argFFITypes.data());
+  if (status != FFI_OK) {
+    NOBJC_ERROR("CompileBlockSignature: ffi_prep_cif failed (status=%d)", status);
+    return nullptr;
+  }
+  return compiled;
+}
+
+/**
+ * The compiled signature for a block encoding, compiling it on first use.
+ *
+ * Encodings without an extended signature (plain "@?") are keyed by the JS
+ * function's parameter count, since every parameter is then inferred as a
+ * pointer-sized '?' slot. Returns nullptr if the signature cannot be
+ * prepared.
+ */
+inline const CompiledBlockSignature *
+GetCompiledBlockSignature(const char *encoding, const Napi::Function &fn) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string,
+                            std::unique_ptr<CompiledBlockSignature>>
+      cache;
+
+  const char *simplified = SimplifyTypeEncoding(encoding);
+  const bool extended =
+      simplified[0] == '@' && simplified[1] == '?' && simplified[2] == '<';
+  uint32_t jsParamCount = 0;
+  std::string key;
+  if (extended) {
+    key = simplified;
+  } else {
+    jsParamCount = fn.Get("length").As<Napi::Number>().Uint32Value();
+    key = "?" + std::to_string(jsParamCount);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second.get();
+  }
+
+  BlockSignature sig = ParseBlockSignature(encoding);
+  if (!sig.valid) {
+    // No extended encoding — infer from JS function's .length
+    // All params are treated as pointer-sized (heuristic detection in callback)
+    NOBJC_LOG("GetCompiledBlockSignature: No extended block encoding, "
+              "inferring %u params from JS function.length. Encoding: '%s'",
+              jsParamCount, encoding);
+    sig.returnType = "v";  // Assume void return
+    sig.paramTypes.assign(jsParamCount, "?");
+    sig.valid = true;
+  }
+  auto compiled = CompileBlockSignature(sig);
+  if (!compiled) {
+    return nullptr;
+  }
+  return cache.emplace(std::move(key), std::move(compiled)).first->second.get();
+}
+
 /**
  * BlockInfo holds all state for a single JS-function-backed block.
- * It owns the FFI closure, CIF, arg types, JS function reference, and TSFN.
+ * It owns the FFI closure, JS function reference, and TSFN; the CIF and arg
+ * types belong to the shared CompiledBlockSignature.
  *
  * Lifetime is tied to the Objective-C block copies plus any in-flight callbacks.
  */
 struct BlockInfo {
-  // FFI closure and CIF
+  // FFI closure (its CIF lives in the shared compiled signature)
   ffi_closure *closure;
-  ffi_cif cif;
-  ffi_type *returnFFIType;
-  std::vector<ffi_type *> argFFITypes;   // Includes block self (pointer) as arg[0]
-  std::vector<ffi_type *> argFFIPtrs;    // Pointer array for ffi_prep_cif
 
-  // Block signature
-  BlockSignature signature;
+  // Block signature, converters and CIF (shared, never freed)
+  const CompiledBlockSignature *compiled;
 
-  // Allocated FFI types (for struct types — cleaned up on destruction)
-  FFITypeGuard ffiTypeGuard;
+  // Heuristic classification memo, one per parameter (used for '?' params)
+  std::vector<BlockArgSlotMemo> argSlotMemo;
 
   // JS function reference (prevents GC)
   Napi::FunctionReference jsFunction;
 
-  // Thread-safe function for cross-thread calls
+  // Owns this BlockInfo: releasing it (last ref) finalizes and deletes us
+  // on the JS thread
   Napi::ThreadSafeFunction tsfn;
 
+  // Cross-thread invocations are posted here, on `lane`
+  std::shared_ptr<nobjc::CallbackDispatcher> dispatcher;
+  nobjc::CallbackLane lane = nobjc::CallbackLane::Blocking;
+  // How long a cross-thread caller waits before returning a default
+  CallbackDeadline deadline;
+
   // JS thread ID for thread detection
   pthread_t js_thread;
 
@@ -330,10 +510,9 @@ struct BlockCallData {
   std::vector<void *> argValues;       // Pointers to argument values (from FFI)
   void *returnValuePtr;                // Where to write the return value
 
-  // Synchronization for cross-thread calls
-  std::mutex completionMutex;
-  std::condition_variable completionCv;
-  bool isComplete;
+  // Synchronization for cross-thread calls (shared with the queued task,
+  // which may run after the caller has timed out and returned)
+  std::shared_ptr<CallCompletion> completion;
 };
 
 // MARK: - Block Lifetime Management
@@ -405,11 +584,13 @@ inline void NobjcBlockDisposeHelper(const void *src) {
  * 3. If it is, verify it has a valid class pointer
  * 4. Fall back to image-backed singleton detection for constant objects like
  *    __NSArray0 that live in the dyld shared cache instead of malloc heap
+ *
+ * Image membership is answered by ImageRangeIndex (a lock-free binary search
+ * over loaded segments) rather than dladdr, which takes the dyld lock.
  */
 inline bool PointerResolvesToLoadedImage(const void *ptr) {
   if (!ptr) return false;
-  Dl_info info;
-  return dladdr(ptr, &info) != 0;
+  return nobjc::ImageRangeIndex::Shared().Contains(ptr);
 }
 
 inline uintptr_t GetObjCIsaClassMask() {
@@ -485,18 +666,50 @@ inline bool LooksLikeObjCObject(uintptr_t val) {
   return LooksLikeImageBackedObjCObject(val);
 }
 
+/**
+ * What the heuristic has learned about one untyped ('?') block parameter.
+ *
+ * A parameter's C type is fixed by the block's real signature, so once a
+ * slot classifies the same way kBlockArgMemoStreak times in a row it is
+ * settled and later calls skip LooksLikeObjCObject. A slot that disagrees
+ * with itself before settling is marked Mixed and always classified.
+ *
+ * Block arguments are only converted on the JS thread, so no locking.
+ */
+struct BlockArgSlotMemo {
+  enum Kind : uint8_t { Unknown, Object, Scalar, Mixed };
+  Kind settled = Unknown;
+  Kind pending = Unknown;
+  uint8_t streak = 0;
+
+  void Record(bool isObject) {
+    if (settled != Unknown) return;
+    const Kind kind = isObject ? Object : Scalar;
+    if (pending != Unknown && pending != kind) {
+      settled = Mixed;
+      return;
+    }
+    pending = kind;
+    if (++streak >= nobjc::kBlockArgMemoStreak) {
+      settled = kind;
+    }
+  }
+};
+
 /**
  * Convert a block argument to JS using heuristic type detection.
  * Used when no extended block encoding is available (@? without <...>).
  *
  * argPtr is a pointer TO the argument value (as provided by FFI).
- * The argument is pointer-sized.
+ * The argument is pointer-sized. `memo`, when given, is the slot's
+ * classification history (see BlockArgSlotMemo).
  *
  * Strategy:
  * - If the value looks like an ObjC object, wrap it as ObjcObject
  * - Otherwise, interpret as a number (NSUInteger/NSInteger)
  */
-inline Napi::Value ConvertBlockArgHeuristic(Napi::Env env, void *argPtr) {
+inline Napi::Value ConvertBlockArgHeuristic(Napi::Env env, void *argPtr,
+                                            BlockArgSlotMemo *memo = nullptr) {
   // Read the raw pointer-sized value
   uintptr_t value = *static_cast<uintptr_t *>(argPtr);
 
@@ -505,7 +718,16 @@ inline Napi::Value ConvertBlockArgHeuristic(Napi::Env env, void *argPtr) {
   // (the proxy layer handles numeric values correctly).
   if (value == 0) return Napi::Number::New(env, 0);
 
-  if (LooksLikeObjCObject(value)) {
+  bool isObject;
+  if (memo != nullptr && (memo->settled == BlockArgSlotMemo::Object ||
+                          memo->settled == BlockArgSlotMemo::Scalar)) {
+    isObject = memo->settled == BlockArgSlotMemo::Object;
+  } else {
+    isObject = LooksLikeObjCObject(value);
+    if (memo != nullptr) memo->Record(isObject);
+  }
+
+  if (isObject) {
     id obj = (__bridge id)(void *)value;
     return ObjcObject::NewInstance(env, obj);
   }
@@ -519,30 +741,28 @@ inline Napi::Value ConvertBlockArgHeuristic(Napi::Env env, void *argPtr) {
  * Used inside the FFI callback when the block is invoked.
  */
 inline Napi::Value ConvertBlockArgToJS(Napi::Env env, void *argPtr,
-                                        const std::string &typeEncoding) {
-  const char *simplified = SimplifyTypeEncoding(typeEncoding.c_str());
-  char code = simplified[0];
-
+                                        const BlockParamConverter &converter,
+                                        BlockArgSlotMemo *memo = nullptr) {
   // Unknown type (inferred params) — use heuristic
-  if (code == '?') {
-    return ConvertBlockArgHeuristic(env, argPtr);
+  if (converter.code == '?') {
+    return ConvertBlockArgHeuristic(env, argPtr, memo);
   }
 
   // Handle @? (block) args as opaque objects
-  if (code == '@' && simplified[1] == '?') {
+  if (converter.isBlock) {
     id value = *(static_cast<id *>(argPtr));
     if (value == nil) return env.Null();
     return ObjcObject::NewInstance(env, value);
   }
 
   // Handle struct types
-  if (code == '{') {
+  if (converter.code == '{') {
     return UnpackStructToJSValue(env, static_cast<const uint8_t *>(argPtr),
-                                 simplified);
+                                 converter.encoding.c_str());
   }
 
   // Simple types
-  return ObjCToJS(env, argPtr, code);
+  return ObjCToJS(env, argPtr, converter.code);
 }
 
 // MARK: - Block Return Value Conversion (JS → ObjC)
@@ -552,10 +772,7 @@ inline Napi::Value ConvertBlockArgToJS(Napi::Env env, void *argPtr,
  * Used inside the FFI callback after the JS function returns.
  */
 inline void SetBlockReturnFromJS(Napi::Value result, void *returnPtr,
-                                  const std::string &typeEncoding) {
-  const char *simplified = SimplifyTypeEncoding(typeEncoding.c_str());
-  char code = simplified[0];
-
+                                  char code) {
   if (code == 'v') return;  // Void return — nothing to do
 
   if (result.IsNull() || result.IsUndefined()) {
@@ -593,8 +810,7 @@ inline void SetBlockReturnFromJS(Napi::Value result, void *returnPtr,
       if (result.IsObject()) {
         Napi::Object obj = result.As<Napi::Object>();
         if (ObjcObject::IsInstance(result.Env(), obj)) {
-          ObjcObject *wrapper = Napi::ObjectWrap<ObjcObject>::Unwrap(obj);
-          objcVal = wrapper->objcObject;
+          objcVal = ObjcObject::UnwrapObject(result.Env(), obj);
         }
       }
       memcpy(returnPtr, &objcVal, sizeof(id));
@@ -606,20 +822,23 @@ inline void SetBlockReturnFromJS(Napi::Value result, void *returnPtr,
   }
 }
 
-// MARK: - TSFN Callback for Cross-Thread Block Invocation
+// MARK: - Dispatcher Task for Cross-Thread Block Invocation
 
 /**
- * Called on the JS thread via ThreadSafeFunction when a block is invoked
- * from a background thread.
+ * Called on the JS thread by the callback dispatcher when a block is invoked
+ * from a background thread. A null env means the env is shutting down: the
+ * waiting thread is released without calling JS.
  */
 inline void BlockTSFNCallback(Napi::Env env, Napi::Function /*jsCallback*/,
                                BlockCallData *callData) {
-  if (!callData || !callData->blockInfo) {
-    NOBJC_ERROR("BlockTSFNCallback: null callData or blockInfo");
+  if (!callData || !callData->blockInfo || env == nullptr) {
+    if (env != nullptr) {
+      NOBJC_ERROR("BlockTSFNCallback: null callData or blockInfo");
+    }
     if (callData) {
-      std::lock_guard<std::mutex> lock(callData->completionMutex);
-      callData->isComplete = true;
-      callData->completionCv.notify_one();
+      BlockInfo *orphan = callData->blockInfo;
+      callData->completion->Finish();
+      ReleaseBlockInfo(orphan);
     }
     return;
   }
@@ -632,13 +851,15 @@ inline void BlockTSFNCallback(Napi::Env env, Napi::Function /*jsCallback*/,
 
       // Build JS arguments (skip arg[0] which is the block self)
       std::vector<napi_value> jsArgs;
-      jsArgs.reserve(info->signature.paramTypes.size());
+      const CompiledBlockSignature &compiled = *info->compiled;
+      jsArgs.reserve(compiled.params.size());
 
-      for (size_t i = 0; i < info->signature.paramTypes.size(); i++) {
+      for (size_t i = 0; i < compiled.params.size(); i++) {
         // argValues[0] is block self, actual params start at index 1
         void *argPtr = callData->argValues[i + 1];
         Napi::Value jsVal = ConvertBlockArgToJS(env, argPtr,
-                                                 info->signature.paramTypes[i]);
+                                                 compiled.params[i],
+                                                 &info->argSlotMemo[i]);
         jsArgs.push_back(jsVal);
       }
 
@@ -648,7 +869,7 @@ inline void BlockTSFNCallback(Napi::Env env, Napi::Function /*jsCallback*/,
       // Handle return value
       if (callData->returnValuePtr) {
         SetBlockReturnFromJS(result, callData->returnValuePtr,
-                              info->signature.returnType);
+                              compiled.returnCode);
       }
     } catch (const Napi::Error &e) {
       NOBJC_ERROR("BlockTSFNCallback: JS error: %s", e.what());
@@ -660,11 +881,7 @@ inline void BlockTSFNCallback(Napi::Env env, Napi::Function /*jsCallback*/,
   }
 
   // Signal completion
-  {
-    std::lock_guard<std::mutex> lock(callData->completionMutex);
-    callData->isComplete = true;
-    callData->completionCv.notify_one();
-  }
+  callData->completion->Finish();
 
   ReleaseBlockInfo(info);
 }
@@ -690,6 +907,19 @@ inline void BlockInvokeCallback(ffi_cif *cif, void *ret, void **args,
 
   RetainBlockInfo(info);
   bool is_js_thread = pthread_equal(pthread_self(), info->js_thread);
+  nobjc::TraceEncodedCall(
+      is_js_thread ? nobjc::TraceKind::Callback
+                   : nobjc::TraceKind::CrossThreadCallback,
+      info->compiled, [info] {
+        const BlockSignature &sig = info->compiled->signature;
+        std::string name = sig.returnType + "(";
+        for (size_t i = 0; i < sig.paramTypes.size(); i++) {
+          name += (i == 0 ? "" : ",") + sig.paramTypes[i];
+        }
+        return nobjc::DescribeEncodedShape("block", name + ")",
+                                           sig.returnType.c_str(),
+                                           sig.paramTypes);
+      });
 
   if (is_js_thread) {
     // Direct call on JS thread
@@ -700,12 +930,14 @@ inline void BlockInvokeCallback(ffi_cif *cif, void *ret, void **args,
 
         // Build JS arguments (skip args[0] which is block self)
         std::vector<napi_value> jsArgs;
-        jsArgs.reserve(info->signature.paramTypes.size());
+        const CompiledBlockSignature &compiled = *info->compiled;
+        jsArgs.reserve(compiled.params.size());
 
-        for (size_t i = 0; i < info->signature.paramTypes.size(); i++) {
+        for (size_t i = 0; i < compiled.params.size(); i++) {
           void *argPtr = args[i + 1];  // +1 to skip block self
           Napi::Value jsVal = ConvertBlockArgToJS(env, argPtr,
-                                                    info->signature.paramTypes[i]);
+                                                    compiled.params[i],
+                                                    &info->argSlotMemo[i]);
           jsArgs.push_back(jsVal);
         }
 
@@ -713,8 +945,8 @@ inline void BlockInvokeCallback(ffi_cif *cif, void *ret, void **args,
         Napi::Value result = info->jsFunction.Value().Call(jsArgs);
 
         // Handle return value
-        if (ret && info->signature.returnType != "v") {
-          SetBlockReturnFromJS(result, ret, info->signature.returnType);
+        if (ret && compiled.returnCode != 'v') {
+          SetBlockReturnFromJS(result, ret, compiled.returnCode);
         }
       } catch (const Napi::Error &e) {
         NOBJC_ERROR("BlockInvokeCallback: JS error: %s", e.what());
@@ -726,39 +958,46 @@ inline void BlockInvokeCallback(ffi_cif *cif, void *ret, void **args,
     }
     ReleaseBlockInfo(info);
   } else {
-    // Cross-thread call via TSFN
+    // Cross-thread call via the callback dispatcher
     BlockCallData callData;
     callData.blockInfo = info;
     callData.returnValuePtr = ret;
-    callData.isComplete = false;
+    auto completion = std::make_shared<CallCompletion>();
+    callData.completion = completion;
 
     // Copy arg pointers
-    size_t totalArgs = info->signature.paramTypes.size() + 1;  // +1 for block self
+    size_t totalArgs = info->compiled->params.size() + 1;  // +1 for block self
     callData.argValues.resize(totalArgs);
     for (size_t i = 0; i < totalArgs; i++) {
       callData.argValues[i] = args[i];
     }
 
-    // Acquire the TSFN
-    napi_status acq_status = info->tsfn.Acquire();
-    if (acq_status != napi_ok) {
-      NOBJC_ERROR("BlockInvokeCallback: Failed to acquire TSFN");
-      ReleaseBlockInfo(info);
-      return;
-    }
-
-    // Call via TSFN
-    napi_status status = info->tsfn.NonBlockingCall(&callData, BlockTSFNCallback);
-    info->tsfn.Release();
-
-    if (status != napi_ok) {
-      NOBJC_ERROR("BlockInvokeCallback: TSFN call failed (status=%d)", status);
-      ReleaseBlockInfo(info);
-      return;
-    }
+    // The in-flight ref taken above keeps `info` alive until the task has
+    // run and released it, which may happen before we stop waiting; copy
+    // what the wait needs first.
+    std::shared_ptr<nobjc::CallbackDispatcher> dispatcher = info->dispatcher;
+    const CallbackDeadline deadline = info->deadline;
+    const char returnCode = info->compiled->returnCode;
+    const size_t returnSize = cif->rtype->size;
+
+    BlockCallData *callDataPtr = &callData;
+    dispatcher->Post(info->lane, [completion, info, callDataPtr](Napi::Env env) {
+      // The caller timed out and returned; `callData` went with its frame
+      if (!completion->Claim()) {
+        ReleaseBlockInfo(info);
+        return;
+      }
+      BlockTSFNCallback(env, Napi::Function(), callDataPtr);
+    });
 
     // Wait for completion by pumping CFRunLoop
-    PumpRunLoopUntilComplete(callData.completionMutex, callData.isComplete);
+    if (!WaitForCallback(*completion, *dispatcher,
+                         deadline.Resolve(*dispatcher))) {
+      if (ret && returnCode != 'v') {
+        deadline.ApplyTo(ret, returnSize);
+      }
+      NOBJC_WARN("Block callback timed out; returned the default value");
+    }
   }
 }
 
@@ -794,29 +1033,23 @@ inline id CreateBlockFromJSFunction(Napi::Env env,
   const char *effectiveTypeEncoding =
       explicitTypeEncoding.empty() ? typeEncoding : explicitTypeEncoding.c_str();
 
-  // Parse the block signature
-  BlockSignature sig = ParseBlockSignature(effectiveTypeEncoding);
-  if (!sig.valid) {
-    // No extended encoding — infer from JS function's .length
-    // All params are treated as pointer-sized (heuristic detection in callback)
-    Napi::Function fn = jsFunction.As<Napi::Function>();
-    uint32_t jsParamCount = fn.Get("length").As<Napi::Number>().Uint32Value();
-
-    NOBJC_LOG("CreateBlockFromJSFunction: No extended block encoding, "
-              "inferring %u params from JS function.length. Encoding: '%s'",
-              jsParamCount, effectiveTypeEncoding);
-
-    sig.returnType = "v";  // Assume void return
-    sig.paramTypes.clear();
-    for (uint32_t i = 0; i < jsParamCount; i++) {
-      sig.paramTypes.push_back("?");  // Unknown type — use heuristic in callback
-    }
-    sig.valid = true;
+  // Parse and compile the block signature (cached per encoding)
+  const CompiledBlockSignature *compiled =
+      GetCompiledBlockSignature(effectiveTypeEncoding, jsFunction.As<Napi::Function>());
+  if (!compiled) {
+    Napi::Error::New(env, "ffi_prep_cif failed for block")
+        .ThrowAsJavaScriptException();
+    return nil;
   }
 
+  // Read the timeout marker before allocating anything (this may throw)
+  CallbackDeadline deadline = CallbackDeadlineForFunction(
+      jsFunction.As<Napi::Function>(), compiled->returnCode);
+
   // Create BlockInfo
   auto *blockInfo = new BlockInfo();
-  blockInfo->signature = sig;
+  blockInfo->compiled = compiled;
+  blockInfo->argSlotMemo.resize(compiled->params.size());
   blockInfo->env = env;
   blockInfo->js_thread = pthread_self();
   blockInfo->closure = nullptr;
@@ -825,7 +1058,13 @@ inline id CreateBlockFromJSFunction(Napi::Env env,
   // Store JS function reference
   blockInfo->jsFunction = Napi::Persistent(jsFunction.As<Napi::Function>());
 
-  // Create TSFN for cross-thread calls
+  blockInfo->dispatcher = nobjc::CallbackDispatcher::ForEnv(env);
+  blockInfo->lane = nobjc::CallbackLaneForFunction(
+      jsFunction.As<Napi::Function>(), nobjc::CallbackLane::Blocking);
+  blockInfo->deadline = deadline;
+
+  // The TSFN only manages BlockInfo lifetime (finalized on the JS thread);
+  // calls go through the dispatcher
   blockInfo->tsfn = Napi::ThreadSafeFunction::New(
       env,
       jsFunction.As<Napi::Function>(),
@@ -836,38 +1075,6 @@ inline id CreateBlockFromJSFunction(Napi::Env env,
       BlockTSFNFinalize,
       blockInfo);
 
-  // Build FFI types for the block invocation
-  // Block invoke signature: returnType (blockSelf, param1, param2, ...)
-  // blockSelf is always a pointer (the block literal)
-
-  // Return type
-  blockInfo->returnFFIType = GetFFITypeForSimpleEncoding(
-      SimplifyTypeEncoding(sig.returnType.c_str())[0]);
-
-  // Arg types: [blockSelf(ptr), param1, param2, ...]
-  blockInfo->argFFITypes.push_back(&ffi_type_pointer);  // block self
-  for (const auto &paramType : sig.paramTypes) {
-    const char *simplified = SimplifyTypeEncoding(paramType.c_str());
-    ffi_type *ffiType;
-    if (simplified[0] == '?') {
-      // Unknown type (inferred from JS function.length) — treat as pointer
-      ffiType = &ffi_type_pointer;
-    } else if (simplified[0] == '{') {
-      // Struct type — need full parsing
-      size_t structSize = 0;
-      ffiType = GetFFITypeForEncoding(simplified, &structSize, blockInfo->ffiTypeGuard);
-    } else {
-      ffiType = GetFFITypeForSimpleEncoding(simplified[0]);
-    }
-    blockInfo->argFFITypes.push_back(ffiType);
-  }
-
-  // Build pointer array for ffi_prep_cif
-  blockInfo->argFFIPtrs.resize(blockInfo->argFFITypes.size());
-  for (size_t i = 0; i < blockInfo->argFFITypes.size(); i++) {
-    blockInfo->argFFIPtrs[i] = blockInfo->argFFITypes[i];
-  }
-
   // Allocate FFI closure
   void *codePtr = nullptr;
   blockInfo->closure = static_cast<ffi_closure *>(
@@ -880,25 +1087,10 @@ inline id CreateBlockFromJSFunction(Napi::Env env,
     return nil;
   }
 
-  // Prepare the CIF
-  ffi_status ffiStatus = ffi_prep_cif(
-      &blockInfo->cif,
-      FFI_DEFAULT_ABI,
-      static_cast<unsigned int>(blockInfo->argFFIPtrs.size()),
-      blockInfo->returnFFIType,
-      blockInfo->argFFIPtrs.data());
-
-  if (ffiStatus != FFI_OK) {
-    Napi::Error::New(env, "ffi_prep_cif failed for block")
-        .ThrowAsJavaScriptException();
-    ReleaseBlockInfo(blockInfo);
-    return nil;
-  }
-
   // Prepare the closure
-  ffiStatus = ffi_prep_closure_loc(
+  ffi_status ffiStatus = ffi_prep_closure_loc(
       blockInfo->closure,
-      &blockInfo->cif,
+      const_cast<ffi_cif *>(&compiled->cif),
       BlockInvokeCallback,
       blockInfo,  // userdata = BlockInfo*
       codePtr);
@@ -0,0 +1,23 @@
+#ifndef NOTIFICATION_SUBSCRIPTION_H
+#define NOTIFICATION_SUBSCRIPTION_H
+
+#include <napi.h>
+
+// MARK: - Public API
+
+// Subscribe to notifications with a native block observer.
+// Arguments:
+//   - name (string | null): Notification name, or null for all notifications
+//   - object (ObjcObject | null): Only deliver notifications from this sender
+//   - keys (string[]): userInfo keys to extract natively
+//   - batchMs (number): Delay before a batch is delivered (0 = next tick)
+//   - center (ObjcObject | null): Notification center (default center if null)
+//   - callback (function): Receives an array of notification records per batch
+// Returns: An opaque subscription handle for Unsubscribe
+Napi::Value SubscribeNotification(const Napi::CallbackInfo &info);
+
+// Remove the observer registered by SubscribeNotification. Idempotent.
+// Arguments: handle
+Napi::Value Unsubscribe(const Napi::CallbackInfo &info);
+
+#endif // NOTIFICATION_SUBSCRIPTION_H
@@ -0,0 +1,176 @@
+#include "notification-subscription.h"
+#include "batch-delivery.h"
+#include "debug.h"
+#include "foundation-values.h"
+#include "ObjcObject.h"
+#include "string-utils.h"
+#include <Foundation/Foundation.h>
+#include <memory>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+// MARK: - Notification Records
+
+// One posted notification, reduced to the fields JS asked for.
+// Object members are retained while the record is queued.
+struct NotificationRecord {
+  id name = nil;
+  id object = nil;
+  std::vector<id> values; // one per requested userInfo key (nil if absent)
+};
+
+static void DisposeNotificationRecord(NotificationRecord &record) {
+  if (record.name) objc_release(record.name);
+  if (record.object) objc_release(record.object);
+  for (id value : record.values) {
+    if (value) objc_release(value);
+  }
+  record.name = nil;
+  record.object = nil;
+  record.values.clear();
+}
+
+using NotificationDelivery = BatchDelivery<NotificationRecord>;
+
+// MARK: - Subscription
+
+struct NotificationSubscription {
+  NSNotificationCenter *center = nil;
+  id token = nil;  // opaque observer returned by addObserverForName:
+  id object = nil; // sender filter, retained so the pointer stays meaningful
+  std::shared_ptr<NotificationDelivery> delivery;
+
+  void Stop() {
+    if (token == nil) {
+      return;
+    }
+    @autoreleasepool {
+      [center removeObserver:token];
+    }
+    delivery->Stop();
+    objc_release(token);
+    if (object) objc_release(object);
+    [center release];
+    token = nil;
+    object = nil;
+    center = nil;
+  }
+};
+
+// MARK: - Exported Functions
+
+Napi::Value SubscribeNotification(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 6 || !info[2].IsArray() || !info[3].IsNumber() ||
+      !info[5].IsFunction()) {
+    throw Napi::TypeError::New(
+        env, "Expected (name, object, keys, batchMs, center, callback)");
+  }
+
+  // Validate before entering the pool: a C++ throw inside @autoreleasepool
+  // skips the pop under MRC.
+  if (!info[0].IsString() && !info[0].IsNull() && !info[0].IsUndefined()) {
+    throw Napi::TypeError::New(env, "Notification name must be a string or null");
+  }
+
+  id object = nil;
+  if (info[1].IsObject() && ObjcObject::IsInstance(env, info[1])) {
+    object = ObjcObject::UnwrapObject(env, info[1]);
+  } else if (!info[1].IsNull() && !info[1].IsUndefined()) {
+    throw Napi::TypeError::New(env, "Sender must be an ObjcObject or null");
+  }
+
+  id customCenter = nil;
+  if (info[4].IsObject() && ObjcObject::IsInstance(env, info[4])) {
+    customCenter = ObjcObject::UnwrapObject(env, info[4]);
+  } else if (!info[4].IsNull() && !info[4].IsUndefined()) {
+    throw Napi::TypeError::New(env, "Center must be an ObjcObject or null");
+  }
+
+  Napi::Array keysArray = info[2].As<Napi::Array>();
+  std::vector<std::string> keyNames;
+  for (uint32_t i = 0; i < keysArray.Length(); i++) {
+    Napi::Value key = keysArray.Get(i);
+    if (!key.IsString()) {
+      throw Napi::TypeError::New(env, "userInfo keys must be strings");
+    }
+    keyNames.push_back(key.As<Napi::String>().Utf8Value());
+  }
+
+  double batchMs = info[3].As<Napi::Number>().DoubleValue();
+  uint32_t delayMs = batchMs > 0 ? static_cast<uint32_t>(batchMs) : 0;
+
+  auto toJS = [keyNames](Napi::Env env, NotificationRecord &record) -> Napi::Value {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("name", FoundationValueToJS(env, record.name));
+    obj.Set("object", record.object ? ObjcObject::NewInstance(env, record.object)
+                                    : env.Null());
+    Napi::Object userInfo = Napi::Object::New(env);
+    for (size_t i = 0; i < keyNames.size() && i < record.values.size(); i++) {
+      if (record.values[i]) {
+        userInfo.Set(keyNames[i], FoundationValueToJS(env, record.values[i]));
+      }
+    }
+    obj.Set("userInfo", userInfo);
+    return obj;
+  };
+
+  // Everything that can throw runs before the pool, and the subscription is
+  // owned by a unique_ptr until the External takes it.
+  NSString *name = info[0].IsString() ? JSStringToNSString(env, info[0]) : nil;
+  NSMutableArray *keys = [NSMutableArray arrayWithCapacity:keysArray.Length()];
+  for (uint32_t i = 0; i < keysArray.Length(); i++) {
+    [keys addObject:JSStringToNSString(env, keysArray.Get(i))];
+  }
+
+  std::shared_ptr<NotificationDelivery> delivery = NotificationDelivery::Create(
+      env, info[5].As<Napi::Function>(), delayMs, toJS,
+      DisposeNotificationRecord);
+  auto subscription = std::make_unique<NotificationSubscription>();
+  subscription->delivery = delivery;
+
+  @autoreleasepool {
+    NSNotificationCenter *center =
+        customCenter != nil ? customCenter : [NSNotificationCenter defaultCenter];
+
+    // queue:nil runs the block synchronously on the posting thread. It only
+    // copies out the requested values, so posters are never held up by JS.
+    id token = [center
+        addObserverForName:name
+                    object:object
+                     queue:nil
+                usingBlock:^(NSNotification *note) {
+                  NotificationRecord record;
+                  record.name = objc_retain([note name]);
+                  id sender = [note object];
+                  record.object = sender ? objc_retain(sender) : nil;
+                  NSDictionary *userInfo = [note userInfo];
+                  record.values.reserve([keys count]);
+                  for (NSString *key in keys) {
+                    id value = [userInfo objectForKey:key];
+                    record.values.push_back(value ? objc_retain(value) : nil);
+                  }
+                  delivery->Enqueue(std::move(record));
+                }];
+
+    subscription->center = [center retain];
+    subscription->token = objc_retain(token);
+    subscription->object = object ? objc_retain(object) : nil;
+  }
+
+  return Napi::External<NotificationSubscription>::New(
+      env, subscription.release(), [](Napi::Env, NotificationSubscription *sub) {
+        sub->Stop();
+        delete sub;
+      });
+}
+
+Napi::Value Unsubscribe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsExternal()) {
+    throw Napi::TypeError::New(env, "Expected a subscription handle");
+  }
+  info[0].As<Napi::External<NotificationSubscription>>().Data()->Stop();
+  return env.Undefined();
+}
@@ -0,0 +1,21 @@
+#ifndef PARALLEL_SEND_H
+#define PARALLEL_SEND_H
+
+#include <napi.h>
+
+// MARK: - Parallel Send Map
+
+// Send a prepared zero-argument selector to every receiver, spreading the
+// receivers across worker threads. The caller guarantees the method is
+// thread-safe. Blocks the JS thread until all workers have joined.
+// Arguments:
+//   - handle (External<PreparedSend>): From $prepareSend on any receiver
+//   - receivers (ObjcObject[]): Objects to send the message to
+//   - out (TypedArray | null): Destination for numeric results. When null,
+//     numeric results are returned in a new Float64Array.
+//   - threads (number): Maximum worker count (0 = number of active CPUs)
+// Returns: The TypedArray for numeric/BOOL returns, an array of ObjcObject
+//   (or null) for object returns, or undefined for void returns.
+Napi::Value ParallelSendMap(const Napi::CallbackInfo &info);
+
+#endif // PARALLEL_SEND_H
@@ -0,0 +1,354 @@
+#include "parallel-send.h"
+#include "ObjcObject.h"
+#include "call-profiler.h"
+#include "call-trace.h"
+#include "constants.h"
+#include "type-conversion.h"
+#include <Foundation/Foundation.h>
+#include <algorithm>
+#include <atomic>
+#include <dispatch/dispatch.h>
+#include <format>
+#include <mutex>
+#include <napi.h>
+#include <objc/message.h>
+#include <string>
+#include <vector>
+
+// MARK: - Result Classification
+
+enum class ParallelResultKind { Void, Integer, Float, Double, Object };
+
+static bool ClassifyParallelReturn(char typeCode, ParallelResultKind &kind) {
+  switch (typeCode) {
+    case 'v': kind = ParallelResultKind::Void; return true;
+    case 'f': kind = ParallelResultKind::Float; return true;
+    case 'd': kind = ParallelResultKind::Double; return true;
+    case '@': case '#': kind = ParallelResultKind::Object; return true;
+    case 'c': case 'i': case 's': case 'l': case 'q':
+    case 'C': case 'I': case 'S': case 'L': case 'Q':
+    case 'B':
+      kind = ParallelResultKind::Integer;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static inline bool IsUnsignedTypeCode(char typeCode) {
+  return typeCode == 'C' || typeCode == 'I' || typeCode == 'S' ||
+         typeCode == 'L' || typeCode == 'Q' || typeCode == 'B';
+}
+
+/**
+ * Narrow a raw register return to its declared width. Only the low bits of
+ * sub-word returns are defined by the ABI, so they must be truncated and
+ * then sign- or zero-extended according to the type code.
+ */
+static inline uint64_t NormalizeIntegerReturn(uintptr_t raw, char typeCode) {
+  switch (typeCode) {
+    case 'B': return (raw & 0xff) != 0 ? 1 : 0;
+    case 'c': return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(raw)));
+    case 's': return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(raw)));
+    case 'i': return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(raw)));
+    case 'C': return static_cast<uint8_t>(raw);
+    case 'S': return static_cast<uint16_t>(raw);
+    case 'I': return static_cast<uint32_t>(raw);
+    default:  return static_cast<uint64_t>(raw);
+  }
+}
+
+static inline bool IsIntegerTypedArray(napi_typedarray_type type) {
+  return type != napi_float32_array && type != napi_float64_array;
+}
+
+static inline void StoreIntegerResult(void *data, napi_typedarray_type type,
+                                      size_t index, uint64_t bits,
+                                      bool isUnsigned) {
+  switch (type) {
+    case napi_int8_array: static_cast<int8_t *>(data)[index] = static_cast<int8_t>(bits); break;
+    case napi_uint8_array: static_cast<uint8_t *>(data)[index] = static_cast<uint8_t>(bits); break;
+    case napi_uint8_clamped_array: {
+      int64_t value = static_cast<int64_t>(bits);
+      if (!isUnsigned && value < 0) value = 0;
+      static_cast<uint8_t *>(data)[index] =
+          (isUnsigned ? bits > 255 : value > 255) ? 255 : static_cast<uint8_t>(value);
+      break;
+    }
+    case napi_int16_array: static_cast<int16_t *>(data)[index] = static_cast<int16_t>(bits); break;
+    case napi_uint16_array: static_cast<uint16_t *>(data)[index] = static_cast<uint16_t>(bits); break;
+    case napi_int32_array: static_cast<int32_t *>(data)[index] = static_cast<int32_t>(bits); break;
+    case napi_uint32_array: static_cast<uint32_t *>(data)[index] = static_cast<uint32_t>(bits); break;
+    case napi_bigint64_array: static_cast<int64_t *>(data)[index] = static_cast<int64_t>(bits); break;
+    case napi_biguint64_array: static_cast<uint64_t *>(data)[index] = bits; break;
+    case napi_float32_array:
+      static_cast<float *>(data)[index] = isUnsigned
+          ? static_cast<float>(bits) : static_cast<float>(static_cast<int64_t>(bits));
+      break;
+    case napi_float64_array:
+      static_cast<double *>(data)[index] = isUnsigned
+          ? static_cast<double>(bits) : static_cast<double>(static_cast<int64_t>(bits));
+      break;
+  }
+}
+
+static inline void StoreFloatingResult(void *data, napi_typedarray_type type,
+                                       size_t index, double value) {
+  if (type == napi_float32_array) {
+    static_cast<float *>(data)[index] = static_cast<float>(value);
+  } else {
+    static_cast<double *>(data)[index] = value;
+  }
+}
+
+// MARK: - Worker
+
+/**
+ * Shared state for one ParallelSendMap call. Lives on the JS thread's stack
+ * for the duration of dispatch_apply, which does not return until every
+ * worker has finished.
+ */
+struct ParallelSendJob {
+  SEL selector;
+  char returnTypeCode;
+  ParallelResultKind kind;
+  const std::vector<id> *receivers;
+  void *outData = nullptr;
+  napi_typedarray_type outType = napi_float64_array;
+  std::vector<id> *objectResults = nullptr;
+
+  std::atomic<size_t> nextIndex{0};
+  std::atomic<bool> failed{false};
+  std::mutex errorMutex;
+  std::string errorMessage;
+};
+
+static void SendToReceiver(ParallelSendJob &job, size_t index) {
+  id receiver = (*job.receivers)[index];
+  SEL selector = job.selector;
+  nobjc::ProfiledCall profiled(receiver, selector);
+  nobjc::TraceMethodCall(nobjc::TraceKind::Send, object_getClass(receiver),
+                         selector, [&] {
+                           return [receiver methodSignatureForSelector:selector];
+                         });
+  switch (job.kind) {
+    case ParallelResultKind::Void:
+      ((void (*)(id, SEL))objc_msgSend)(receiver, selector);
+      break;
+    case ParallelResultKind::Float: {
+      float result = ((float (*)(id, SEL))objc_msgSend)(receiver, selector);
+      StoreFloatingResult(job.outData, job.outType, index, result);
+      break;
+    }
+    case ParallelResultKind::Double: {
+      double result = ((double (*)(id, SEL))objc_msgSend)(receiver, selector);
+      StoreFloatingResult(job.outData, job.outType, index, result);
+      break;
+    }
+    case ParallelResultKind::Integer: {
+      uintptr_t raw = ((uintptr_t (*)(id, SEL))objc_msgSend)(receiver, selector);
+      StoreIntegerResult(job.outData, job.outType, index,
+                         NormalizeIntegerReturn(raw, job.returnTypeCode),
+                         IsUnsignedTypeCode(job.returnTypeCode));
+      break;
+    }
+    case ParallelResultKind::Object: {
+      id result = ((id (*)(id, SEL))objc_msgSend)(receiver, selector);
+      // Retain before the chunk's autorelease pool drains; the JS thread
+      // wraps and balances this after the join.
+      (*job.objectResults)[index] = result ? objc_retain(result) : nil;
+      break;
+    }
+  }
+}
+
+/**
+ * dispatch_apply_f worker. Each worker repeatedly claims the next chunk of
+ * receivers until none are left, so faster workers pick up the slack from
+ * slower ones. Every chunk runs in its own autorelease pool.
+ */
+static void RunParallelSendWorker(void *context, size_t) {
+  auto &job = *static_cast<ParallelSendJob *>(context);
+  const size_t count = job.receivers->size();
+  for (;;) {
+    if (job.failed.load(std::memory_order_relaxed)) return;
+    size_t start = job.nextIndex.fetch_add(nobjc::kParallelSendChunkSize,
+                                           std::memory_order_relaxed);
+    if (start >= count) return;
+    size_t end = std::min(start + nobjc::kParallelSendChunkSize, count);
+    @autoreleasepool {
+      size_t index = start;
+      @try {
+        for (; index < end; index++) {
+          SendToReceiver(job, index);
+        }
+      } @catch (NSException *exception) {
+        std::lock_guard<std::mutex> lock(job.errorMutex);
+        if (!job.failed.exchange(true)) {
+          job.errorMessage = std::format(
+              "parallelSendMap: receiver {} raised {}: {}", index,
+              [[exception name] UTF8String] ?: "NSException",
+              [[exception reason] UTF8String] ?: "");
+        }
+      }
+    }
+  }
+}
+
+// MARK: - Exported Function
+
+Napi::Value ParallelSendMap(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 4 || !info[0].IsExternal() || !info[1].IsArray() ||
+      !info[3].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected (handle, receivers, out, threads)");
+  }
+
+  PreparedSend *prepared = info[0].As<Napi::External<PreparedSend>>().Data();
+  if (prepared == nullptr) {
+    throw Napi::Error::New(env, "parallelSendMap: invalid handle");
+  }
+  const char *selectorName = sel_getName(prepared->selector);
+  if (prepared->expectedArgCount != 0) {
+    throw Napi::TypeError::New(
+        env, std::format("parallelSendMap: {} takes arguments; only "
+                         "zero-argument selectors are supported",
+                         selectorName));
+  }
+  ParallelResultKind kind;
+  if (prepared->isStructReturn ||
+      !ClassifyParallelReturn(prepared->fastReturnTypeCode, kind)) {
+    throw Napi::TypeError::New(
+        env, std::format("parallelSendMap: unsupported return type {} for {}",
+                         prepared->returnType, selectorName));
+  }
+
+  // Unwrap receivers on the JS thread. The JS array keeps every wrapper
+  // (and therefore every retained receiver) alive until we return.
+  Napi::Array receiversArray = info[1].As<Napi::Array>();
+  const uint32_t count = receiversArray.Length();
+  std::vector<id> receivers(count, nil);
+  // The cast on the workers comes from the handle's class. Every other
+  // receiver class must declare the same return type, or the send would go
+  // through the wrong objc_msgSend cast. Checked once per class.
+  std::vector<Class> checkedClasses;
+  for (uint32_t i = 0; i < count; i++) {
+    Napi::Value value = receiversArray.Get(i);
+    if (value.IsNull() || value.IsUndefined()) {
+      continue; // messaging nil yields zero / nil
+    }
+    if (!ObjcObject::IsInstance(env, value)) {
+      throw Napi::TypeError::New(
+          env, std::format("parallelSendMap: receiver {} is not an ObjcObject", i));
+    }
+    id receiver = ObjcObject::UnwrapObject(env, value);
+    if (![receiver respondsToSelector:prepared->selector]) {
+      throw Napi::TypeError::New(
+          env, std::format("parallelSendMap: receiver {} ({}) does not respond to {}",
+                           i, object_getClassName(receiver), selectorName));
+    }
+    Class receiverClass = object_getClass(receiver);
+    if (std::find(checkedClasses.begin(), checkedClasses.end(), receiverClass) ==
+        checkedClasses.end()) {
+      NSMethodSignature *signature =
+          [receiver methodSignatureForSelector:prepared->selector];
+      const char *returnType =
+          signature != nil ? SimplifyTypeEncoding([signature methodReturnType])
+                           : "";
+      if (*returnType != prepared->fastReturnTypeCode) {
+        throw Napi::TypeError::New(
+            env, std::format("parallelSendMap: receiver {} ({}) returns {} from "
+                             "{}, expected {}",
+                             i, object_getClassName(receiver),
+                             *returnType != '\0' ? returnType : "unknown",
+                             selectorName, prepared->returnType));
+      }
+      checkedClasses.push_back(receiverClass);
+    }
+    receivers[i] = receiver;
+  }
+
+  ParallelSendJob job;
+  job.selector = prepared->selector;
+  job.returnTypeCode = prepared->fastReturnTypeCode;
+  job.kind = kind;
+  job.receivers = &receivers;
+
+  const bool isNumeric = kind == ParallelResultKind::Integer ||
+                         kind == ParallelResultKind::Float ||
+                         kind == ParallelResultKind::Double;
+  Napi::Value result = env.Undefined();
+  std::vector<id> objectResults;
+
+  if (isNumeric) {
+    Napi::Value out = info[2];
+    if (out.IsNull() || out.IsUndefined()) {
+      out = Napi::Float64Array::New(env, count);
+    } else if (!out.IsTypedArray()) {
+      throw Napi::TypeError::New(env, "parallelSendMap: out must be a TypedArray");
+    }
+    size_t length = 0;
+    napi_typedarray_type type;
+    void *data = nullptr;
+    napi_status status = napi_get_typedarray_info(env, out, &type, &length,
+                                                  &data, nullptr, nullptr);
+    NAPI_THROW_IF_FAILED(env, status, env.Undefined());
+    if (length < count) {
+      throw Napi::RangeError::New(
+          env, std::format("parallelSendMap: out has {} element(s), need {}",
+                           length, count));
+    }
+    if (kind != ParallelResultKind::Integer && IsIntegerTypedArray(type)) {
+      throw Napi::TypeError::New(
+          env, "parallelSendMap: floating-point results require a Float32Array "
+               "or Float64Array");
+    }
+    job.outData = data;
+    job.outType = type;
+    result = out;
+  } else if (kind == ParallelResultKind::Object) {
+    objectResults.assign(count, nil);
+    job.objectResults = &objectResults;
+  }
+
+  if (count > 0) {
+    size_t threads = static_cast<size_t>(
+        std::max(0.0, info[3].As<Napi::Number>().DoubleValue()));
+    if (threads == 0) {
+      threads = [[NSProcessInfo processInfo] activeProcessorCount];
+    }
+    const size_t chunks = (count + nobjc::kParallelSendChunkSize - 1) /
+                          nobjc::kParallelSendChunkSize;
+    const size_t workers = std::max<size_t>(1, std::min(threads, chunks));
+    dispatch_apply_f(workers,
+                     dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0),
+                     &job, RunParallelSendWorker);
+  }
+
+  if (kind == ParallelResultKind::Object) {
+    auto releaseResults = [&objectResults] {
+      for (id obj : objectResults) {
+        if (obj) objc_release(obj);
+      }
+    };
+    if (job.failed.load()) {
+      releaseResults();
+    } else {
+      Napi::Array array = Napi::Array::New(env, count);
+      for (uint32_t i = 0; i < count; i++) {
+        // Retained: the worker's +1 released below may be the only owner.
+        array.Set(i, objectResults[i]
+                         ? ObjcObject::NewInstance(env, objectResults[i],
+                                                   WrapMode::Retained)
+                         : env.Null());
+      }
+      releaseResults();
+      result = array;
+    }
+  }
+
+  if (job.failed.load()) {
+    throw Napi::Error::New(env, job.errorMessage);
+  }
+  return result;
+}
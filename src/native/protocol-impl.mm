@@ -136,7 +136,8 @@ Napi::Value CreateProtocolImplementation(const Napi::CallbackInfo &info) {
       .className = className,
       .env = env,
       .js_thread = pthread_self(), // Store the current (JS) thread ID
-      .isElectron = isElectron
+      .isElectron = isElectron,
+      .dispatcher = nobjc::CallbackDispatcher::ForEnv(env),
   };
 
   // Store default type encodings to keep them alive
@@ -202,6 +203,10 @@ Napi::Value CreateProtocolImplementation(const Napi::CallbackInfo &info) {
             selectorName.c_str(), typeEncoding);
     }
 
+    // Resolve the timeout before creating the TSFN (this may throw)
+    CallbackDeadline deadline = CallbackDeadlineForFunction(
+        jsCallback, SimplifiedTypeEncoding(typeEncoding)[0]);
+
     // Create a ThreadSafeFunction for this callback
     Napi::ThreadSafeFunction tsfn = CreateMethodTSFN(env, jsCallback,
                                                       "ProtocolCallback");
@@ -211,6 +216,9 @@ Napi::Value CreateProtocolImplementation(const Napi::CallbackInfo &info) {
         .tsfn = tsfn,
         .jsCallback = Napi::Persistent(jsCallback),
         .typeEncoding = std::string(typeEncoding),
+        .lane = nobjc::CallbackLaneForFunction(jsCallback,
+                                               nobjc::CallbackLane::Blocking),
+        .deadline = deadline,
     };
   }
 
@@ -1,7 +1,10 @@
 #ifndef PROTOCOL_STORAGE_H
 #define PROTOCOL_STORAGE_H
 
+#include "callback-deadline.h"
+#include "callback-dispatcher.h"
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <napi.h>
 #include <objc/runtime.h>
@@ -39,11 +42,10 @@ struct InvocationData {
   std::string typeEncoding;
   // Type of callback (protocol or subclass)
   CallbackType callbackType;
-  // Synchronization: we use NonBlockingCall + runloop pumping to avoid
-  // deadlocks in Electron while still getting return values
-  std::mutex *completionMutex;
-  std::condition_variable *completionCv;
-  bool *isComplete;
+  // Synchronization: we queue the call + pump the runloop to avoid
+  // deadlocks in Electron while still getting return values. Shared with the
+  // waiting thread, which may give up first (null on the direct path).
+  std::shared_ptr<CallCompletion> completion;
   // For subclass method calls: the instance pointer (for super calls)
   void *instancePtr;
   // For subclass method calls: the superclass for super calls
@@ -55,6 +57,10 @@ struct ProtocolMethodInfo {
   Napi::ThreadSafeFunction tsfn;
   Napi::FunctionReference jsCallback;
   std::string typeEncoding;
+  // Dispatcher lane for calls arriving from other threads
+  nobjc::CallbackLane lane = nobjc::CallbackLane::Blocking;
+  // How long a calling thread waits, and what it returns on timeout
+  CallbackDeadline deadline;
 };
 
 // Stores information about a protocol implementation instance
@@ -69,6 +75,8 @@ struct ProtocolImplementation {
   pthread_t js_thread;
   // Flag to indicate if running in Electron (requires TSFN path always)
   bool isElectron;
+  // Delivers calls made on other threads to the JS thread
+  std::shared_ptr<nobjc::CallbackDispatcher> dispatcher;
 };
 
 // MARK: - Subclass Storage
@@ -80,6 +88,10 @@ struct SubclassMethodInfo {
   std::string typeEncoding;
   std::string selectorName;
   bool isClassMethod;
+  // Dispatcher lane for calls arriving from other threads
+  nobjc::CallbackLane lane = nobjc::CallbackLane::Blocking;
+  // How long a calling thread waits, and what it returns on timeout
+  CallbackDeadline deadline;
 };
 
 // Stores information about a JS-defined subclass
@@ -98,6 +110,8 @@ struct SubclassImplementation {
   pthread_t js_thread;
   // Flag to indicate if running in Electron
   bool isElectron;
+  // Delivers calls made on other threads to the JS thread
+  std::shared_ptr<nobjc::CallbackDispatcher> dispatcher;
 };
 
 // MARK: - Global Storage (DEPRECATED - use ProtocolManager/SubclassManager instead)
@@ -114,10 +128,8 @@ struct SubclassImplementation {
 
 // Helper to signal completion of an invocation
 inline void SignalInvocationComplete(InvocationData *data) {
-  if (data->completionMutex && data->completionCv && data->isComplete) {
-    std::lock_guard<std::mutex> lock(*data->completionMutex);
-    *data->isComplete = true;
-    data->completionCv->notify_one();
+  if (data->completion) {
+    data->completion->Finish();
   }
 }
 
@@ -0,0 +1,43 @@
+#ifndef STREAM_ADAPTERS_H
+#define STREAM_ADAPTERS_H
+
+#include <napi.h>
+
+// MARK: - NSInputStream -> Readable
+
+// Start a reader thread for an NSInputStream.
+// Arguments:
+//   - stream (ObjcObject): The NSInputStream (opened if not already open)
+//   - chunkSize (number | undefined): Bytes per read:maxLength: call;
+//     kDefaultStreamChunkSize when undefined or below 1
+//   - onChunk (function): Called with (Buffer) per chunk, (null) at end of
+//     stream, or (undefined, message) on error
+// Returns: An opaque reader handle
+Napi::Value InputStreamOpen(const Napi::CallbackInfo &info);
+
+// Grant the reader one chunk of credit (called from Readable._read).
+// Arguments: handle
+Napi::Value InputStreamRead(const Napi::CallbackInfo &info);
+
+// Stop the reader thread and close the stream. Idempotent.
+// Arguments: handle
+Napi::Value InputStreamClose(const Napi::CallbackInfo &info);
+
+// MARK: - Writable -> NSOutputStream
+
+// Start a writer thread for an NSOutputStream.
+// Arguments:
+//   - stream (ObjcObject): The NSOutputStream (opened if not already open)
+//   - onComplete (function): Called with (requestId, errorMessage | null)
+// Returns: An opaque writer handle
+Napi::Value OutputStreamOpen(const Napi::CallbackInfo &info);
+
+// Queue Buffers to be written. The Buffers are referenced, not copied.
+// Arguments: handle, buffers (Buffer[]), requestId (number)
+Napi::Value OutputStreamWrite(const Napi::CallbackInfo &info);
+
+// Flush queued writes, then close the stream. Idempotent.
+// Arguments: handle, requestId (number)
+Napi::Value OutputStreamClose(const Napi::CallbackInfo &info);
+
+#endif // STREAM_ADAPTERS_H
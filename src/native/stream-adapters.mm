@@ -0,0 +1,598 @@
+#include "stream-adapters.h"
+#include "constants.h"
+#include "debug.h"
+#include "ObjcObject.h"
+#include <Foundation/Foundation.h>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Both adapters do their blocking Foundation I/O on a dedicated thread, so the
+// JS thread only ever sees finished chunks/completions delivered through a
+// ThreadSafeFunction. The TSFN is ref'd only while work is outstanding, so an
+// idle (paused) stream does not keep the process alive.
+
+static std::string StreamErrorMessage(NSStream *stream, const char *fallback) {
+  NSError *error = [stream streamError];
+  if (error != nil) {
+    const char *message = [[error localizedDescription] UTF8String];
+    if (message) return message;
+  }
+  return fallback;
+}
+
+static id UnwrapStreamArgument(Napi::Env env, const Napi::Value &value,
+                               Class expected, const char *message) {
+  if (!value.IsObject() || !ObjcObject::IsInstance(env, value)) {
+    throw Napi::TypeError::New(env, message);
+  }
+  id obj = ObjcObject::UnwrapObject(env, value);
+  if (obj == nil || ![obj isKindOfClass:expected]) {
+    throw Napi::TypeError::New(env, message);
+  }
+  return obj;
+}
+
+// MARK: - Input Stream Reader
+
+// The reader thread schedules the stream on its own run loop and only reads
+// after the stream reports bytes, end or an error, so it never sits in a
+// blocking read:maxLength: on an idle pipe or socket. Read and close wake the
+// run loop with CFRunLoopStop. Streams that cannot be scheduled fall back to
+// waiting on `cv` and reading directly.
+
+struct InputStreamReader {
+  NSInputStream *stream = nil;
+  size_t chunkSize = nobjc::kDefaultStreamChunkSize;
+  Napi::ThreadSafeFunction tsfn;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t credits = 0;
+  bool closing = false;
+  CFRunLoopRef runLoop = nullptr; // reader thread's, retained
+  std::vector<uint8_t *> pool;    // idle chunk buffers
+
+  // Reader thread only
+  bool readable = false;      // a stream event arrived since the last read
+  bool directReads = false;   // the stream is not run-loop driven
+  bool done = false;
+
+  // JS-thread only
+  uint32_t outstanding = 0;
+  bool finished = false;
+
+  ~InputStreamReader() {
+    for (uint8_t *buffer : pool) {
+      delete[] buffer;
+    }
+    if (runLoop != nullptr) {
+      CFRelease(runLoop);
+    }
+    [stream release];
+  }
+
+  // Make the reader thread re-check `credits` and `closing`. Caller holds
+  // `mutex`.
+  void WakeLocked() {
+    if (runLoop != nullptr) {
+      CFRunLoopStop(runLoop);
+    }
+    cv.notify_one();
+  }
+
+  uint8_t *AcquireBuffer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!pool.empty()) {
+        uint8_t *buffer = pool.back();
+        pool.pop_back();
+        return buffer;
+      }
+    }
+    return new uint8_t[chunkSize];
+  }
+
+  void RecycleBuffer(uint8_t *buffer) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (pool.size() < nobjc::kStreamBufferPoolSize) {
+        pool.push_back(buffer);
+        return;
+      }
+    }
+    delete[] buffer;
+  }
+};
+
+struct ReaderChunk {
+  std::shared_ptr<InputStreamReader> reader;
+  uint8_t *bytes = nullptr;
+  size_t length = 0;
+  bool eof = false;
+  bool failed = false;
+  std::string error;
+};
+
+// Finalizer hint for pooled Buffers handed to JS: the chunk goes back to the
+// reader's pool once JS drops the Buffer.
+struct PooledBufferHint {
+  std::shared_ptr<InputStreamReader> reader;
+  uint8_t *bytes;
+};
+
+static void DeliverChunk(Napi::Env env, Napi::Function callback,
+                         ReaderChunk *chunk) {
+  std::unique_ptr<ReaderChunk> owned(chunk);
+  InputStreamReader *reader = chunk->reader.get();
+  if (env == nullptr || callback.IsEmpty()) {
+    if (chunk->bytes) reader->RecycleBuffer(chunk->bytes);
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  if (reader->outstanding > 0 && --reader->outstanding == 0) {
+    reader->tsfn.Unref(env);
+  }
+
+  Napi::Value arg;
+  if (chunk->failed) {
+    reader->finished = true;
+    try {
+      callback.Call({env.Undefined(), Napi::String::New(env, chunk->error)});
+    } catch (const Napi::Error &e) {
+      NOBJC_ERROR("InputStream: error in JS callback: %s", e.what());
+    }
+    return;
+  }
+  if (chunk->eof) {
+    reader->finished = true;
+    arg = env.Null();
+  } else {
+    auto *hint = new PooledBufferHint{chunk->reader, chunk->bytes};
+    napi_value buffer;
+    napi_status status = napi_create_external_buffer(
+        env, chunk->length, chunk->bytes,
+        [](napi_env, void *, void *data) {
+          auto *hint = static_cast<PooledBufferHint *>(data);
+          hint->reader->RecycleBuffer(hint->bytes);
+          delete hint;
+        },
+        hint, &buffer);
+    if (status == napi_ok) {
+      arg = Napi::Value(env, buffer);
+    } else {
+      // External buffers are unavailable (Electron); copy and reuse now.
+      delete hint;
+      arg = Napi::Buffer<uint8_t>::Copy(env, chunk->bytes, chunk->length);
+      reader->RecycleBuffer(chunk->bytes);
+    }
+  }
+
+  try {
+    callback.Call({arg});
+  } catch (const Napi::Error &e) {
+    NOBJC_ERROR("InputStream: error in JS callback: %s", e.what());
+  }
+}
+
+@interface NobjcInputStreamDelegate : NSObject <NSStreamDelegate> {
+@public
+  InputStreamReader *reader; // outlives the delegate's registration
+}
+@end
+
+@implementation NobjcInputStreamDelegate
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)event {
+  if (event & (NSStreamEventHasBytesAvailable | NSStreamEventEndEncountered |
+               NSStreamEventErrorOccurred)) {
+    reader->readable = true;
+  }
+}
+
+@end
+
+// Reader thread: true if read:maxLength: will not block.
+static bool StreamIsReadable(InputStreamReader &reader) {
+  if (reader.directReads || reader.readable) {
+    return true;
+  }
+  const NSStreamStatus status = [reader.stream streamStatus];
+  return status == NSStreamStatusAtEnd || status == NSStreamStatusError ||
+         status == NSStreamStatusClosed || [reader.stream hasBytesAvailable];
+}
+
+// Reader thread: read and deliver one chunk per credit while the stream can
+// be read without blocking. Sets `done` at end of stream, on error, or when
+// the TSFN is gone.
+static void PumpReader(const std::shared_ptr<InputStreamReader> &reader) {
+  while (!reader->done) {
+    {
+      std::lock_guard<std::mutex> lock(reader->mutex);
+      if (reader->closing || reader->credits == 0) return;
+    }
+    bool readable;
+    @autoreleasepool {
+      readable = StreamIsReadable(*reader);
+    }
+    if (!readable) return;
+    {
+      std::lock_guard<std::mutex> lock(reader->mutex);
+      reader->credits--;
+    }
+    reader->readable = false;
+
+    auto *chunk = new ReaderChunk();
+    chunk->reader = reader;
+    uint8_t *buffer = reader->AcquireBuffer();
+    NSInteger count;
+    @autoreleasepool {
+      count = [reader->stream read:buffer maxLength:reader->chunkSize];
+      if (count < 0) {
+        chunk->failed = true;
+        chunk->error = StreamErrorMessage(reader->stream, "Stream read failed");
+      }
+    }
+    if (count > 0) {
+      chunk->bytes = buffer;
+      chunk->length = static_cast<size_t>(count);
+    } else {
+      reader->RecycleBuffer(buffer);
+      chunk->eof = (count == 0);
+    }
+
+    reader->done = count <= 0;
+    if (reader->tsfn.NonBlockingCall(chunk, DeliverChunk) != napi_ok) {
+      if (chunk->bytes) reader->RecycleBuffer(chunk->bytes);
+      delete chunk;
+      reader->done = true;
+    }
+  }
+}
+
+static void RunReaderThread(std::shared_ptr<InputStreamReader> reader) {
+  NobjcInputStreamDelegate *delegate = [[NobjcInputStreamDelegate alloc] init];
+  delegate->reader = reader.get();
+  @autoreleasepool {
+    [reader->stream setDelegate:delegate];
+    [reader->stream scheduleInRunLoop:[NSRunLoop currentRunLoop]
+                              forMode:NSDefaultRunLoopMode];
+    if ([reader->stream streamStatus] == NSStreamStatusNotOpen) {
+      [reader->stream open];
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    reader->runLoop = static_cast<CFRunLoopRef>(CFRetain(CFRunLoopGetCurrent()));
+  }
+
+  while (true) {
+    PumpReader(reader);
+    if (reader->done) break;
+    {
+      std::unique_lock<std::mutex> lock(reader->mutex);
+      if (reader->closing) break;
+      if (reader->directReads) {
+        reader->cv.wait(lock,
+                        [&] { return reader->credits > 0 || reader->closing; });
+        continue;
+      }
+    }
+    // Returns on a stream event, or when Read/Close call CFRunLoopStop.
+    const CFRunLoopRunResult result = CFRunLoopRunInMode(
+        kCFRunLoopDefaultMode, nobjc::kStreamReaderRunLoopSeconds, true);
+    if (result == kCFRunLoopRunFinished) {
+      reader->directReads = true; // nothing scheduled: not run-loop driven
+    }
+  }
+
+  @autoreleasepool {
+    [reader->stream removeFromRunLoop:[NSRunLoop currentRunLoop]
+                              forMode:NSDefaultRunLoopMode];
+    [reader->stream setDelegate:nil];
+    [reader->stream close];
+  }
+  [delegate release];
+  reader->tsfn.Release();
+}
+
+Napi::Value InputStreamOpen(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 3 ||
+      !(info[1].IsNumber() || info[1].IsUndefined()) || !info[2].IsFunction()) {
+    throw Napi::TypeError::New(env, "Expected (stream, chunkSize, onChunk)");
+  }
+  id stream = UnwrapStreamArgument(env, info[0], [NSInputStream class],
+                                   "First argument must be an NSInputStream");
+  double chunkSize =
+      info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : 0;
+
+  auto reader = std::make_shared<InputStreamReader>();
+  reader->stream = [stream retain];
+  if (chunkSize >= 1) {
+    reader->chunkSize = static_cast<size_t>(chunkSize);
+  }
+  reader->tsfn = Napi::ThreadSafeFunction::New(
+      env, info[2].As<Napi::Function>(), "InputStreamReader", 0, 1);
+  reader->tsfn.Unref(env);
+
+  std::thread(RunReaderThread, reader).detach();
+
+  return Napi::External<std::shared_ptr<InputStreamReader>>::New(
+      env, new std::shared_ptr<InputStreamReader>(reader),
+      [](Napi::Env, std::shared_ptr<InputStreamReader> *ref) {
+        {
+          std::lock_guard<std::mutex> lock((*ref)->mutex);
+          (*ref)->closing = true;
+          (*ref)->WakeLocked();
+        }
+        delete ref;
+      });
+}
+
+static InputStreamReader *GetReader(const Napi::CallbackInfo &info) {
+  if (info.Length() < 1 || !info[0].IsExternal()) {
+    throw Napi::TypeError::New(info.Env(), "Expected a reader handle");
+  }
+  return info[0]
+      .As<Napi::External<std::shared_ptr<InputStreamReader>>>()
+      .Data()
+      ->get();
+}
+
+Napi::Value InputStreamRead(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  InputStreamReader *reader = GetReader(info);
+  if (reader->finished) {
+    return env.Undefined();
+  }
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    if (reader->closing) return env.Undefined();
+    reader->credits++;
+    reader->WakeLocked();
+  }
+  if (reader->outstanding++ == 0) {
+    reader->tsfn.Ref(env);
+  }
+  return env.Undefined();
+}
+
+Napi::Value InputStreamClose(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  InputStreamReader *reader = GetReader(info);
+  {
+    std::lock_guard<std::mutex> lock(reader->mutex);
+    reader->closing = true;
+    reader->WakeLocked();
+  }
+  if (reader->outstanding > 0) {
+    reader->outstanding = 0;
+    reader->tsfn.Unref(env);
+  }
+  reader->finished = true;
+  return env.Undefined();
+}
+
+// MARK: - Output Stream Writer
+
+struct WriteRequest {
+  uint32_t id = 0;
+  bool close = false;
+  std::vector<std::pair<const uint8_t *, size_t>> slices;
+  // Keeps the Buffers alive while the writer thread reads from them.
+  // Created and destroyed on the JS thread only.
+  std::vector<Napi::Reference<Napi::Value>> buffers;
+  std::string error;
+};
+
+struct OutputStreamWriter {
+  NSOutputStream *stream = nil;
+  Napi::ThreadSafeFunction tsfn;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<WriteRequest *> queue;
+
+  // JS-thread only
+  uint32_t outstanding = 0;
+  bool closed = false;
+
+  ~OutputStreamWriter() { [stream release]; }
+};
+
+struct WriterCompletion {
+  std::shared_ptr<OutputStreamWriter> writer;
+  WriteRequest *request;
+};
+
+static void DeliverCompletion(Napi::Env env, Napi::Function callback,
+                              WriterCompletion *completion) {
+  std::unique_ptr<WriterCompletion> owned(completion);
+  std::unique_ptr<WriteRequest> request(completion->request);
+  if (env == nullptr || callback.IsEmpty()) {
+    // Teardown: the references can no longer be released safely.
+    for (auto &buffer : request->buffers) buffer.SuppressDestruct();
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  OutputStreamWriter *writer = completion->writer.get();
+  if (writer->outstanding > 0 && --writer->outstanding == 0) {
+    writer->tsfn.Unref(env);
+  }
+  request->buffers.clear();
+
+  try {
+    callback.Call({Napi::Number::New(env, request->id),
+                   request->error.empty()
+                       ? env.Null()
+                       : Napi::String::New(env, request->error)});
+  } catch (const Napi::Error &e) {
+    NOBJC_ERROR("OutputStream: error in JS callback: %s", e.what());
+  }
+}
+
+static void RunWriterThread(std::shared_ptr<OutputStreamWriter> writer) {
+  @autoreleasepool {
+    if ([writer->stream streamStatus] == NSStreamStatusNotOpen) {
+      [writer->stream open];
+    }
+  }
+
+  bool failed = false;
+  while (true) {
+    WriteRequest *request;
+    {
+      std::unique_lock<std::mutex> lock(writer->mutex);
+      writer->cv.wait(lock, [&] { return !writer->queue.empty(); });
+      request = writer->queue.front();
+      writer->queue.pop_front();
+    }
+
+    @autoreleasepool {
+      if (request->close) {
+        [writer->stream close];
+      } else if (failed) {
+        request->error = "Stream is no longer writable";
+      } else {
+        for (auto &slice : request->slices) {
+          const uint8_t *bytes = slice.first;
+          size_t remaining = slice.second;
+          while (remaining > 0) {
+            NSInteger written = [writer->stream write:bytes
+                                            maxLength:remaining];
+            if (written <= 0) {
+              request->error =
+                  StreamErrorMessage(writer->stream, "Stream write failed");
+              failed = true;
+              break;
+            }
+            bytes += written;
+            remaining -= static_cast<size_t>(written);
+          }
+          if (failed) break;
+        }
+      }
+    }
+
+    bool done = request->close;
+    auto *completion = new WriterCompletion{writer, request};
+    if (writer->tsfn.NonBlockingCall(completion, DeliverCompletion) !=
+        napi_ok) {
+      // The environment is going away; leak the request rather than touch
+      // its JS references off-thread.
+      delete completion;
+      break;
+    }
+    if (done) break;
+  }
+  writer->tsfn.Release();
+}
+
+static OutputStreamWriter *GetWriter(const Napi::CallbackInfo &info) {
+  if (info.Length() < 1 || !info[0].IsExternal()) {
+    throw Napi::TypeError::New(info.Env(), "Expected a writer handle");
+  }
+  return info[0]
+      .As<Napi::External<std::shared_ptr<OutputStreamWriter>>>()
+      .Data()
+      ->get();
+}
+
+static void EnqueueWrite(Napi::Env env, OutputStreamWriter *writer,
+                         WriteRequest *request) {
+  if (writer->outstanding++ == 0) {
+    writer->tsfn.Ref(env);
+  }
+  {
+    std::lock_guard<std::mutex> lock(writer->mutex);
+    writer->queue.push_back(request);
+  }
+  writer->cv.notify_one();
+}
+
+Napi::Value OutputStreamOpen(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 2 || !info[1].IsFunction()) {
+    throw Napi::TypeError::New(env, "Expected (stream, onComplete)");
+  }
+  id stream = UnwrapStreamArgument(env, info[0], [NSOutputStream class],
+                                   "First argument must be an NSOutputStream");
+
+  auto writer = std::make_shared<OutputStreamWriter>();
+  writer->stream = [stream retain];
+  writer->tsfn = Napi::ThreadSafeFunction::New(
+      env, info[1].As<Napi::Function>(), "OutputStreamWriter", 0, 1);
+  writer->tsfn.Unref(env);
+
+  std::thread(RunWriterThread, writer).detach();
+
+  return Napi::External<std::shared_ptr<OutputStreamWriter>>::New(
+      env, new std::shared_ptr<OutputStreamWriter>(writer),
+      [](Napi::Env env, std::shared_ptr<OutputStreamWriter> *ref) {
+        OutputStreamWriter *writer = ref->get();
+        if (!writer->closed) {
+          writer->closed = true;
+          auto *request = new WriteRequest();
+          request->close = true;
+          std::lock_guard<std::mutex> lock(writer->mutex);
+          writer->queue.push_back(request);
+        }
+        writer->cv.notify_one();
+        delete ref;
+      });
+}
+
+Napi::Value OutputStreamWrite(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  OutputStreamWriter *writer = GetWriter(info);
+  if (info.Length() != 3 || !info[1].IsArray() || !info[2].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected (handle, buffers, requestId)");
+  }
+  if (writer->closed) {
+    throw Napi::Error::New(env, "Cannot write to a closed stream");
+  }
+
+  auto *request = new WriteRequest();
+  request->id = info[2].As<Napi::Number>().Uint32Value();
+  Napi::Array buffers = info[1].As<Napi::Array>();
+  for (uint32_t i = 0; i < buffers.Length(); i++) {
+    Napi::Value value = buffers.Get(i);
+    if (!value.IsBuffer()) {
+      delete request;
+      throw Napi::TypeError::New(env, "Expected an array of Buffers");
+    }
+    Napi::Buffer<uint8_t> buffer = value.As<Napi::Buffer<uint8_t>>();
+    request->slices.emplace_back(buffer.Data(), buffer.Length());
+    request->buffers.push_back(Napi::Persistent(value));
+  }
+
+  EnqueueWrite(env, writer, request);
+  return env.Undefined();
+}
+
+Napi::Value OutputStreamClose(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  OutputStreamWriter *writer = GetWriter(info);
+  if (info.Length() != 2 || !info[1].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected (handle, requestId)");
+  }
+  if (writer->closed) {
+    return env.Undefined();
+  }
+  writer->closed = true;
+
+  auto *request = new WriteRequest();
+  request->id = info[1].As<Napi::Number>().Uint32Value();
+  request->close = true;
+  EnqueueWrite(env, writer, request);
+  return env.Undefined();
+}
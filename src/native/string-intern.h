@@ -0,0 +1,26 @@
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include <Foundation/Foundation.h>
+#include <napi.h>
+
+// MARK: - JS String -> NSString Arguments
+
+// Convert a JS string passed to an `@` parameter into an NSString.
+// When the env's intern cache is enabled, strings up to
+// kStringInternMaxLength code units are looked up by content first, so
+// repeated keys and names reuse one immutable NSString instead of allocating
+// a new one per call. The result stays valid at least until the current
+// autorelease pool drains.
+NSString *NSStringForJSArgument(Napi::Env env, const Napi::Value &value);
+
+// MARK: - Exported Functions
+
+// Enable, resize or disable the intern cache for this env.
+// Arguments: capacity (number of strings; 0 disables and empties the cache)
+Napi::Value ConfigureStringIntern(const Napi::CallbackInfo &info);
+
+// Returns: { capacity, size, hits, misses, evictions, bypassed }
+Napi::Value GetStringInternStats(const Napi::CallbackInfo &info);
+
+#endif // STRING_INTERN_H
@@ -0,0 +1,178 @@
+#include "string-intern.h"
+#include "ObjcObject.h"
+#include "constants.h"
+#include "string-utils.h"
+#include <CoreFoundation/CoreFoundation.h>
+#include <Foundation/Foundation.h>
+#include <cstdint>
+#include <napi.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - Intern Cache
+
+/**
+ * Bounded content-addressed cache of immutable NSStrings, one per env (so it
+ * is only touched from that env's JS thread and needs no locking).
+ *
+ * Eviction uses the clock algorithm: each hit sets the entry's reference
+ * bit, and on insert into a full cache the hand sweeps forward clearing
+ * bits until it finds an unreferenced entry to replace. This approximates
+ * LRU without reordering a list on every hit.
+ *
+ * Evicted strings are autoreleased rather than released, because an
+ * argument converted earlier in the same call may be the one evicted.
+ */
+class NSStringInternCache {
+public:
+  explicit NSStringInternCache(size_t capacity) : capacity_(capacity) {
+    // Entries never move, so index_ can key on views into their strings.
+    entries_.reserve(capacity);
+    index_.reserve(capacity);
+  }
+
+  ~NSStringInternCache() {
+    for (Entry &entry : entries_) {
+      CFRelease(entry.value);
+    }
+  }
+
+  NSStringInternCache(const NSStringInternCache &) = delete;
+  NSStringInternCache &operator=(const NSStringInternCache &) = delete;
+
+  NSString *Lookup(std::u16string_view key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      misses_++;
+      return nil;
+    }
+    hits_++;
+    Entry &entry = entries_[it->second];
+    entry.referenced = true;
+    return (NSString *)entry.value;
+  }
+
+  // Takes ownership of `value` (+1).
+  NSString *Insert(std::u16string_view key, CFStringRef value) {
+    uint32_t slot;
+    if (entries_.size() < capacity_) {
+      slot = static_cast<uint32_t>(entries_.size());
+      entries_.push_back(Entry{std::u16string(key), value, false});
+    } else {
+      slot = NextVictim();
+      Entry &victim = entries_[slot];
+      index_.erase(std::u16string_view(victim.key));
+      [(NSString *)victim.value autorelease];
+      victim.key.assign(key);
+      victim.value = value;
+      victim.referenced = false;
+      evictions_++;
+    }
+    index_.emplace(std::u16string_view(entries_[slot].key), slot);
+    return (NSString *)value;
+  }
+
+  void NoteBypass() { bypassed_++; }
+
+  Napi::Object Stats(Napi::Env env) const {
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("capacity", Napi::Number::New(env, static_cast<double>(capacity_)));
+    stats.Set("size", Napi::Number::New(env, static_cast<double>(entries_.size())));
+    stats.Set("hits", Napi::Number::New(env, static_cast<double>(hits_)));
+    stats.Set("misses", Napi::Number::New(env, static_cast<double>(misses_)));
+    stats.Set("evictions", Napi::Number::New(env, static_cast<double>(evictions_)));
+    stats.Set("bypassed", Napi::Number::New(env, static_cast<double>(bypassed_)));
+    return stats;
+  }
+
+private:
+  struct Entry {
+    std::u16string key;
+    CFStringRef value;
+    bool referenced;
+  };
+
+  uint32_t NextVictim() {
+    for (;;) {
+      Entry &entry = entries_[hand_];
+      uint32_t slot = static_cast<uint32_t>(hand_);
+      hand_ = (hand_ + 1) % entries_.size();
+      if (!entry.referenced) {
+        return slot;
+      }
+      entry.referenced = false;
+    }
+  }
+
+  size_t capacity_;
+  size_t hand_ = 0;
+  std::vector<Entry> entries_;
+  std::unordered_map<std::u16string_view, uint32_t> index_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+  uint64_t bypassed_ = 0;
+};
+
+// MARK: - Argument Conversion
+
+NSString *NSStringForJSArgument(Napi::Env env, const Napi::Value &value) {
+  size_t length = 0;
+  napi_status status =
+      napi_get_value_string_utf16(env, value, nullptr, 0, &length);
+  NAPI_THROW_IF_FAILED(env, status, nil);
+  StringScratch<char16_t> utf16(length + 1);
+  status = napi_get_value_string_utf16(env, value, utf16.data(), length + 1,
+                                       &length);
+  NAPI_THROW_IF_FAILED(env, status, nil);
+
+  NSStringInternCache *cache =
+      ObjcObject::GetEnvData(env)->stringInternCache.get();
+  if (cache == nullptr) {
+    return [(NSString *)CreateCFStringFromUtf16(utf16.data(), length) autorelease];
+  }
+  if (length > nobjc::kStringInternMaxLength) {
+    cache->NoteBypass();
+    return [(NSString *)CreateCFStringFromUtf16(utf16.data(), length) autorelease];
+  }
+
+  std::u16string_view key(utf16.data(), length);
+  if (NSString *interned = cache->Lookup(key)) {
+    return interned;
+  }
+  return cache->Insert(key, CreateCFStringFromUtf16(utf16.data(), length));
+}
+
+// MARK: - Exported Functions
+
+Napi::Value ConfigureStringIntern(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsNumber()) {
+    throw Napi::TypeError::New(env, "Expected a capacity (number)");
+  }
+  double capacity = info[0].As<Napi::Number>().DoubleValue();
+  if (capacity < 0 || capacity > UINT32_MAX) {
+    throw Napi::RangeError::New(env, "Capacity must be between 0 and 2^32 - 1");
+  }
+  NobjcEnvData *data = ObjcObject::GetEnvData(env);
+  // Replacing the cache drops every entry. Interned strings still referenced
+  // by ObjC objects stay alive through their own retains.
+  data->stringInternCache.reset();
+  if (capacity >= 1) {
+    data->stringInternCache =
+        std::make_shared<NSStringInternCache>(static_cast<size_t>(capacity));
+  }
+  return env.Undefined();
+}
+
+Napi::Value GetStringInternStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  NSStringInternCache *cache =
+      ObjcObject::GetEnvData(env)->stringInternCache.get();
+  if (cache == nullptr) {
+    return NSStringInternCache(0).Stats(env);
+  }
+  return cache->Stats(env);
+}
@@ -0,0 +1,409 @@
+#ifndef STRING_TRANSCODE_H
+#define STRING_TRANSCODE_H
+
+/**
+ * @file string-transcode.h
+ * @brief Vectorized ASCII/Latin-1 detection and UTF-8 <-> UTF-16 transcoding.
+ *
+ * Every string that crosses the bridge is scanned at least once. These
+ * kernels do the scanning 16 or 32 bytes at a time (NEON on arm64, SSE2 on
+ * x86_64 with an AVX2 path selected at runtime) and fall back to scalar code
+ * elsewhere, so pure ASCII text - by far the most common case - is detected
+ * and copied in bulk. Non-ASCII runs are decoded scalar between vectorized
+ * ASCII runs.
+ *
+ * This header is plain C++ with no Objective-C or N-API dependencies so it can
+ * be unit-benchmarked on any platform (see benchmarks/native/).
+ *
+ * @see string-utils.h for the N-API / CoreFoundation layer built on top.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NOBJC_TRANSCODE_NEON 1
+#elif defined(__x86_64__) && defined(__SSE2__)
+#include <immintrin.h>
+#define NOBJC_TRANSCODE_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define NOBJC_TRANSCODE_AVX2 1
+#endif
+#endif
+
+namespace nobjc {
+
+/// Returned by the transcoders when the input is malformed (or, for
+/// Utf8ToLatin1, contains a code point above U+00FF).
+constexpr size_t kTranscodeInvalid = static_cast<size_t>(-1);
+
+/// The narrowest representation a string fits in.
+enum class TextClass { Ascii, Latin1, Other };
+
+namespace transcode_detail {
+
+// MARK: - Scalar Kernels
+
+inline size_t AsciiPrefixScalar(const uint8_t *p, size_t n) {
+  size_t i = 0;
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, p + i, sizeof(word));
+    if (word & kHighBits) break;
+  }
+  while (i < n && p[i] < 0x80) i++;
+  return i;
+}
+
+inline size_t Utf16PrefixBelowScalar(const char16_t *p, size_t n,
+                                     char16_t limit) {
+  size_t i = 0;
+  while (i < n && p[i] < limit) i++;
+  return i;
+}
+
+inline void WidenScalar(const uint8_t *src, size_t n, char16_t *dst) {
+  for (size_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+inline void NarrowScalar(const char16_t *src, size_t n, uint8_t *dst) {
+  for (size_t i = 0; i < n; i++) dst[i] = static_cast<uint8_t>(src[i]);
+}
+
+// MARK: - AVX2 Kernels (runtime-selected)
+
+#if NOBJC_TRANSCODE_AVX2
+inline bool HasAvx2() {
+  static const bool hasAvx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return hasAvx2;
+}
+
+__attribute__((target("avx2"))) inline size_t
+AsciiPrefixAvx2(const uint8_t *p, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    if (mask) return i + __builtin_ctz(mask);
+  }
+  return i + AsciiPrefixScalar(p + i, n - i);
+}
+
+__attribute__((target("avx2"))) inline size_t
+Utf16PrefixBelowAvx2(const char16_t *p, size_t n, char16_t limit) {
+  const __m256i bound = _mm256_set1_epi16(static_cast<short>(limit - 1));
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+    // Saturating subtract leaves a non-zero lane only where v > limit - 1.
+    __m256i over = _mm256_subs_epu16(v, bound);
+    uint32_t inRange = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi16(over, zero)));
+    if (inRange != 0xFFFFFFFFu) return i + __builtin_ctz(~inRange) / 2;
+  }
+  return i + Utf16PrefixBelowScalar(p + i, n - i, limit);
+}
+#endif
+
+// MARK: - Vector Kernels
+
+inline size_t AsciiPrefix(const uint8_t *p, size_t n) {
+#if NOBJC_TRANSCODE_AVX2
+  if (n >= 64 && HasAvx2()) return AsciiPrefixAvx2(p, n);
+#endif
+#if NOBJC_TRANSCODE_NEON
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(p + i)) >= 0x80) {
+      return i + AsciiPrefixScalar(p + i, 16);
+    }
+  }
+  return i + AsciiPrefixScalar(p + i, n - i);
+#elif NOBJC_TRANSCODE_SSE2
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+    if (mask) return i + __builtin_ctz(mask);
+  }
+  return i + AsciiPrefixScalar(p + i, n - i);
+#else
+  return AsciiPrefixScalar(p, n);
+#endif
+}
+
+inline size_t Utf16PrefixBelow(const char16_t *p, size_t n, char16_t limit) {
+#if NOBJC_TRANSCODE_AVX2
+  if (n >= 32 && HasAvx2()) return Utf16PrefixBelowAvx2(p, n, limit);
+#endif
+#if NOBJC_TRANSCODE_NEON
+  size_t i = 0;
+  const uint16_t *u = reinterpret_cast<const uint16_t *>(p);
+  for (; i + 8 <= n; i += 8) {
+    if (vmaxvq_u16(vld1q_u16(u + i)) >= limit) {
+      return i + Utf16PrefixBelowScalar(p + i, 8, limit);
+    }
+  }
+  return i + Utf16PrefixBelowScalar(p + i, n - i, limit);
+#elif NOBJC_TRANSCODE_SSE2
+  const __m128i bound = _mm_set1_epi16(static_cast<short>(limit - 1));
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+    __m128i over = _mm_subs_epu16(v, bound);
+    uint32_t inRange = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi16(over, zero)));
+    if (inRange != 0xFFFFu) return i + __builtin_ctz(~inRange) / 2;
+  }
+  return i + Utf16PrefixBelowScalar(p + i, n - i, limit);
+#else
+  return Utf16PrefixBelowScalar(p, n, limit);
+#endif
+}
+
+// Zero-extend bytes to UTF-16 code units (valid for ASCII and Latin-1).
+inline void Widen(const uint8_t *src, size_t n, char16_t *dst) {
+  size_t i = 0;
+#if NOBJC_TRANSCODE_NEON
+  uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t v = vld1q_u8(src + i);
+    vst1q_u16(out + i, vmovl_u8(vget_low_u8(v)));
+    vst1q_u16(out + i + 8, vmovl_high_u8(v));
+  }
+#elif NOBJC_TRANSCODE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8),
+                     _mm_unpackhi_epi8(v, zero));
+  }
+#endif
+  WidenScalar(src + i, n - i, dst + i);
+}
+
+// Truncate UTF-16 code units to bytes. Every unit must be below 0x100.
+inline void Narrow(const char16_t *src, size_t n, uint8_t *dst) {
+  size_t i = 0;
+#if NOBJC_TRANSCODE_NEON
+  const uint16_t *in = reinterpret_cast<const uint16_t *>(src);
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t v = vcombine_u8(vmovn_u16(vld1q_u16(in + i)),
+                               vmovn_u16(vld1q_u16(in + i + 8)));
+    vst1q_u8(dst + i, v);
+  }
+#elif NOBJC_TRANSCODE_SSE2
+  for (; i + 16 <= n; i += 16) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+#endif
+  NarrowScalar(src + i, n - i, dst + i);
+}
+
+inline bool IsContinuation(uint8_t byte) { return (byte & 0xC0) == 0x80; }
+
+} // namespace transcode_detail
+
+// MARK: - Detection
+
+/// Length of the leading run of ASCII bytes.
+inline size_t AsciiPrefixLength(const char *utf8, size_t length) {
+  return transcode_detail::AsciiPrefix(
+      reinterpret_cast<const uint8_t *>(utf8), length);
+}
+
+inline bool IsAscii(const char *utf8, size_t length) {
+  return AsciiPrefixLength(utf8, length) == length;
+}
+
+/// True if every UTF-16 code unit is below 0x100 (the string is Latin-1).
+inline bool IsLatin1(const char16_t *utf16, size_t length) {
+  return transcode_detail::Utf16PrefixBelow(utf16, length, 0x100) == length;
+}
+
+/// Classify a UTF-8 string by the narrowest encoding that can hold it.
+/// Malformed input is reported as Other.
+inline TextClass ClassifyUtf8(const char *utf8, size_t length) {
+  using namespace transcode_detail;
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(utf8);
+  size_t i = AsciiPrefix(p, length);
+  if (i == length) return TextClass::Ascii;
+  while (i < length) {
+    uint8_t lead = p[i];
+    if (lead < 0x80) {
+      i += AsciiPrefix(p + i, length - i);
+      continue;
+    }
+    // U+0080..U+00FF encode as C2/C3 followed by one continuation byte.
+    if ((lead != 0xC2 && lead != 0xC3) || i + 1 >= length ||
+        !IsContinuation(p[i + 1])) {
+      return TextClass::Other;
+    }
+    i += 2;
+  }
+  return TextClass::Latin1;
+}
+
+/// Classify a UTF-16 string by the narrowest encoding that can hold it.
+inline TextClass ClassifyUtf16(const char16_t *utf16, size_t length) {
+  using namespace transcode_detail;
+  size_t ascii = Utf16PrefixBelow(utf16, length, 0x80);
+  if (ascii == length) return TextClass::Ascii;
+  return Utf16PrefixBelow(utf16 + ascii, length - ascii, 0x100) ==
+                 length - ascii
+             ? TextClass::Latin1
+             : TextClass::Other;
+}
+
+// MARK: - Transcoding
+
+/// Zero-extend Latin-1 bytes to UTF-16. `out` must hold `length` units.
+inline void Latin1ToUtf16(const char *latin1, size_t length, char16_t *out) {
+  transcode_detail::Widen(reinterpret_cast<const uint8_t *>(latin1), length,
+                          out);
+}
+
+/// Narrow UTF-16 to Latin-1. Every unit must be below 0x100 (see IsLatin1).
+/// `out` must hold `length` bytes.
+inline void Utf16ToLatin1(const char16_t *utf16, size_t length, char *out) {
+  transcode_detail::Narrow(utf16, length, reinterpret_cast<uint8_t *>(out));
+}
+
+/// Decode UTF-8 to Latin-1. Returns the number of bytes written, or
+/// kTranscodeInvalid if the input is malformed or has a code point above
+/// U+00FF. `out` must hold `length` bytes.
+inline size_t Utf8ToLatin1(const char *utf8, size_t length, char *out) {
+  using namespace transcode_detail;
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(utf8);
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    size_t run = AsciiPrefix(p + i, length - i);
+    std::memcpy(out + o, p + i, run);
+    i += run;
+    o += run;
+    if (i >= length) break;
+    uint8_t lead = p[i];
+    if ((lead != 0xC2 && lead != 0xC3) || i + 1 >= length ||
+        !IsContinuation(p[i + 1])) {
+      return kTranscodeInvalid;
+    }
+    out[o++] = static_cast<char>(((lead & 0x03) << 6) | (p[i + 1] & 0x3F));
+    i += 2;
+  }
+  return o;
+}
+
+/// Decode UTF-8 to UTF-16. Returns the number of code units written, or
+/// kTranscodeInvalid if the input is malformed (overlong forms, surrogates,
+/// truncated sequences and code points above U+10FFFF are rejected).
+/// `out` must hold `length` units; UTF-16 never needs more units than the
+/// UTF-8 form has bytes.
+inline size_t Utf8ToUtf16(const char *utf8, size_t length, char16_t *out) {
+  using namespace transcode_detail;
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(utf8);
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    if (p[i] < 0x80) {
+      size_t run = AsciiPrefix(p + i, length - i);
+      Widen(p + i, run, out + o);
+      i += run;
+      o += run;
+      continue;
+    }
+    uint8_t lead = p[i];
+    if (lead < 0xC2) {
+      return kTranscodeInvalid; // stray continuation or overlong 2-byte form
+    }
+    if (lead < 0xE0) {
+      if (i + 1 >= length || !IsContinuation(p[i + 1])) return kTranscodeInvalid;
+      out[o++] = static_cast<char16_t>(((lead & 0x1F) << 6) | (p[i + 1] & 0x3F));
+      i += 2;
+    } else if (lead < 0xF0) {
+      if (i + 2 >= length || !IsContinuation(p[i + 1]) ||
+          !IsContinuation(p[i + 2])) {
+        return kTranscodeInvalid;
+      }
+      uint32_t cp = ((lead & 0x0F) << 12) | ((p[i + 1] & 0x3F) << 6) |
+                    (p[i + 2] & 0x3F);
+      if (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF)) return kTranscodeInvalid;
+      out[o++] = static_cast<char16_t>(cp);
+      i += 3;
+    } else if (lead < 0xF5) {
+      if (i + 3 >= length || !IsContinuation(p[i + 1]) ||
+          !IsContinuation(p[i + 2]) || !IsContinuation(p[i + 3])) {
+        return kTranscodeInvalid;
+      }
+      uint32_t cp = ((lead & 0x07) << 18) | ((p[i + 1] & 0x3F) << 12) |
+                    ((p[i + 2] & 0x3F) << 6) | (p[i + 3] & 0x3F);
+      if (cp < 0x10000 || cp > 0x10FFFF) return kTranscodeInvalid;
+      cp -= 0x10000;
+      out[o++] = static_cast<char16_t>(0xD800 + (cp >> 10));
+      out[o++] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+      i += 4;
+    } else {
+      return kTranscodeInvalid;
+    }
+  }
+  return o;
+}
+
+/// Encode UTF-16 as UTF-8. Lone surrogates become U+FFFD, matching how V8
+/// and Foundation treat them. Returns the number of bytes written. `out`
+/// must hold `3 * length` bytes.
+inline size_t Utf16ToUtf8(const char16_t *utf16, size_t length, char *out) {
+  using namespace transcode_detail;
+  uint8_t *dst = reinterpret_cast<uint8_t *>(out);
+  size_t i = 0;
+  size_t o = 0;
+  while (i < length) {
+    if (utf16[i] < 0x80) {
+      size_t run = Utf16PrefixBelow(utf16 + i, length - i, 0x80);
+      Narrow(utf16 + i, run, dst + o);
+      i += run;
+      o += run;
+      continue;
+    }
+    uint32_t cp = utf16[i++];
+    if (cp >= 0xD800 && cp <= 0xDFFF) {
+      if (cp <= 0xDBFF && i < length && utf16[i] >= 0xDC00 &&
+          utf16[i] <= 0xDFFF) {
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (utf16[i++] - 0xDC00);
+      } else {
+        cp = 0xFFFD;
+      }
+    }
+    if (cp < 0x800) {
+      dst[o++] = static_cast<uint8_t>(0xC0 | (cp >> 6));
+      dst[o++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      dst[o++] = static_cast<uint8_t>(0xE0 | (cp >> 12));
+      dst[o++] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+      dst[o++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    } else {
+      dst[o++] = static_cast<uint8_t>(0xF0 | (cp >> 18));
+      dst[o++] = static_cast<uint8_t>(0x80 | ((cp >> 12) & 0x3F));
+      dst[o++] = static_cast<uint8_t>(0x80 | ((cp >> 6) & 0x3F));
+      dst[o++] = static_cast<uint8_t>(0x80 | (cp & 0x3F));
+    }
+  }
+  return o;
+}
+
+} // namespace nobjc
+
+#endif // STRING_TRANSCODE_H
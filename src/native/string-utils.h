@@ -0,0 +1,301 @@
+#ifndef STRING_UTILS_H
+#define STRING_UTILS_H
+
+/**
+ * @file string-utils.h
+ * @brief String conversion at the JS <-> Objective-C boundary.
+ *
+ * Chooses the cheapest N-API / CoreFoundation constructor for each string:
+ *
+ * - ASCII and Latin-1 text becomes a one-byte V8 string via
+ *   napi_create_string_latin1 (no UTF-8 decoding inside V8) and an 8-bit
+ *   CFString via CFStringCreateWithBytes.
+ * - Everything else is transcoded in bulk to UTF-16 and handed over with
+ *   napi_create_string_utf16 / CFStringCreateWithCharacters.
+ * - NSStrings are read through CFStringGetCStringPtr / CFStringGetCharactersPtr
+ *   when their storage is directly accessible, instead of -UTF8String, which
+ *   allocates and transcodes every time.
+ * - Large NSStrings become external JS strings that point at the NSString's
+ *   own storage (node_api_create_external_string_*), so multi-megabyte text
+ *   converts without a copy.
+ *
+ * @see string-transcode.h for the vectorized kernels.
+ */
+
+#include "constants.h"
+#include "string-transcode.h"
+#include <CoreFoundation/CoreFoundation.h>
+#include <Foundation/Foundation.h>
+#include <cstring>
+#include <dlfcn.h>
+#include <memory>
+#include <napi.h>
+#include <string>
+
+// MARK: - Scratch Buffers
+
+/**
+ * Stack storage for short strings with a heap fallback, the same
+ * small-buffer pattern $MsgSend uses for selector names.
+ */
+template <typename T, size_t N = 256> class StringScratch {
+public:
+  explicit StringScratch(size_t count) {
+    if (count > N) {
+      heap_.reset(new T[count]);
+      data_ = heap_.get();
+    } else {
+      data_ = stack_;
+    }
+  }
+  T *data() { return data_; }
+
+private:
+  T stack_[N];
+  std::unique_ptr<T[]> heap_;
+  T *data_;
+};
+
+// MARK: - Native -> JS
+
+inline Napi::Value Latin1StringToJS(Napi::Env env, const char *latin1,
+                                    size_t length) {
+  napi_value result;
+  napi_status status = napi_create_string_latin1(env, latin1, length, &result);
+  NAPI_THROW_IF_FAILED(env, status, Napi::Value());
+  return Napi::Value(env, result);
+}
+
+inline Napi::Value Utf16StringToJS(Napi::Env env, const char16_t *utf16,
+                                   size_t length) {
+  napi_value result;
+  napi_status status = napi_create_string_utf16(env, utf16, length, &result);
+  NAPI_THROW_IF_FAILED(env, status, Napi::Value());
+  return Napi::Value(env, result);
+}
+
+/**
+ * Convert UTF-8 bytes to a JS string. ASCII is passed straight to
+ * napi_create_string_latin1; Latin-1 text is narrowed first; other text is
+ * transcoded to UTF-16. Malformed input goes through
+ * napi_create_string_utf8, which substitutes U+FFFD like V8 always has.
+ */
+inline Napi::Value Utf8StringToJS(Napi::Env env, const char *utf8,
+                                  size_t length) {
+  size_t ascii = nobjc::AsciiPrefixLength(utf8, length);
+  if (ascii == length) {
+    return Latin1StringToJS(env, utf8, length);
+  }
+  StringScratch<char> latin1(length);
+  std::memcpy(latin1.data(), utf8, ascii);
+  size_t latin1Length =
+      nobjc::Utf8ToLatin1(utf8 + ascii, length - ascii, latin1.data() + ascii);
+  if (latin1Length != nobjc::kTranscodeInvalid) {
+    return Latin1StringToJS(env, latin1.data(), ascii + latin1Length);
+  }
+  StringScratch<char16_t> utf16(length);
+  size_t utf16Length = nobjc::Utf8ToUtf16(utf8, length, utf16.data());
+  if (utf16Length != nobjc::kTranscodeInvalid) {
+    return Utf16StringToJS(env, utf16.data(), utf16Length);
+  }
+  return Napi::String::New(env, utf8, length);
+}
+
+/// Convert a NUL-terminated UTF-8 C string (char * returns, selector names).
+inline Napi::Value CStringToJS(Napi::Env env, const char *str) {
+  return Utf8StringToJS(env, str, std::strlen(str));
+}
+
+// MARK: - External Strings
+
+/**
+ * node_api_create_external_string_latin1/_utf16 were added in Node 18.18 /
+ * 20.4 and are not available in every runtime (or every Node-API header
+ * version we build against), so they are resolved at runtime. The finalizer
+ * parameter is declared as a plain napi_finalize, which has the same ABI as
+ * node_api_basic_finalize.
+ */
+struct ExternalStringApi {
+  using CreateLatin1 = napi_status (*)(napi_env, char *, size_t, napi_finalize,
+                                       void *, napi_value *, bool *);
+  using CreateUtf16 = napi_status (*)(napi_env, char16_t *, size_t,
+                                      napi_finalize, void *, napi_value *,
+                                      bool *);
+  CreateLatin1 latin1;
+  CreateUtf16 utf16;
+};
+
+inline const ExternalStringApi &GetExternalStringApi() {
+  static const ExternalStringApi api = {
+      reinterpret_cast<ExternalStringApi::CreateLatin1>(
+          dlsym(RTLD_DEFAULT, "node_api_create_external_string_latin1")),
+      reinterpret_cast<ExternalStringApi::CreateUtf16>(
+          dlsym(RTLD_DEFAULT, "node_api_create_external_string_utf16")),
+  };
+  return api;
+}
+
+// Finalizer for external strings: `hint` is the immutable NSString that
+// owns the characters. May run during GC; CFRelease is thread-safe.
+inline void ReleaseExternalStringOwner(napi_env, void *, void *hint) {
+  CFRelease(hint);
+}
+
+/**
+ * Try to create a JS string that shares `string`'s storage. An immutable
+ * copy (just a retain for immutable strings) owns the characters until V8
+ * finalizes the JS string. Returns false when the runtime lacks external
+ * strings or the storage is not a contiguous Latin-1/UTF-16 buffer, in which
+ * case the caller copies.
+ */
+inline bool TryNSStringToExternalJS(Napi::Env env, NSString *string,
+                                    Napi::Value &out) {
+  const ExternalStringApi &api = GetExternalStringApi();
+  if (api.latin1 == nullptr && api.utf16 == nullptr) {
+    return false;
+  }
+
+  CFStringRef owner = (CFStringRef)[string copy];
+  const CFIndex length = CFStringGetLength(owner);
+  napi_value result = nullptr;
+  napi_status status = napi_generic_failure;
+  bool copied = false;
+
+  const char *ascii =
+      api.latin1 ? CFStringGetCStringPtr(owner, kCFStringEncodingASCII) : nullptr;
+  const UniChar *chars = (ascii == nullptr && api.utf16)
+                             ? CFStringGetCharactersPtr(owner)
+                             : nullptr;
+  if (ascii != nullptr) {
+    status = api.latin1(env, const_cast<char *>(ascii),
+                        static_cast<size_t>(length), ReleaseExternalStringOwner,
+                        (void *)owner, &result, &copied);
+  } else if (chars != nullptr) {
+    status = api.utf16(env,
+                       reinterpret_cast<char16_t *>(const_cast<UniChar *>(chars)),
+                       static_cast<size_t>(length), ReleaseExternalStringOwner,
+                       (void *)owner, &result, &copied);
+  }
+  if (status != napi_ok) {
+    // No contiguous storage, or the runtime refused. The finalizer has not
+    // run, so the copy is still ours to release.
+    CFRelease(owner);
+    return false;
+  }
+  // If the runtime chose to copy anyway, it has already run the finalizer.
+  out = Napi::Value(env, result);
+  return true;
+}
+
+/**
+ * Convert an NSString to a JS string without going through -UTF8String.
+ * Large strings are shared with the JS heap when possible (see
+ * TryNSStringToExternalJS). Otherwise tries, in order: direct 8-bit storage,
+ * direct UTF-16 storage, direct UTF-8 storage (bridged Swift strings), a bulk
+ * Latin-1 extraction and finally a bulk UTF-16 extraction.
+ */
+inline Napi::Value NSStringToJS(Napi::Env env, NSString *string) {
+  CFStringRef cf = (__bridge CFStringRef)string;
+  const CFIndex length = CFStringGetLength(cf);
+  if (length == 0) {
+    return Latin1StringToJS(env, "", 0);
+  }
+
+  if (length >= nobjc::kExternalStringMinLength) {
+    Napi::Value external;
+    if (TryNSStringToExternalJS(env, string, external)) {
+      return external;
+    }
+  }
+
+  if (const char *ascii = CFStringGetCStringPtr(cf, kCFStringEncodingASCII)) {
+    return Latin1StringToJS(env, ascii, static_cast<size_t>(length));
+  }
+  if (const UniChar *chars = CFStringGetCharactersPtr(cf)) {
+    return Utf16StringToJS(env, reinterpret_cast<const char16_t *>(chars),
+                           static_cast<size_t>(length));
+  }
+  if (const char *utf8 = CFStringGetCStringPtr(cf, kCFStringEncodingUTF8)) {
+    return CStringToJS(env, utf8);
+  }
+
+  const CFRange range = CFRangeMake(0, length);
+  StringScratch<UInt8> latin1(static_cast<size_t>(length));
+  CFIndex used = 0;
+  CFIndex converted = CFStringGetBytes(cf, range, kCFStringEncodingISOLatin1, 0,
+                                       false, latin1.data(), length, &used);
+  if (converted == length) {
+    return Latin1StringToJS(env, reinterpret_cast<const char *>(latin1.data()),
+                            static_cast<size_t>(used));
+  }
+  StringScratch<UniChar> utf16(static_cast<size_t>(length));
+  CFStringGetCharacters(cf, range, utf16.data());
+  return Utf16StringToJS(env, reinterpret_cast<const char16_t *>(utf16.data()),
+                         static_cast<size_t>(length));
+}
+
+// MARK: - JS -> Native
+
+/**
+ * Create an immutable CFString from UTF-16 code units. Latin-1 content is
+ * stored as an 8-bit CFString; everything else is created from the code
+ * units directly. Returns a +1 reference.
+ */
+inline CFStringRef CreateCFStringFromUtf16(const char16_t *utf16,
+                                           size_t length) {
+  if (nobjc::IsLatin1(utf16, length)) {
+    StringScratch<char> latin1(length);
+    nobjc::Utf16ToLatin1(utf16, length, latin1.data());
+    return CFStringCreateWithBytes(
+        kCFAllocatorDefault, reinterpret_cast<const UInt8 *>(latin1.data()),
+        static_cast<CFIndex>(length), kCFStringEncodingISOLatin1, false);
+  }
+  return CFStringCreateWithCharacters(
+      kCFAllocatorDefault, reinterpret_cast<const UniChar *>(utf16),
+      static_cast<CFIndex>(length));
+}
+
+/**
+ * Create an NSString from a JS string. Returns an autoreleased string.
+ */
+inline NSString *JSStringToNSString(Napi::Env env, const Napi::Value &value) {
+  size_t length = 0;
+  napi_status status =
+      napi_get_value_string_utf16(env, value, nullptr, 0, &length);
+  NAPI_THROW_IF_FAILED(env, status, nil);
+
+  StringScratch<char16_t> utf16(length + 1);
+  status = napi_get_value_string_utf16(env, value, utf16.data(), length + 1,
+                                       &length);
+  NAPI_THROW_IF_FAILED(env, status, nil);
+
+  return [(NSString *)CreateCFStringFromUtf16(utf16.data(), length) autorelease];
+}
+
+/**
+ * Convert a JS string to UTF-8 (char * arguments). ASCII text is narrowed
+ * directly; everything else goes through the vectorized UTF-16 encoder
+ * rather than V8's UTF-8 writer.
+ */
+inline std::string JSStringToUtf8(Napi::Env env, const Napi::Value &value) {
+  size_t length = 0;
+  napi_status status =
+      napi_get_value_string_utf16(env, value, nullptr, 0, &length);
+  NAPI_THROW_IF_FAILED(env, status, std::string());
+
+  StringScratch<char16_t> utf16(length + 1);
+  status = napi_get_value_string_utf16(env, value, utf16.data(), length + 1,
+                                       &length);
+  NAPI_THROW_IF_FAILED(env, status, std::string());
+
+  if (nobjc::ClassifyUtf16(utf16.data(), length) == nobjc::TextClass::Ascii) {
+    std::string ascii(length, '\0');
+    nobjc::Utf16ToLatin1(utf16.data(), length, ascii.data());
+    return ascii;
+  }
+  StringScratch<char> utf8(3 * length);
+  size_t written = nobjc::Utf16ToUtf8(utf16.data(), length, utf8.data());
+  return std::string(utf8.data(), written);
+}
+
+#endif // STRING_UTILS_H
@@ -0,0 +1,165 @@
+#ifndef STRUCT_REGISTERS_H
+#define STRUCT_REGISTERS_H
+
+/**
+ * @file struct-registers.h
+ * @brief Classification of structs that travel in registers.
+ *
+ * Small structs can be sent with a direct objc_msgSend cast instead of an
+ * NSInvocation, provided the cast reproduces the ABI classification of the
+ * real struct. Two families qualify:
+ *
+ * - Homogeneous floating-point aggregates: one to four floats or one to four
+ *   doubles (CGPoint, CGSize, CGRect, NSEdgeInsets). On arm64 they travel in
+ *   v0-v3. On x86_64 those of 16 bytes or less travel in xmm0/xmm1; larger
+ *   ones are returned through objc_msgSend_stret and passed in memory.
+ * - Integer structs of at most 16 bytes whose leaves are all integers or
+ *   pointers (NSRange, CFRange). These travel in two general registers on
+ *   both architectures, byte for byte as they sit in memory.
+ *
+ * A struct is sent through a "shape" type with the same classification:
+ * `RegisterShape<double, 4>` for CGRect, `RegisterShape<uint64_t, 2>` for any
+ * integer struct of 9-16 bytes, and so on. Mixed float/integer structs,
+ * unions, arrays and bitfields are left to NSInvocation.
+ */
+
+#include "struct-utils.h"
+#include "type-conversion.h"
+#include <Foundation/Foundation.h>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+// MARK: - Classification
+
+enum class RegisterStructKind : uint8_t {
+  None,       // Not register-passed (or not one we handle)
+  Integer,    // <= 16 bytes of integer/pointer leaves
+  FloatHFA,   // 1-4 floats
+  DoubleHFA,  // 1-4 doubles
+};
+
+struct RegisterStructClass {
+  RegisterStructKind kind = RegisterStructKind::None;
+  uint8_t count = 0;  // HFA members, or 64-bit words for Integer
+  size_t size = 0;    // sizeof the real struct
+};
+
+namespace register_struct_detail {
+
+// Counts leaves by class. Returns false on anything that disqualifies the
+// struct (unions, arrays, bitfields, long double, empty nested structs).
+inline bool CollectLeaves(const std::vector<StructFieldInfo> &fields,
+                          size_t &floats, size_t &doubles, size_t &integers) {
+  for (const StructFieldInfo &field : fields) {
+    if (field.isStruct) {
+      if (field.subfields.empty() ||
+          !CollectLeaves(field.subfields, floats, doubles, integers)) {
+        return false;
+      }
+      continue;
+    }
+    switch (SimplifyTypeEncoding(field.typeEncoding.c_str())[0]) {
+      case 'f': floats++; break;
+      case 'd': doubles++; break;
+      case 'c': case 'i': case 's': case 'l': case 'q':
+      case 'C': case 'I': case 'S': case 'L': case 'Q':
+      case 'B': case '^': case '*': case '@': case '#': case ':':
+        integers++;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+inline RegisterStructClass Classify(const char *encoding) {
+  RegisterStructClass result;
+  const ParsedStructType &parsed = GetOrParseStructEncoding(encoding);
+  if (parsed.fields.empty()) return result;
+
+  // The shape cast is only sound if our layout matches the runtime's.
+  NSUInteger runtimeSize = 0;
+  @try {
+    NSGetSizeAndAlignment(encoding, &runtimeSize, nullptr);
+  } @catch (NSException *) {
+    return result;
+  }
+  if (runtimeSize != parsed.totalSize) return result;
+
+  size_t floats = 0, doubles = 0, integers = 0;
+  if (!CollectLeaves(parsed.fields, floats, doubles, integers)) return result;
+
+  result.size = parsed.totalSize;
+  const size_t leaves = floats + doubles + integers;
+  if (floats == leaves && leaves <= 4 && parsed.totalSize == leaves * sizeof(float)) {
+    result.kind = RegisterStructKind::FloatHFA;
+    result.count = static_cast<uint8_t>(leaves);
+  } else if (doubles == leaves && leaves <= 4 &&
+             parsed.totalSize == leaves * sizeof(double)) {
+    result.kind = RegisterStructKind::DoubleHFA;
+    result.count = static_cast<uint8_t>(leaves);
+  } else if (integers == leaves && parsed.totalSize <= 16) {
+    result.kind = RegisterStructKind::Integer;
+    result.count = parsed.totalSize <= 8 ? 1 : 2;
+  }
+  return result;
+}
+
+} // namespace register_struct_detail
+
+/**
+ * Classify a simplified struct encoding, caching by encoding string. JS
+ * thread only, like GetOrParseStructEncoding.
+ */
+inline RegisterStructClass ClassifyRegisterStruct(const char *encoding) {
+  static std::unordered_map<std::string, RegisterStructClass> cache;
+  auto it = cache.find(encoding);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  RegisterStructClass result = register_struct_detail::Classify(encoding);
+  cache.emplace(encoding, result);
+  return result;
+}
+
+// MARK: - Shapes
+
+/// An array-of-T struct with the ABI classification of a register struct.
+template <typename T, size_t N> struct RegisterShape {
+  T v[N];
+};
+
+/**
+ * Call `visitor(std::type_identity<Shape>{})` with the shape type for `cls`,
+ * like DispatchByTypeCode. `cls.kind` must not be None.
+ */
+template <typename Visitor>
+auto DispatchRegisterShape(const RegisterStructClass &cls, Visitor &&visitor)
+    -> decltype(visitor(std::type_identity<RegisterShape<uint64_t, 1>>{})) {
+  switch (cls.kind) {
+    case RegisterStructKind::FloatHFA:
+      switch (cls.count) {
+        case 1: return visitor(std::type_identity<RegisterShape<float, 1>>{});
+        case 2: return visitor(std::type_identity<RegisterShape<float, 2>>{});
+        case 3: return visitor(std::type_identity<RegisterShape<float, 3>>{});
+        default: return visitor(std::type_identity<RegisterShape<float, 4>>{});
+      }
+    case RegisterStructKind::DoubleHFA:
+      switch (cls.count) {
+        case 1: return visitor(std::type_identity<RegisterShape<double, 1>>{});
+        case 2: return visitor(std::type_identity<RegisterShape<double, 2>>{});
+        case 3: return visitor(std::type_identity<RegisterShape<double, 3>>{});
+        default: return visitor(std::type_identity<RegisterShape<double, 4>>{});
+      }
+    default:
+      if (cls.count == 1) {
+        return visitor(std::type_identity<RegisterShape<uint64_t, 1>>{});
+      }
+      return visitor(std::type_identity<RegisterShape<uint64_t, 2>>{});
+  }
+}
+
+#endif // STRUCT_REGISTERS_H
@@ -22,11 +22,15 @@
 #include "ObjcObject.h"
 #include "type-conversion.h"
 #include <Foundation/Foundation.h>
+#include <algorithm>
+#include <array>
 #include <map>
 #include <unordered_map>
 #include <napi.h>
 #include <objc/runtime.h>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // MARK: - Well-Known Struct Field Names
@@ -36,39 +40,58 @@
  * encodings typically don't include field names (only the compiler's
  * @encode() does). Without this mapping, fields would be named field0,
  * field1, etc.
+ *
+ * A constexpr table sorted by name, so including this header adds no static
+ * initializer; lookups are a binary search over a dozen entries.
  */
+struct KnownStructFields {
+  std::string_view name;
+  std::array<std::string_view, 6> fields;
+  size_t count;
+};
+
 // clang-format off
-static const std::unordered_map<std::string, std::vector<std::string>> KNOWN_STRUCT_FIELDS = {
+inline constexpr std::array<KnownStructFields, 12> KNOWN_STRUCT_FIELDS = {{
+  // Affine transforms
+  {"CGAffineTransform",  {"a", "b", "c", "d", "tx", "ty"}, 6},
   // CoreGraphics / AppKit geometry
-  {"CGPoint",            {"x", "y"}},
-  {"NSPoint",            {"x", "y"}},
-  {"CGSize",             {"width", "height"}},
-  {"NSSize",             {"width", "height"}},
-  {"CGRect",             {"origin", "size"}},
-  {"NSRect",             {"origin", "size"}},
-  {"CGVector",           {"dx", "dy"}},
-  // Foundation
-  {"_NSRange",           {"location", "length"}},
-  {"NSRange",            {"location", "length"}},
+  {"CGPoint",            {"x", "y"}, 2},
+  {"CGRect",             {"origin", "size"}, 2},
+  {"CGSize",             {"width", "height"}, 2},
+  {"CGVector",           {"dx", "dy"}, 2},
   // Edge insets
-  {"NSEdgeInsets",       {"top", "left", "bottom", "right"}},
-  {"NSDirectionalEdgeInsets", {"top", "leading", "bottom", "trailing"}},
-  // Affine transforms
-  {"CGAffineTransform",  {"a", "b", "c", "d", "tx", "ty"}},
-};
+  {"NSDirectionalEdgeInsets", {"top", "leading", "bottom", "trailing"}, 4},
+  {"NSEdgeInsets",       {"top", "left", "bottom", "right"}, 4},
+  {"NSPoint",            {"x", "y"}, 2},
+  // Foundation
+  {"NSRange",            {"location", "length"}, 2},
+  {"NSRect",             {"origin", "size"}, 2},
+  {"NSSize",             {"width", "height"}, 2},
+  {"_NSRange",           {"location", "length"}, 2},
+}};
 // clang-format on
 
+static_assert(std::is_sorted(KNOWN_STRUCT_FIELDS.begin(), KNOWN_STRUCT_FIELDS.end(),
+                             [](const KnownStructFields &a, const KnownStructFields &b) {
+                               return a.name < b.name;
+                             }),
+              "KNOWN_STRUCT_FIELDS must be sorted by name");
+
 /**
  * Look up well-known field names for a struct by its name.
- * Returns nullptr if the struct name is not recognized.
+ * Returns an empty span if the struct name is not recognized.
  */
-inline const std::vector<std::string> *
-LookupKnownFieldNames(const std::string &structName) {
-  auto it = KNOWN_STRUCT_FIELDS.find(structName);
-  if (it != KNOWN_STRUCT_FIELDS.end()) {
-    return &it->second;
+inline std::span<const std::string_view>
+LookupKnownFieldNames(std::string_view structName) {
+  auto it = std::lower_bound(
+      KNOWN_STRUCT_FIELDS.begin(), KNOWN_STRUCT_FIELDS.end(), structName,
+      [](const KnownStructFields &entry, std::string_view name) {
+        return entry.name < name;
+      });
+  if (it != KNOWN_STRUCT_FIELDS.end() && it->name == structName) {
+    return {it->fields.data(), it->count};
   }
-  return nullptr;
+  return {};
 }
 
 // MARK: - Data Structures
@@ -220,10 +243,10 @@ inline ParsedStructType ParseStructEncodingWithNames(const char *encoding) {
   // Apply well-known field names if fields don't have names from the encoding
   // (i.e., they have generated names like "field0", "field1", etc.)
   if (!result.fields.empty() && result.fields[0].name.substr(0, 5) == "field") {
-    const auto *knownNames = LookupKnownFieldNames(result.name);
-    if (knownNames && knownNames->size() == result.fields.size()) {
+    auto knownNames = LookupKnownFieldNames(result.name);
+    if (!knownNames.empty() && knownNames.size() == result.fields.size()) {
       for (size_t i = 0; i < result.fields.size(); i++) {
-        result.fields[i].name = (*knownNames)[i];
+        result.fields[i].name = knownNames[i];
       }
       NOBJC_LOG("ParseStructEncodingWithNames: Applied known field names for "
                 "'%s'",
@@ -247,10 +270,10 @@ inline ParsedStructType ParseStructEncodingWithNames(const char *encoding) {
         nestedName = std::string(ns, p - ns);
       }
       if (!nestedName.empty()) {
-        const auto *nestedKnown = LookupKnownFieldNames(nestedName);
-        if (nestedKnown && nestedKnown->size() == field.subfields.size()) {
+        auto nestedKnown = LookupKnownFieldNames(nestedName);
+        if (!nestedKnown.empty() && nestedKnown.size() == field.subfields.size()) {
           for (size_t i = 0; i < field.subfields.size(); i++) {
-            field.subfields[i].name = (*nestedKnown)[i];
+            field.subfields[i].name = nestedKnown[i];
           }
         }
       }
@@ -327,11 +350,9 @@ struct WriteLeafToBufferVisitor {
   // id (@) — extract from ObjcObject wrapper
   void operator()(std::type_identity<ObjCIdTag>) const {
     id objcObj = nil;
-    if (!jsValue.IsNull() && !jsValue.IsUndefined() && jsValue.IsObject()) {
-      ObjcObject *wrapper = ObjcObject::Unwrap(jsValue.As<Napi::Object>());
-      if (wrapper) {
-        objcObj = wrapper->objcObject;
-      }
+    if (!jsValue.IsNull() && !jsValue.IsUndefined() && jsValue.IsObject() &&
+        ObjcObject::IsInstance(jsValue.Env(), jsValue)) {
+      objcObj = ObjcObject::UnwrapObject(jsValue.Env(), jsValue);
     }
     memcpy(dest, &objcObj, sizeof(objcObj));
   }
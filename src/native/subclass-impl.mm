@@ -169,7 +169,10 @@ static void SubclassForwardInvocation(id self, SEL _cmd,
       ctx.skipDirectCallForElectron = false; // Subclass always tries direct call
       ctx.instancePtr = capturedSelfPtr;
       ctx.superClassPtr = it->second.superClass;
-      
+      ctx.dispatcher = it->second.dispatcher;
+      ctx.lane = methodIt->second.lane;
+      ctx.deadline = methodIt->second.deadline;
+
       // Cache the JS callback reference to avoid mutex re-acquisition
       ctx.cachedJsCallback = &methodIt->second.jsCallback;
 
@@ -280,8 +283,7 @@ Napi::Value DefineClass(const Napi::CallbackInfo &info) {
   } else if (superValue.IsObject()) {
     Napi::Object superObj = superValue.As<Napi::Object>();
     if (ObjcObject::IsInstance(env, superObj)) {
-      ObjcObject *objcObj = Napi::ObjectWrap<ObjcObject>::Unwrap(superObj);
-      superClass = (Class)objcObj->objcObject;
+      superClass = (Class)ObjcObject::UnwrapObject(env, superObj);
     }
   }
 
@@ -309,6 +311,7 @@ Napi::Value DefineClass(const Napi::CallbackInfo &info) {
       .env = env,
       .js_thread = pthread_self(),
       .isElectron = isElectron,
+      .dispatcher = nobjc::CallbackDispatcher::ForEnv(env),
   };
 
   // Add protocol conformance
@@ -369,6 +372,10 @@ Napi::Value DefineClass(const Napi::CallbackInfo &info) {
 
       SEL selector = sel_registerName(selectorName.c_str());
 
+      // Resolve the timeout before creating the TSFN (this may throw)
+      CallbackDeadline deadline = CallbackDeadlineForFunction(
+          jsImpl, SimplifiedTypeEncoding(typeEncoding.c_str())[0]);
+
       // Create ThreadSafeFunction
       Napi::ThreadSafeFunction tsfn = CreateMethodTSFN(
           env, jsImpl, "SubclassMethod_" + selectorName);
@@ -380,6 +387,9 @@ Napi::Value DefineClass(const Napi::CallbackInfo &info) {
           .typeEncoding = typeEncoding,
           .selectorName = selectorName,
           .isClassMethod = false,
+          .lane = nobjc::CallbackLaneForFunction(jsImpl,
+                                                 nobjc::CallbackLane::Blocking),
+          .deadline = deadline,
       };
       impl.methods[selector] = std::move(methodInfo);
 
@@ -630,8 +640,7 @@ Napi::Value CallSuper(const Napi::CallbackInfo &info) {
   if (!ObjcObject::IsInstance(env, selfObj)) {
     throw Napi::TypeError::New(env, "First argument must be an ObjcObject (self)");
   }
-  ObjcObject *selfWrapper = Napi::ObjectWrap<ObjcObject>::Unwrap(selfObj);
-  id self = selfWrapper->objcObject;
+  id self = ObjcObject::UnwrapObject(env, selfObj);
 
   // 3. Extract selector
   if (!info[1].IsString()) {
@@ -0,0 +1,482 @@
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+
+/**
+ * @file symbol-index.h
+ * @brief Per-image exported symbol lookup without a global dlsym scan.
+ *
+ * dlsym(RTLD_DEFAULT, name) searches every loaded image in load order, which
+ * gets slow once hundreds of frameworks are mapped. When the caller knows
+ * which image exports a symbol, the image's own export table can answer
+ * directly:
+ *
+ * - Mach-O: the export trie (LC_DYLD_EXPORTS_TRIE, or the export range of
+ *   LC_DYLD_INFO_ONLY on older binaries), walked in place from __LINKEDIT.
+ *   Re-exports, stub-and-resolver and thread-local exports are handed back
+ *   to dlsym on the image handle, which knows how to follow them.
+ * - ELF: the dynamic symbol table through its GNU hash table (or the SysV
+ *   hash table when there is no GNU hash), located from the link map's
+ *   dynamic section. IFUNCs are handed back to dlsym.
+ *
+ * The tables are only located when an index is opened; nothing is copied,
+ * so opening an index is cheap and each lookup touches a handful of cache
+ * lines.
+ *
+ * This header is plain C++ with no Objective-C or N-API dependencies so it can
+ * be unit-benchmarked on any platform (see benchmarks/native/).
+ *
+ * @see symbol-resolution.h for the N-API layer and the resolved-symbol cache.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <dlfcn.h>
+#include <memory>
+#include <string>
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#include <mach-o/loader.h>
+#elif defined(__linux__)
+#include <elf.h>
+#include <link.h>
+#endif
+
+namespace nobjc {
+
+/// Outcome of looking a name up in one image's export table.
+enum class SymbolLookup {
+  Found,      ///< Address resolved from the table
+  NotFound,   ///< The image does not export the name
+  NeedsDlsym  ///< Exported, but indirectly (re-export, resolver, IFUNC, TLS)
+};
+
+namespace symbol_detail {
+
+#if defined(__APPLE__)
+
+// MARK: - Mach-O Export Trie
+
+inline uint64_t ReadUleb128(const uint8_t *&p, const uint8_t *end) {
+  uint64_t result = 0;
+  unsigned shift = 0;
+  while (p < end) {
+    uint8_t byte = *p++;
+    if (shift < 64) {
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    }
+    shift += 7;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  return result;
+}
+
+struct MachOExports {
+  const uint8_t *header = nullptr;
+  const uint8_t *trie = nullptr;
+  size_t trieSize = 0;
+};
+
+/**
+ * Locate the export trie of a loaded image. Load command file offsets are
+ * translated through __LINKEDIT's vmaddr/fileoff, which also holds for
+ * images in the dyld shared cache.
+ */
+inline bool LocateExportTrie(const mach_header_64 *header, intptr_t slide,
+                             MachOExports &out) {
+  if (header->magic != MH_MAGIC_64) {
+    return false;
+  }
+  const auto *cursor = reinterpret_cast<const uint8_t *>(header + 1);
+  const segment_command_64 *linkedit = nullptr;
+  uint32_t trieOffset = 0;
+  uint32_t trieSize = 0;
+  for (uint32_t i = 0; i < header->ncmds; i++) {
+    const auto *command = reinterpret_cast<const load_command *>(cursor);
+    switch (command->cmd) {
+      case LC_SEGMENT_64: {
+        const auto *segment = reinterpret_cast<const segment_command_64 *>(command);
+        if (std::strncmp(segment->segname, "__LINKEDIT", 16) == 0) {
+          linkedit = segment;
+        }
+        break;
+      }
+      case LC_DYLD_EXPORTS_TRIE: {
+        const auto *data = reinterpret_cast<const linkedit_data_command *>(command);
+        trieOffset = data->dataoff;
+        trieSize = data->datasize;
+        break;
+      }
+      case LC_DYLD_INFO:
+      case LC_DYLD_INFO_ONLY: {
+        const auto *info = reinterpret_cast<const dyld_info_command *>(command);
+        if (trieSize == 0) {
+          trieOffset = info->export_off;
+          trieSize = info->export_size;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    cursor += command->cmdsize;
+  }
+  if (linkedit == nullptr || trieSize == 0) {
+    return false;
+  }
+  out.header = reinterpret_cast<const uint8_t *>(header);
+  out.trie = reinterpret_cast<const uint8_t *>(
+      static_cast<uintptr_t>(linkedit->vmaddr + slide) +
+      (trieOffset - linkedit->fileoff));
+  out.trieSize = trieSize;
+  return true;
+}
+
+/// Walk the trie for `symbol` (the mangled name, with its leading '_').
+inline SymbolLookup FindInExportTrie(const MachOExports &exports,
+                                     const char *symbol, void **address) {
+  const uint8_t *start = exports.trie;
+  const uint8_t *end = start + exports.trieSize;
+  const uint8_t *node = start;
+  const char *rest = symbol;
+  for (;;) {
+    const uint8_t *p = node;
+    uint64_t terminalSize = ReadUleb128(p, end);
+    if (*rest == '\0' && terminalSize != 0) {
+      uint64_t flags = ReadUleb128(p, end);
+      if ((flags & (EXPORT_SYMBOL_FLAGS_REEXPORT |
+                    EXPORT_SYMBOL_FLAGS_STUB_AND_RESOLVER)) != 0) {
+        return SymbolLookup::NeedsDlsym;
+      }
+      uint64_t offset = ReadUleb128(p, end);
+      switch (flags & EXPORT_SYMBOL_FLAGS_KIND_MASK) {
+        case EXPORT_SYMBOL_FLAGS_KIND_REGULAR:
+          *address = const_cast<uint8_t *>(exports.header + offset);
+          return SymbolLookup::Found;
+        case EXPORT_SYMBOL_FLAGS_KIND_ABSOLUTE:
+          *address = reinterpret_cast<void *>(static_cast<uintptr_t>(offset));
+          return SymbolLookup::Found;
+        default:
+          return SymbolLookup::NeedsDlsym;
+      }
+    }
+    p += terminalSize;
+    if (p >= end) {
+      return SymbolLookup::NotFound;
+    }
+    uint8_t childCount = *p++;
+    const uint8_t *next = nullptr;
+    for (uint8_t i = 0; i < childCount && p < end; i++) {
+      const char *edge = reinterpret_cast<const char *>(p);
+      size_t edgeLength = strnlen(edge, static_cast<size_t>(end - p));
+      p += edgeLength + 1;
+      uint64_t childOffset = ReadUleb128(p, end);
+      if (std::strncmp(rest, edge, edgeLength) == 0) {
+        rest += edgeLength;
+        next = start + childOffset;
+        // Edges out of a node never share a first byte, so stop scanning.
+        break;
+      }
+    }
+    if (next == nullptr || next >= end) {
+      return SymbolLookup::NotFound;
+    }
+    node = next;
+  }
+}
+
+#elif defined(__linux__)
+
+// MARK: - ELF Dynamic Symbols
+
+inline uint32_t GnuHash(const char *name) {
+  uint32_t h = 5381;
+  for (auto *p = reinterpret_cast<const unsigned char *>(name); *p; p++) {
+    h = (h << 5) + h + *p;
+  }
+  return h;
+}
+
+inline uint32_t SysvHash(const char *name) {
+  uint32_t h = 0;
+  for (auto *p = reinterpret_cast<const unsigned char *>(name); *p; p++) {
+    h = (h << 4) + *p;
+    uint32_t g = h & 0xf0000000u;
+    if (g != 0) {
+      h ^= g >> 24;
+    }
+    h &= ~g;
+  }
+  return h;
+}
+
+struct ElfExports {
+  ElfW(Addr) base = 0;
+  const ElfW(Sym) *symtab = nullptr;
+  const char *strtab = nullptr;
+  const ElfW(Half) *versym = nullptr;
+  // GNU hash
+  uint32_t gnuBucketCount = 0;
+  uint32_t gnuSymOffset = 0;
+  uint32_t gnuBloomSize = 0;
+  uint32_t gnuBloomShift = 0;
+  const ElfW(Addr) *gnuBloom = nullptr;
+  const uint32_t *gnuBuckets = nullptr;
+  const uint32_t *gnuChain = nullptr;
+  // SysV hash
+  const uint32_t *sysvHash = nullptr;
+};
+
+/**
+ * Locate the dynamic tables from a link map entry. Whether the loader has
+ * already relocated d_ptr values in place differs between architectures,
+ * so values below the load base are treated as unrelocated.
+ */
+inline bool LocateDynamicTables(const link_map *map, ElfExports &out) {
+  if (map->l_ld == nullptr) {
+    return false;
+  }
+  const ElfW(Addr) base = map->l_addr;
+  auto relocate = [base](ElfW(Addr) value) -> ElfW(Addr) {
+    return value < base ? value + base : value;
+  };
+  out.base = base;
+  for (const ElfW(Dyn) *dyn = map->l_ld; dyn->d_tag != DT_NULL; dyn++) {
+    switch (dyn->d_tag) {
+      case DT_SYMTAB:
+        out.symtab = reinterpret_cast<const ElfW(Sym) *>(relocate(dyn->d_un.d_ptr));
+        break;
+      case DT_STRTAB:
+        out.strtab = reinterpret_cast<const char *>(relocate(dyn->d_un.d_ptr));
+        break;
+      case DT_VERSYM:
+        out.versym = reinterpret_cast<const ElfW(Half) *>(relocate(dyn->d_un.d_ptr));
+        break;
+      case DT_HASH:
+        out.sysvHash = reinterpret_cast<const uint32_t *>(relocate(dyn->d_un.d_ptr));
+        break;
+      case DT_GNU_HASH: {
+        const auto *table = reinterpret_cast<const uint32_t *>(relocate(dyn->d_un.d_ptr));
+        out.gnuBucketCount = table[0];
+        out.gnuSymOffset = table[1];
+        out.gnuBloomSize = table[2];
+        out.gnuBloomShift = table[3];
+        out.gnuBloom = reinterpret_cast<const ElfW(Addr) *>(table + 4);
+        out.gnuBuckets = reinterpret_cast<const uint32_t *>(out.gnuBloom + out.gnuBloomSize);
+        out.gnuChain = out.gnuBuckets + out.gnuBucketCount;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return out.symtab != nullptr && out.strtab != nullptr &&
+         (out.gnuBuckets != nullptr || out.sysvHash != nullptr);
+}
+
+inline SymbolLookup ClassifyElfSymbol(const ElfExports &exports, uint32_t index,
+                                      void **address) {
+  const ElfW(Sym) &sym = exports.symtab[index];
+  if (sym.st_shndx == SHN_UNDEF) {
+    return SymbolLookup::NotFound;
+  }
+  // Hidden (non-default) versions are not what dlsym would return.
+  if (exports.versym != nullptr && (exports.versym[index] & 0x8000) != 0) {
+    return SymbolLookup::NotFound;
+  }
+  switch (ELF64_ST_BIND(sym.st_info)) {
+    case STB_GLOBAL:
+    case STB_WEAK:
+    case STB_GNU_UNIQUE:
+      break;
+    default:
+      return SymbolLookup::NotFound;
+  }
+  switch (ELF64_ST_TYPE(sym.st_info)) {
+    case STT_GNU_IFUNC:
+    case STT_TLS:
+      return SymbolLookup::NeedsDlsym;
+    default:
+      break;
+  }
+  *address = reinterpret_cast<void *>(
+      sym.st_shndx == SHN_ABS ? sym.st_value : exports.base + sym.st_value);
+  return SymbolLookup::Found;
+}
+
+inline SymbolLookup FindInDynamicSymbols(const ElfExports &exports,
+                                         const char *name, void **address) {
+  if (exports.gnuBuckets != nullptr) {
+    constexpr uint32_t kBloomBits = sizeof(ElfW(Addr)) * 8;
+    const uint32_t hash = GnuHash(name);
+    const ElfW(Addr) word =
+        exports.gnuBloom[(hash / kBloomBits) % exports.gnuBloomSize];
+    const ElfW(Addr) mask =
+        (ElfW(Addr)(1) << (hash % kBloomBits)) |
+        (ElfW(Addr)(1) << ((hash >> exports.gnuBloomShift) % kBloomBits));
+    if ((word & mask) != mask) {
+      return SymbolLookup::NotFound;
+    }
+    uint32_t index = exports.gnuBuckets[hash % exports.gnuBucketCount];
+    if (index < exports.gnuSymOffset) {
+      return SymbolLookup::NotFound;
+    }
+    for (;; index++) {
+      const uint32_t chainHash = exports.gnuChain[index - exports.gnuSymOffset];
+      if ((hash | 1) == (chainHash | 1) &&
+          std::strcmp(name, exports.strtab + exports.symtab[index].st_name) == 0) {
+        SymbolLookup result = ClassifyElfSymbol(exports, index, address);
+        if (result != SymbolLookup::NotFound) {
+          return result;
+        }
+      }
+      if ((chainHash & 1) != 0) {
+        return SymbolLookup::NotFound;
+      }
+    }
+  }
+
+  const uint32_t bucketCount = exports.sysvHash[0];
+  const uint32_t *buckets = exports.sysvHash + 2;
+  const uint32_t *chain = buckets + bucketCount;
+  for (uint32_t index = buckets[SysvHash(name) % bucketCount]; index != STN_UNDEF;
+       index = chain[index]) {
+    if (std::strcmp(name, exports.strtab + exports.symtab[index].st_name) == 0) {
+      SymbolLookup result = ClassifyElfSymbol(exports, index, address);
+      if (result != SymbolLookup::NotFound) {
+        return result;
+      }
+    }
+  }
+  return SymbolLookup::NotFound;
+}
+
+#endif
+
+} // namespace symbol_detail
+
+// MARK: - Image Symbol Index
+
+/**
+ * Export lookup for one loaded image. Holds a RTLD_NOLOAD reference to the
+ * image so it cannot be unloaded while the index exists, and uses that
+ * handle for the exports the table cannot resolve by itself.
+ */
+class ImageSymbolIndex {
+public:
+  /// Open the index for an already-loaded image, or return null if the
+  /// image is not loaded (or its export table cannot be located).
+  static std::unique_ptr<ImageSymbolIndex> Open(const char *path) {
+    void *handle = dlopen(path, RTLD_LAZY | RTLD_NOLOAD);
+    if (handle == nullptr) {
+      return nullptr;
+    }
+    std::unique_ptr<ImageSymbolIndex> index(new ImageSymbolIndex(path, handle));
+    if (!index->Locate()) {
+      return nullptr;
+    }
+    return index;
+  }
+
+  ~ImageSymbolIndex() { dlclose(handle_); }
+
+  ImageSymbolIndex(const ImageSymbolIndex &) = delete;
+  ImageSymbolIndex &operator=(const ImageSymbolIndex &) = delete;
+
+  /// Look `name` (the C name, without a leading underscore) up in the
+  /// export table only.
+  SymbolLookup Find(const char *name, void **address) const {
+#if defined(__APPLE__)
+    // C symbols are mangled with a leading underscore in Mach-O.
+    char stackName[256];
+    std::unique_ptr<char[]> heapName;
+    size_t length = std::strlen(name);
+    char *mangled = stackName;
+    if (length + 2 > sizeof(stackName)) {
+      heapName.reset(new char[length + 2]);
+      mangled = heapName.get();
+    }
+    mangled[0] = '_';
+    std::memcpy(mangled + 1, name, length + 1);
+    return symbol_detail::FindInExportTrie(exports_, mangled, address);
+#elif defined(__linux__)
+    return symbol_detail::FindInDynamicSymbols(exports_, name, address);
+#else
+    (void)name;
+    (void)address;
+    return SymbolLookup::NeedsDlsym;
+#endif
+  }
+
+  /// Resolve `name` to an address, falling back to dlsym on this image's
+  /// handle for indirect exports. Returns null if the image does not export it.
+  void *Resolve(const char *name) const {
+    void *address = nullptr;
+    switch (Find(name, &address)) {
+      case SymbolLookup::Found:
+        return address;
+      case SymbolLookup::NeedsDlsym:
+        return dlsym(handle_, name);
+      case SymbolLookup::NotFound:
+        return nullptr;
+    }
+    return nullptr;
+  }
+
+  const std::string &Path() const { return path_; }
+
+private:
+  ImageSymbolIndex(const char *path, void *handle)
+      : path_(path), handle_(handle) {}
+
+  bool Locate() {
+#if defined(__APPLE__)
+    // dyld reports canonical paths (e.g. .../Versions/C/Foundation), so
+    // match images by handle rather than by name.
+    const uint32_t count = _dyld_image_count();
+    for (uint32_t i = 0; i < count; i++) {
+      const char *imageName = _dyld_get_image_name(i);
+      if (imageName == nullptr) {
+        continue;
+      }
+      bool match = std::strcmp(imageName, path_.c_str()) == 0;
+      if (!match) {
+        void *candidate = dlopen(imageName, RTLD_LAZY | RTLD_NOLOAD);
+        match = candidate == handle_;
+        if (candidate != nullptr) {
+          dlclose(candidate);
+        }
+      }
+      if (match) {
+        return symbol_detail::LocateExportTrie(
+            reinterpret_cast<const mach_header_64 *>(_dyld_get_image_header(i)),
+            _dyld_get_image_vmaddr_slide(i), exports_);
+      }
+    }
+    return false;
+#elif defined(__linux__)
+    link_map *map = nullptr;
+    if (dlinfo(handle_, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr) {
+      return false;
+    }
+    return symbol_detail::LocateDynamicTables(map, exports_);
+#else
+    return true;
+#endif
+  }
+
+  std::string path_;
+  void *handle_;
+#if defined(__APPLE__)
+  symbol_detail::MachOExports exports_;
+#elif defined(__linux__)
+  symbol_detail::ElfExports exports_;
+#endif
+};
+
+} // namespace nobjc
+
+#endif // SYMBOL_INDEX_H
@@ -0,0 +1,36 @@
+#ifndef SYMBOL_RESOLUTION_H
+#define SYMBOL_RESOLUTION_H
+
+#include <napi.h>
+#include <string>
+
+// MARK: - Resolved Symbol Cache
+
+// Look up a C function for CallFunction. Consults the process-wide cache of
+// dlsym(RTLD_DEFAULT) results (filled by earlier calls and by ResolveSymbols
+// without an image) first, and only calls dlsym on a miss. Misses are not
+// cached, since the library defining the symbol may be loaded later. Returns
+// null if not found.
+void *LookupFunctionSymbol(const std::string &name);
+
+// Look up a C function through the export index of one loaded image,
+// bypassing the RTLD_DEFAULT cache. Returns null if the image does not export
+// `name`. Throws if the image is not loaded.
+void *LookupImageFunctionSymbol(Napi::Env env, const std::string &image,
+                                const std::string &name);
+
+// MARK: - Exported Functions
+
+// Resolve many symbols in one call.
+// Arguments:
+//   - names (string[]): C symbol names (without a leading underscore)
+//   - image (string | undefined): Path of an already-loaded library to
+//     resolve against through its export index. When omitted, each name is
+//     resolved with dlsym(RTLD_DEFAULT) and cached for CallFunction.
+//     Image-scoped results are not cached; pass the image (or the returned
+//     address) to CallFunction instead.
+// Returns: An object mapping each name to its address (bigint) or null.
+// Throws if `image` is given but not loaded.
+Napi::Value ResolveSymbols(const Napi::CallbackInfo &info);
+
+#endif // SYMBOL_RESOLUTION_H
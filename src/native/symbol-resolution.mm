@@ -0,0 +1,130 @@
+#include "symbol-resolution.h"
+#include "symbol-index.h"
+#include <dlfcn.h>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// MARK: - Registry
+
+/**
+ * Process-wide state: RTLD_DEFAULT symbol addresses and image indexes are
+ * the same for every env, and CallFunction may run on worker threads, so
+ * both tables live behind one mutex. Images are never unloaded while
+ * indexed, because each ImageSymbolIndex holds a reference to its image.
+ */
+class SymbolRegistry {
+public:
+  static SymbolRegistry &Instance() {
+    static SymbolRegistry instance;
+    return instance;
+  }
+
+  void *CachedAddress(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = addresses_.find(name);
+    return it == addresses_.end() ? nullptr : it->second;
+  }
+
+  void Remember(const std::string &name, void *address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    addresses_.emplace(name, address);
+  }
+
+  // Returns null if the image is not loaded.
+  const nobjc::ImageSymbolIndex *IndexFor(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = indexes_.find(path);
+    if (it != indexes_.end()) {
+      return it->second.get();
+    }
+    std::unique_ptr<nobjc::ImageSymbolIndex> index =
+        nobjc::ImageSymbolIndex::Open(path.c_str());
+    if (!index) {
+      return nullptr;
+    }
+    return indexes_.emplace(path, std::move(index)).first->second.get();
+  }
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, void *> addresses_;
+  std::unordered_map<std::string, std::unique_ptr<nobjc::ImageSymbolIndex>> indexes_;
+};
+
+// MARK: - Lookup
+
+void *LookupFunctionSymbol(const std::string &name) {
+  SymbolRegistry &registry = SymbolRegistry::Instance();
+  if (void *cached = registry.CachedAddress(name)) {
+    return cached;
+  }
+  void *address = dlsym(RTLD_DEFAULT, name.c_str());
+  if (address != nullptr) {
+    registry.Remember(name, address);
+  }
+  return address;
+}
+
+static const nobjc::ImageSymbolIndex *RequireImageIndex(Napi::Env env,
+                                                        const std::string &image) {
+  const nobjc::ImageSymbolIndex *index =
+      SymbolRegistry::Instance().IndexFor(image);
+  if (index == nullptr) {
+    throw Napi::Error::New(env, "Image '" + image +
+                                    "' is not loaded or has no export table. "
+                                    "Load it first with LoadLibrary.");
+  }
+  return index;
+}
+
+void *LookupImageFunctionSymbol(Napi::Env env, const std::string &image,
+                                const std::string &name) {
+  return RequireImageIndex(env, image)->Resolve(name.c_str());
+}
+
+// MARK: - Exported Functions
+
+Napi::Value ResolveSymbols(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    throw Napi::TypeError::New(env, "Expected an array of symbol names");
+  }
+  Napi::Array namesArray = info[0].As<Napi::Array>();
+  std::vector<std::string> names;
+  names.reserve(namesArray.Length());
+  for (uint32_t i = 0; i < namesArray.Length(); i++) {
+    Napi::Value name = namesArray.Get(i);
+    if (!name.IsString()) {
+      throw Napi::TypeError::New(env, "Symbol names must be strings");
+    }
+    names.push_back(name.As<Napi::String>().Utf8Value());
+  }
+
+  const nobjc::ImageSymbolIndex *index = nullptr;
+  if (info.Length() >= 2 && !info[1].IsUndefined() && !info[1].IsNull()) {
+    if (!info[1].IsString()) {
+      throw Napi::TypeError::New(env, "Image must be a string path");
+    }
+    index = RequireImageIndex(env, info[1].As<Napi::String>().Utf8Value());
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  for (const std::string &name : names) {
+    // Only the RTLD_DEFAULT form goes through (and fills) the CallFunction
+    // cache. Image-scoped results stay out of it, since a global lookup of
+    // the same name may find another image's definition.
+    void *address = index != nullptr ? index->Resolve(name.c_str())
+                                     : LookupFunctionSymbol(name);
+    if (address == nullptr) {
+      result.Set(name, env.Null());
+      continue;
+    }
+    result.Set(name, Napi::BigInt::New(
+                         env, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address))));
+  }
+  return result;
+}
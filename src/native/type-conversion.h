@@ -27,6 +27,7 @@
  */
 
 #include "ObjcObject.h"
+#include "string-utils.h"
 #include "type-dispatch.h"
 #include <Foundation/Foundation.h>
 #include <napi.h>
@@ -242,7 +243,7 @@ struct ObjCToJSVisitor {
     if (value == nullptr) {
       return env.Null();
     }
-    return Napi::String::New(env, value);
+    return CStringToJS(env, value);
   }
 
   // id -> ObjcObject or Null
@@ -269,11 +270,7 @@ struct ObjCToJSVisitor {
     if (value == nullptr) {
       return env.Null();
     }
-    NSString* selectorString = NSStringFromSelector(value);
-    if (selectorString == nil) {
-      return env.Null();
-    }
-    return Napi::String::New(env, [selectorString UTF8String]);
+    return CStringToJS(env, sel_getName(value));
   }
 
   // Pointer -> Undefined (not fully supported)
@@ -321,7 +318,7 @@ struct ExtractInvocationArgVisitor {
     if (value == nullptr) {
       return env.Null();
     }
-    return Napi::String::New(env, value);
+    return CStringToJS(env, value);
   }
 
   // id -> ObjcObject or Null
@@ -351,11 +348,7 @@ struct ExtractInvocationArgVisitor {
     if (value == nullptr) {
       return env.Null();
     }
-    NSString* selString = NSStringFromSelector(value);
-    if (selString == nil) {
-      return env.Null();
-    }
-    return Napi::String::New(env, [selString UTF8String]);
+    return CStringToJS(env, sel_getName(value));
   }
 
   // Pointer -> Undefined (not fully supported)
@@ -584,8 +577,7 @@ inline void SetInvocationReturnFromJS(NSInvocation *invocation,
     if (result.IsObject()) {
       Napi::Object resultObj = result.As<Napi::Object>();
       if (ObjcObject::IsInstance(result.Env(), resultObj)) {
-        ObjcObject *objcObj = Napi::ObjectWrap<ObjcObject>::Unwrap(resultObj);
-        id objcValue = objcObj->objcObject;
+        id objcValue = ObjcObject::UnwrapObject(result.Env(), resultObj);
         [invocation setReturnValue:&objcValue];
       }
     }
@@ -628,7 +620,7 @@ struct GetInvocationReturnVisitor {
     if (result == nullptr) {
       return env.Null();
     }
-    return Napi::String::New(env, result);
+    return CStringToJS(env, result);
   }
 
   // id -> ObjcObject or Null
@@ -658,11 +650,7 @@ struct GetInvocationReturnVisitor {
     if (result == nullptr) {
       return env.Null();
     }
-    NSString* selectorString = NSStringFromSelector(result);
-    if (selectorString == nil) {
-      return env.Null();
-    }
-    return Napi::String::New(env, [selectorString UTF8String]);
+    return CStringToJS(env, sel_getName(result));
   }
 
   // Pointer -> Error (unsupported)
@@ -0,0 +1,26 @@
+#ifndef WEAK_REFERENCE_H
+#define WEAK_REFERENCE_H
+
+#include <napi.h>
+
+// MARK: - Weak References
+
+// Create a zeroing weak reference to an object without retaining it.
+// Arguments: object (ObjcObject)
+// Returns: External<WeakReference>
+// Throws if the object's class refuses weak references
+// (-allowsWeakReference returns NO, e.g. while it is deallocating).
+Napi::Value CreateWeakReference(const Napi::CallbackInfo &info);
+
+// Load a weak reference.
+// Arguments: handle (External<WeakReference>)
+// Returns: A retained ObjcObject wrapper, or null once the object has been
+//   deallocated
+Napi::Value LoadWeakReference(const Napi::CallbackInfo &info);
+
+// Load many weak references in one crossing.
+// Arguments: handles (External<WeakReference>[])
+// Returns: (ObjcObject | null)[] in the same order
+Napi::Value LoadWeakReferences(const Napi::CallbackInfo &info);
+
+#endif // WEAK_REFERENCE_H
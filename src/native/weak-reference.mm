@@ -0,0 +1,97 @@
+#include "weak-reference.h"
+#include "ObjcObject.h"
+#include <Foundation/Foundation.h>
+#include <napi.h>
+#include <objc/message.h>
+#include <objc/runtime.h>
+
+// The zeroing weak reference entry points are part of the stable ObjC ABI
+// but, like objc_retain/objc_release, are not declared for MRC code.
+extern "C" id objc_initWeak(id *location, id value);
+extern "C" void objc_destroyWeak(id *location);
+extern "C" id objc_loadWeakRetained(id *location);
+
+// MARK: - Weak Reference Storage
+
+/**
+ * Heap storage for one __weak slot. The runtime registers the slot's
+ * address in the object's weak table, so it must not move: the External
+ * owns it by pointer and unregisters it in the finalizer.
+ */
+struct WeakReference {
+  id slot = nil;
+};
+
+static bool AllowsWeakReference(id object) {
+  static SEL allowsWeakReference = sel_registerName("allowsWeakReference");
+  if (![object respondsToSelector:allowsWeakReference]) {
+    return true;
+  }
+  return ((BOOL (*)(id, SEL))objc_msgSend)(object, allowsWeakReference);
+}
+
+// Load and wrap. The wrapper takes its own retain (also inside a
+// borrowScope), so the +1 from objc_loadWeakRetained is balanced right after.
+static Napi::Value LoadWrapped(Napi::Env env, WeakReference *reference) {
+  id object = objc_loadWeakRetained(&reference->slot);
+  if (object == nil) {
+    return env.Null();
+  }
+  Napi::Value wrapper =
+      ObjcObject::NewInstance(env, object, WrapMode::Retained);
+  objc_release(object);
+  return wrapper;
+}
+
+static WeakReference *UnwrapWeakReference(Napi::Env env,
+                                          const Napi::Value &value) {
+  if (!value.IsExternal()) {
+    throw Napi::TypeError::New(env, "Expected a weak reference handle");
+  }
+  return value.As<Napi::External<WeakReference>>().Data();
+}
+
+// MARK: - Exported Functions
+
+Napi::Value CreateWeakReference(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsObject() ||
+      !ObjcObject::IsInstance(env, info[0])) {
+    throw Napi::TypeError::New(env, "Expected a single ObjcObject argument");
+  }
+  id object = ObjcObject::UnwrapObject(env, info[0]);
+  if (object != nil && !AllowsWeakReference(object)) {
+    throw Napi::Error::New(
+        env, std::string("Cannot form a weak reference to an instance of ") +
+                 object_getClassName(object));
+  }
+  auto *reference = new WeakReference();
+  objc_initWeak(&reference->slot, object);
+  return Napi::External<WeakReference>::New(
+      env, reference, [](Napi::Env, WeakReference *r) {
+        objc_destroyWeak(&r->slot);
+        delete r;
+      });
+}
+
+Napi::Value LoadWeakReference(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1) {
+    throw Napi::TypeError::New(env, "Expected a weak reference handle");
+  }
+  return LoadWrapped(env, UnwrapWeakReference(env, info[0]));
+}
+
+Napi::Value LoadWeakReferences(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsArray()) {
+    throw Napi::TypeError::New(env, "Expected an array of weak reference handles");
+  }
+  Napi::Array handles = info[0].As<Napi::Array>();
+  const uint32_t count = handles.Length();
+  Napi::Array results = Napi::Array::New(env, count);
+  for (uint32_t i = 0; i < count; i++) {
+    results.Set(i, LoadWrapped(env, UnwrapWeakReference(env, handles.Get(i))));
+  }
+  return results;
+}
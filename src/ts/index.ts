@@ -1,19 +1,69 @@
 import {
   LoadLibrary,
+  LoadLibraryAsync,
   GetClassObject,
   ObjcObject,
   GetPointer,
   FromPointer,
+  BeginBorrowScope,
+  EndBorrowScope,
+  CreateWeakReference,
+  LoadWeakReference,
+  LoadWeakReferences,
+  ToArrayBuffer,
   CreateProtocolImplementation,
   DefineClass,
   CallSuper,
-  CallFunction
+  CallFunction,
+  ResolveSymbols,
+  ObserveKeyPath,
+  StopObserving,
+  SubscribeNotification,
+  Unsubscribe,
+  InputStreamOpen,
+  InputStreamRead,
+  InputStreamClose,
+  OutputStreamOpen,
+  OutputStreamWrite,
+  OutputStreamClose,
+  ParallelSendMap,
+  BindInvocation,
+  InvokeBound,
+  CreateLazyView,
+  LazyViewCount,
+  LazyViewGet,
+  LazyViewGetRange,
+  LazyViewKeys,
+  ConfigureStringIntern,
+  GetStringInternStats,
+  GetCallbackDispatcherStats,
+  ConfigureCallbackTimeout,
+  StartCallProfiler,
+  StopCallProfiler,
+  StartCallTrace,
+  StopCallTrace
 } from "./native.js";
 import { NobjcNative } from "./native.js";
+import { parseTrace, summarizeTrace } from "./trace-format.js";
+import type { CallTrace, TraceCallKind, TraceRecord, TraceShape, TraceValueShape } from "./trace-format.js";
+import { createRequire } from "node:module";
+import type { Readable, Writable } from "node:stream";
 
 const customInspectSymbol = Symbol.for("nodejs.util.inspect.custom");
 const NATIVE_OBJC_OBJECT = Symbol("nativeObjcObject");
 const TYPED_BLOCK_ENCODING = "__nobjcBlockTypeEncoding";
+const CALLBACK_PRIORITY = "__nobjcCallbackPriority";
+const CALLBACK_TIMEOUT = "__nobjcCallbackTimeoutMs";
+const CALLBACK_DEFAULT_RETURN = "__nobjcCallbackDefaultReturn";
+const CALLBACK_MARKERS = [TYPED_BLOCK_ENCODING, CALLBACK_PRIORITY, CALLBACK_TIMEOUT, CALLBACK_DEFAULT_RETURN];
+
+// node:stream is only needed by the stream adapters; load it on first use to
+// keep it off the import path.
+const nodeRequire = createRequire(import.meta.url);
+let streamModule: typeof import("node:stream") | undefined;
+function loadStreamModule(): typeof import("node:stream") {
+  return (streamModule ??= nodeRequire("node:stream") as typeof import("node:stream"));
+}
 
 // WeakMap side-channel for O(1) proxy → native object lookup (bypasses Proxy traps)
 const nativeObjectMap = new WeakMap<object, NobjcNative.ObjcObject>();
@@ -36,9 +86,26 @@ const BUILT_IN_PROPS = new Set([
 // WeakMap cache for NobjcMethod proxies per object to avoid GC pressure
 const methodCache = new WeakMap<NobjcNative.ObjcObject, Map<string, NobjcMethod>>();
 
+/**
+ * Options for the NobjcLibrary constructor.
+ */
+interface NobjcLibraryOptions {
+  /**
+   * Start loading the library on a background thread right away instead of
+   * on first class access. The first access still waits for the load to
+   * finish, but the time spent evaluating other modules in between overlaps
+   * with it.
+   */
+  preload?: boolean;
+}
+
 class NobjcLibrary {
   [key: string]: NobjcObject;
-  constructor(library: string) {
+  constructor(library: string, options: NobjcLibraryOptions = {}) {
+    if (options.preload) {
+      // Always resolves; a failed load surfaces from LoadLibrary on first access.
+      void LoadLibraryAsync([library]);
+    }
     const classCache = new Map<string, NobjcObject>();
     const handler: ProxyHandler<any> & { wasLoaded: boolean } = {
       wasLoaded: false,
@@ -63,6 +130,53 @@ class NobjcLibrary {
   }
 }
 
+/**
+ * The outcome of loading one library with loadLibraryAsync.
+ */
+interface LibraryLoadResult {
+  /** The path as passed in. */
+  path: string;
+  /** Whether dlopen succeeded. */
+  loaded: boolean;
+  /** Wall-clock time spent in dlopen, including image initializers. */
+  ms: number;
+  /** The dlerror() message when loading failed. */
+  error?: string;
+}
+
+/**
+ * Load several libraries in parallel on background threads.
+ *
+ * Framework loading (mapping plus image initializers) can take tens to
+ * hundreds of milliseconds for frameworks like AppKit or AVFoundation.
+ * Starting it early and awaiting the promise later overlaps that time with
+ * JS module evaluation. Libraries loaded this way are ready for a
+ * NobjcLibrary with the same path.
+ *
+ * The promise does not reject when a library fails to load; check each
+ * result's `loaded` / `error` instead.
+ *
+ * @param paths - Library or framework binary paths
+ * @returns One LibraryLoadResult per path, in the same order
+ *
+ * @example
+ * ```typescript
+ * const loading = loadLibraryAsync([
+ *   "/System/Library/Frameworks/AppKit.framework/AppKit",
+ *   "/System/Library/Frameworks/AVFoundation.framework/AVFoundation"
+ * ]);
+ * // ... other startup work ...
+ * for (const { path, ms } of await loading) console.log(path, ms.toFixed(1));
+ * const appKit = new NobjcLibrary("/System/Library/Frameworks/AppKit.framework/AppKit");
+ * ```
+ */
+function loadLibraryAsync(paths: string[]): Promise<LibraryLoadResult[]> {
+  if (!Array.isArray(paths)) {
+    throw new TypeError("loadLibraryAsync expects an array of paths");
+  }
+  return LoadLibraryAsync(paths);
+}
+
 function NobjcMethodNameToObjcSelector(methodName: string): string {
   return methodName.replace(/\$/g, ":");
 }
@@ -101,7 +215,7 @@ class NobjcObject {
         // Handle customInspectSymbol in get trap instead of mutating native object
         // (avoids hidden class transition that deoptimizes V8 inline caches)
         if (methodName === customInspectSymbol) {
-          return () => proxy.toString();
+          return () => object.$toString();
         }
 
         // guard against symbols
@@ -109,7 +223,22 @@ class NobjcObject {
           return Reflect.get(object, methodName, receiver);
         }
 
-        // handle toString separately (cached to avoid repeated closure allocation and FFI check)
+        // $retain() promotes a wrapper borrowed in a borrowScope.
+        if (methodName === "$retain") {
+          return () => {
+            object.$retain();
+            return receiver;
+          };
+        }
+
+        // $weak() returns a weak reference that does not retain the object.
+        if (methodName === "$weak") {
+          return () => new NobjcWeakRef(receiver);
+        }
+
+        // handle toString separately (cached to avoid repeated closure allocation).
+        // $toString converts NSStrings directly and everything else via
+        // -description in a single native crossing.
         if (methodName === "toString") {
           let cache = methodCache.get(object);
           if (!cache) {
@@ -118,11 +247,7 @@ class NobjcObject {
           }
           let fn = cache.get("toString");
           if (!fn) {
-            // Check directly on native object to avoid triggering proxy has trap
-            const hasUTF8 = target.$respondsToSelector("UTF8String") as boolean;
-            fn = (hasUTF8
-              ? () => String(object.$msgSend("UTF8String"))
-              : () => String(wrapObjCObjectIfNeeded(object.$msgSend("description")))) as unknown as NobjcMethod;
+            fn = (() => object.$toString()) as unknown as NobjcMethod;
             cache.set("toString", fn);
           }
           return fn;
@@ -163,7 +288,7 @@ class NobjcObject {
 
     // Set custom inspect on the native object so console.log works through the Proxy.
     // Runtimes (Node, Bun) bypass Proxy traps during inspect and read the target directly.
-    (object as any)[customInspectSymbol] = () => proxy.toString();
+    (object as any)[customInspectSymbol] = () => object.$toString();
 
     // Store proxy → native mapping in WeakMap for O(1) unwrap (bypasses Proxy traps)
     nativeObjectMap.set(proxy as unknown as object, object);
@@ -173,6 +298,58 @@ class NobjcObject {
   }
 }
 
+/**
+ * A zeroing weak reference to an Objective-C object.
+ *
+ * Unlike a NobjcObject, a NobjcWeakRef does not retain the object, so caches,
+ * observer lists and back-references held from JS don't keep it alive or
+ * form retain cycles with JS-implemented delegates. Once the object is
+ * deallocated, `deref()` returns null.
+ *
+ * Create one with `obj.$weak()` or `new NobjcWeakRef(obj)`.
+ *
+ * @example
+ * ```typescript
+ * const parentRef = view.superview().$weak();
+ * // ... later ...
+ * const parent = parentRef.deref();
+ * if (parent) parent.setNeedsDisplay$(true);
+ * ```
+ */
+class NobjcWeakRef<T extends NobjcObject = NobjcObject> {
+  private readonly handle: unknown;
+
+  constructor(target: T) {
+    const nativeObj = nativeObjectMap.get(target as unknown as object);
+    if (!nativeObj) {
+      throw new TypeError("NobjcWeakRef target must be a NobjcObject");
+    }
+    this.handle = CreateWeakReference(nativeObj);
+  }
+
+  /**
+   * Return a (retained) wrapper for the object, or null if it has been
+   * deallocated.
+   */
+  deref(): T | null {
+    const obj = LoadWeakReference(this.handle);
+    return obj === null ? null : (new NobjcObject(obj) as T);
+  }
+
+  /**
+   * Dereference many weak references in one native call.
+   *
+   * @example
+   * ```typescript
+   * const live = NobjcWeakRef.derefAll(cache.values()).filter((obj) => obj !== null);
+   * ```
+   */
+  static derefAll<T extends NobjcObject>(refs: Iterable<NobjcWeakRef<T>>): (T | null)[] {
+    const handles = Array.from(refs, (ref) => ref.handle);
+    return LoadWeakReferences(handles).map((obj) => (obj === null ? null : (new NobjcObject(obj) as T)));
+  }
+}
+
 export interface TypedBlockOptions {
   /**
    * Block return type encoding. Example: "v" (void), "@" (id), "B" (BOOL).
@@ -190,6 +367,21 @@ export interface TypedBlockOptions {
    * When provided, this takes precedence over returns/args.
    */
   types?: string;
+
+  /**
+   * Delivery lane when the block is called from another thread.
+   * Defaults to "blocking". See `withPriority()`.
+   */
+  priority?: CallbackPriority;
+
+  /**
+   * How long a calling thread waits for the JS thread before giving up.
+   * Defaults to `setCallbackTimeout()`'s value. See `withTimeout()`.
+   */
+  timeoutMs?: number;
+
+  /** Value returned to the caller on timeout. See `withTimeout()`. */
+  defaultReturn?: CallbackDefaultReturn;
 }
 
 function normalizeTypedBlockEncoding(signature: string | TypedBlockOptions): string {
@@ -232,9 +424,128 @@ function typedBlock<T extends (...args: any[]) => any>(signature: string | Typed
     enumerable: false,
     configurable: true
   });
+  if (typeof signature !== "string") {
+    if (signature.priority !== undefined) withPriority(signature.priority, fn);
+    tagCallbackTimeout(fn, signature.timeoutMs, signature.defaultReturn);
+  }
   return fn;
 }
 
+/**
+ * Delivery lane for callbacks invoked from threads other than the JS thread.
+ *
+ * - `"blocking"`: a native thread is waiting for the result (default for
+ *   protocol methods, subclass methods and blocks)
+ * - `"interactive"`: nobody waits, but latency matters (default for
+ *   `observe()` and `subscribe()`)
+ * - `"background"`: bulk work that may wait behind everything else
+ */
+type CallbackPriority = "blocking" | "interactive" | "background";
+
+const CALLBACK_PRIORITIES = new Set<string>(["blocking", "interactive", "background"]);
+
+/**
+ * Assign a delivery lane to a callback.
+ *
+ * Callbacks invoked from other threads are queued for the JS thread, which
+ * serves every "blocking" callback before any "interactive" one, and those
+ * before "background" ones. Tag a progress block or a chatty delegate method
+ * "background" so it cannot delay callbacks that a native thread is waiting on.
+ *
+ * Works for protocol methods, subclass method implementations and functions
+ * passed as blocks. Returns `fn`.
+ *
+ * @example
+ * ```typescript
+ * const delegate = NobjcProtocol.implement("NSURLSessionDataDelegate", {
+ *   URLSession$dataTask$didReceiveData$: withPriority("background", (session, task, data) => {
+ *     chunks.push(data);
+ *   })
+ * });
+ * ```
+ */
+function withPriority<T extends (...args: any[]) => any>(priority: CallbackPriority, fn: T): T {
+  if (!CALLBACK_PRIORITIES.has(priority)) {
+    throw new TypeError(`Unknown callback priority: ${priority}`);
+  }
+  Object.defineProperty(fn, CALLBACK_PRIORITY, {
+    value: priority,
+    enumerable: false,
+    configurable: true
+  });
+  return fn;
+}
+
+/** Value handed back to a native caller whose callback timed out. */
+type CallbackDefaultReturn = number | boolean | null;
+
+function tagCallbackTimeout(fn: Function, timeoutMs?: number, defaultReturn?: CallbackDefaultReturn): void {
+  if (timeoutMs !== undefined) {
+    if (typeof timeoutMs !== "number" || !(timeoutMs >= 0)) {
+      throw new RangeError(`Callback timeout must be a non-negative number of milliseconds: ${timeoutMs}`);
+    }
+    Object.defineProperty(fn, CALLBACK_TIMEOUT, { value: timeoutMs, enumerable: false, configurable: true });
+  }
+  if (defaultReturn !== undefined) {
+    if (defaultReturn !== null && typeof defaultReturn !== "number" && typeof defaultReturn !== "boolean") {
+      throw new TypeError("defaultReturn must be a number, boolean or null");
+    }
+    Object.defineProperty(fn, CALLBACK_DEFAULT_RETURN, { value: defaultReturn, enumerable: false, configurable: true });
+  }
+}
+
+/**
+ * Bound how long a native thread waits for a callback.
+ *
+ * A protocol method, subclass method or block called from another thread
+ * parks that thread until the JS thread has run the callback. With a
+ * timeout, the thread gives up if the JS thread has not *started* the
+ * callback within `timeoutMs` and returns `defaultReturn` instead (zero,
+ * nil or NO when omitted; numbers and booleans are only accepted for
+ * numeric and BOOL returns). The queued call is then skipped. A callback
+ * that has already started always runs to completion.
+ *
+ * `timeoutMs` 0 waits forever. Returns `fn`.
+ *
+ * @example
+ * ```typescript
+ * const delegate = NobjcProtocol.implement("NSTableViewDataSource", {
+ *   numberOfRowsInTableView$: withTimeout(50, () => rows.length, 0)
+ * });
+ * ```
+ */
+function withTimeout<T extends (...args: any[]) => any>(
+  timeoutMs: number,
+  fn: T,
+  defaultReturn?: CallbackDefaultReturn
+): T {
+  tagCallbackTimeout(fn, timeoutMs, defaultReturn);
+  return fn;
+}
+
+/**
+ * Set the timeout for cross-thread callbacks that do not set their own
+ * with `withTimeout()`. Defaults to 0 (wait forever).
+ */
+function setCallbackTimeout(timeoutMs: number): void {
+  ConfigureCallbackTimeout(timeoutMs);
+}
+
+// Carry typedBlock(), withPriority() and withTimeout() tags over to the
+// wrapper handed to native code.
+function copyCallbackMarkers(from: Function, to: Function): void {
+  for (const marker of CALLBACK_MARKERS) {
+    const value = (from as any)[marker];
+    if (value !== undefined) {
+      Object.defineProperty(to, marker, {
+        value,
+        enumerable: false,
+        configurable: true
+      });
+    }
+  }
+}
+
 function unwrapArg(arg: any): any {
   if (arg && typeof arg === "object") {
     return nativeObjectMap.get(arg) ?? arg;
@@ -248,14 +559,7 @@ function unwrapArg(arg: any): any {
       }
       return unwrapArg(arg(...nativeArgs));
     };
-    const explicitBlockEncoding = (arg as any)[TYPED_BLOCK_ENCODING];
-    if (typeof explicitBlockEncoding === "string") {
-      Object.defineProperty(wrapped, TYPED_BLOCK_ENCODING, {
-        value: explicitBlockEncoding,
-        enumerable: false,
-        configurable: true
-      });
-    }
+    copyCallbackMarkers(arg, wrapped);
     // Preserve the original function's .length so the native layer can read it
     // (used to infer block parameter count when extended encoding is unavailable)
     Object.defineProperty(wrapped, "length", { value: arg.length });
@@ -326,6 +630,7 @@ class NobjcProtocol {
         // If the result is already a NobjcObject, unwrap it to get the native object
         return unwrapArg(result);
       };
+      copyCallbackMarkers(impl, convertedMethods[selector]);
     }
 
     // Call native implementation
@@ -395,6 +700,42 @@ function fromPointer(pointer: Buffer | bigint): NobjcObject {
   return new NobjcObject(nativeObj);
 }
 
+/**
+ * Expose the contents of an NSData as an ArrayBuffer without copying.
+ *
+ * The ArrayBuffer points straight at `[data bytes]` and keeps the NSData
+ * alive until the ArrayBuffer is garbage collected. Combined with
+ * `NSDataReadingMappedIfSafe`, this reads files through memory mapping with
+ * no copy into the JS heap.
+ *
+ * NSMutableData is snapshotted first, since its bytes can move when it is
+ * mutated. Runtimes that forbid external buffers (Electron) receive a copy.
+ *
+ * The zero-copy buffer is **read-only by contract**. Its bytes are shared
+ * with every other holder of the NSData, and for memory-mapped files they
+ * are read-only pages: writing through a view crashes the process. Pass
+ * `{ copy: true }` for a private, writable ArrayBuffer.
+ *
+ * @param data - An NSData (or subclass) instance
+ * @param options.copy - Copy the bytes into a writable ArrayBuffer (default: false)
+ * @returns An ArrayBuffer over the data's bytes, or a copy of them
+ *
+ * @example
+ * ```typescript
+ * const NSData = Foundation.NSData;
+ * const path = NSString.stringWithUTF8String$("/path/to/asset.bin");
+ * const data = NSData.dataWithContentsOfFile$options$error$(path, 1, null); // NSDataReadingMappedIfSafe
+ * const bytes = new Uint8Array(toArrayBuffer(data));
+ * ```
+ */
+function toArrayBuffer(data: NobjcObject, options: { copy?: boolean } = {}): ArrayBuffer {
+  const nativeObj = nativeObjectMap.get(data as unknown as object);
+  if (!nativeObj) {
+    throw new TypeError("Argument must be a NobjcObject instance");
+  }
+  return ToArrayBuffer(nativeObj, options.copy === true);
+}
+
 /**
  * Method definition for defining a class method.
  */
@@ -426,6 +767,21 @@ interface MethodDefinition {
    * For NSError** out-params, the arg is an object with { set(error), get() } methods.
    */
   implementation: (self: NobjcObject, ...args: any[]) => any;
+
+  /**
+   * Delivery lane when the method is called from another thread.
+   * Defaults to "blocking" (or the implementation's `withPriority()` tag).
+   */
+  priority?: CallbackPriority;
+
+  /**
+   * How long a calling thread waits for the JS thread before giving up
+   * (or the implementation's `withTimeout()` tag). See `withTimeout()`.
+   */
+  timeoutMs?: number;
+
+  /** Value returned to the caller on timeout. See `withTimeout()`. */
+  defaultReturn?: CallbackDefaultReturn;
 }
 
 /**
@@ -502,32 +858,35 @@ class NobjcClass {
       nativeDefinition.methods = {};
       for (const [selector, methodDef] of Object.entries(definition.methods)) {
         const normalizedSelector = NobjcMethodNameToObjcSelector(selector);
-        nativeDefinition.methods[normalizedSelector] = {
-          types: methodDef.types,
-          implementation: (nativeSelf: any, ...nativeArgs: any[]) => {
-            // Wrap self
-            const wrappedSelf = wrapObjCObjectIfNeeded(nativeSelf) as NobjcObject;
-
-            // Wrap args in-place to avoid allocation (preserve out-param objects)
-            for (let i = 0; i < nativeArgs.length; i++) {
-              const arg = nativeArgs[i];
-              if (arg && typeof arg === "object" && typeof arg.set === "function") {
-                nativeArgs[i] = {
-                  set: (error: any) => arg.set(unwrapArg(error)),
-                  get: () => wrapObjCObjectIfNeeded(arg.get())
-                };
-              } else {
-                nativeArgs[i] = wrapObjCObjectIfNeeded(arg);
-              }
+        const implementation = (nativeSelf: any, ...nativeArgs: any[]) => {
+          // Wrap self
+          const wrappedSelf = wrapObjCObjectIfNeeded(nativeSelf) as NobjcObject;
+
+          // Wrap args in-place to avoid allocation (preserve out-param objects)
+          for (let i = 0; i < nativeArgs.length; i++) {
+            const arg = nativeArgs[i];
+            if (arg && typeof arg === "object" && typeof arg.set === "function") {
+              nativeArgs[i] = {
+                set: (error: any) => arg.set(unwrapArg(error)),
+                get: () => wrapObjCObjectIfNeeded(arg.get())
+              };
+            } else {
+              nativeArgs[i] = wrapObjCObjectIfNeeded(arg);
             }
+          }
 
-            // Call the user's implementation
-            const result = methodDef.implementation(wrappedSelf, ...nativeArgs);
+          // Call the user's implementation
+          const result = methodDef.implementation(wrappedSelf, ...nativeArgs);
 
-            // Unwrap the return value
-            return unwrapArg(result);
-          }
+          // Unwrap the return value
+          return unwrapArg(result);
         };
+        copyCallbackMarkers(methodDef.implementation, implementation);
+        if (methodDef.priority !== undefined) {
+          withPriority(methodDef.priority, implementation);
+        }
+        tagCallbackTimeout(implementation, methodDef.timeoutMs, methodDef.defaultReturn);
+        nativeDefinition.methods[normalizedSelector] = { types: methodDef.types, implementation };
       }
     }
 
@@ -586,6 +945,13 @@ interface CallFunctionOptions {
   args?: string[];
   /** Combined type string (return type + arg types). Alternative to returns/args. E.g. "@#" = returns @, arg #. */
   types?: string;
+  /**
+   * Path of an already-loaded library to look the function up in, through its
+   * export table instead of a dlsym scan of every loaded image.
+   */
+  image?: string;
+  /** Function address from resolveSymbols. Skips symbol lookup entirely. Exclusive with `image`. */
+  address?: bigint;
 }
 
 /**
@@ -650,7 +1016,16 @@ function inferArgType(arg: any): string {
 function isCallOptions(value: any): value is CallFunctionOptions {
   if (value === null || value === undefined || typeof value !== "object") return false;
   if (nativeObjectMap.has(value)) return false; // It's a NobjcObject proxy
-  return "returns" in value || "types" in value || "args" in value;
+  return "returns" in value || "types" in value || "args" in value || "image" in value || "address" in value;
+}
+
+/**
+ * The native CallFunction target: the bare name for a global lookup, or the
+ * name with an image or resolved address.
+ */
+function functionTarget(name: string, options: CallFunctionOptions | null): string | object {
+  if (options?.image === undefined && options?.address === undefined) return name;
+  return { name, image: options.image, address: options.address };
 }
 
 /**
@@ -714,6 +1089,12 @@ function resolveTypes(options: CallFunctionOptions | null, args: any[]): { retur
  *
  * // Combined type string shorthand (return + args)
  * const className = callFunction("NSStringFromClass", { types: "@#" }, NSString);
+ *
+ * // Look the function up in one library's export table only
+ * const tmp = callFunction("NSTemporaryDirectory", {
+ *   returns: "@",
+ *   image: "/System/Library/Frameworks/Foundation.framework/Foundation"
+ * });
  * ```
  */
 function callFunction(name: string, ...rest: any[]): any {
@@ -733,7 +1114,7 @@ function callFunction(name: string, ...rest: any[]): any {
   for (let i = 0; i < args.length; i++) {
     args[i] = unwrapArg(args[i]);
   }
-  const result = CallFunction(name, returnType, argTypes, argTypes.length, ...args);
+  const result = CallFunction(functionTarget(name, options), returnType, argTypes, argTypes.length, ...args);
   return wrapObjCObjectIfNeeded(result);
 }
 
@@ -790,10 +1171,222 @@ function callVariadicFunction(name: string, ...rest: any[]): any {
   for (let i = 0; i < args.length; i++) {
     args[i] = unwrapArg(args[i]);
   }
-  const result = CallFunction(name, returnType, argTypes, fixedArgCount, ...args);
+  const result = CallFunction(functionTarget(name, options), returnType, argTypes, fixedArgCount, ...args);
   return wrapObjCObjectIfNeeded(result);
 }
 
+/**
+ * Run `fn` with borrowed (unretained) object wrappers.
+ *
+ * Every object wrapper created while `fn` runs - method results, block and
+ * callback arguments - holds its object without retaining it. When the
+ * scope exits, those wrappers are revoked: calling a method on one, or
+ * passing it as an argument, throws. Call `$retain()` on any object that
+ * needs to outlive the scope to turn it into an ordinary wrapper.
+ *
+ * This removes the retain/release pair from deep read-only traversals
+ * such as `view.superview().window().contentView()`. Borrowed objects must
+ * be kept alive by something else (usually the object they were read from)
+ * for the duration of the scope, so don't release or replace them inside it.
+ * `fn` must be synchronous. Scopes nest; a wrapper belongs to the innermost
+ * scope open when it was created.
+ *
+ * @param fn - The traversal to run
+ * @returns Whatever `fn` returns
+ *
+ * @example
+ * ```typescript
+ * const title = borrowScope(() => view.window().title().toString());
+ * const window = borrowScope(() => view.superview().window().$retain());
+ * ```
+ */
+function borrowScope<T>(fn: () => T): T {
+  BeginBorrowScope();
+  let result: T;
+  try {
+    result = fn();
+  } finally {
+    EndBorrowScope();
+  }
+  if (result instanceof Promise) {
+    throw new TypeError("borrowScope() callbacks must be synchronous");
+  }
+  return result;
+}
+
+// Matches the native chunk size (kLazyViewChunkSize) so iteration fetches
+// whole chunks.
+const LAZY_VIEW_CHUNK_SIZE = 64;
+const ARRAY_INDEX_PATTERN = /^(?:0|[1-9][0-9]*)$/;
+
+/**
+ * A read-only, array-like view over an NSArray. See {@link lazyView}.
+ */
+interface LazyArrayView<T = NobjcObject> extends Iterable<T> {
+  readonly length: number;
+  readonly [index: number]: T | undefined;
+  /** Element at `index`; negative indices count from the end. */
+  at(index: number): T | undefined;
+  /** Copy of elements [start, end) fetched in one native call per chunk. */
+  slice(start?: number, end?: number): T[];
+}
+
+/**
+ * A read-only, Map-like view over an NSDictionary. See {@link lazyView}.
+ */
+interface LazyDictionaryView<V = NobjcObject> {
+  readonly size: number;
+  /** `objectForKey:`; string keys are converted to NSString. */
+  get(key: string | NobjcObject): V | undefined;
+  has(key: string | NobjcObject): boolean;
+  /** A lazy array view over the keys (a snapshot of `allKeys`). */
+  keys(): LazyArrayView<NobjcObject>;
+}
+
+function createLazyArrayView(handle: unknown): LazyArrayView {
+  const read = (index: number) => wrapObjCObjectIfNeeded(LazyViewGet(handle, index)) as NobjcObject | undefined;
+  const clamp = (value: number, length: number) =>
+    value < 0 ? Math.max(length + value, 0) : Math.min(value, length);
+  const view = {
+    get length() {
+      return LazyViewCount(handle);
+    },
+    at(index: number) {
+      return read(index < 0 ? index + LazyViewCount(handle) : index);
+    },
+    slice(start = 0, end?: number) {
+      const length = LazyViewCount(handle);
+      const from = clamp(Math.trunc(start), length);
+      const to = end === undefined ? length : clamp(Math.trunc(end), length);
+      return LazyViewGetRange(handle, from, to).map((obj) => wrapObjCObjectIfNeeded(obj) as NobjcObject);
+    },
+    *[Symbol.iterator]() {
+      const length = LazyViewCount(handle);
+      for (let start = 0; start < length; start += LAZY_VIEW_CHUNK_SIZE) {
+        for (const obj of LazyViewGetRange(handle, start, start + LAZY_VIEW_CHUNK_SIZE)) {
+          yield wrapObjCObjectIfNeeded(obj) as NobjcObject;
+        }
+      }
+    }
+  };
+  return new Proxy(view, {
+    get(target, p, receiver) {
+      if (typeof p === "string" && ARRAY_INDEX_PATTERN.test(p)) {
+        return read(Number(p));
+      }
+      return Reflect.get(target, p, receiver);
+    },
+    has(target, p) {
+      if (typeof p === "string" && ARRAY_INDEX_PATTERN.test(p)) {
+        return Number(p) < LazyViewCount(handle);
+      }
+      return Reflect.has(target, p);
+    }
+  }) as unknown as LazyArrayView;
+}
+
+function createLazyDictionaryView(handle: unknown): LazyDictionaryView {
+  const read = (key: string | NobjcObject) =>
+    wrapObjCObjectIfNeeded(LazyViewGet(handle, unwrapArg(key))) as NobjcObject | undefined;
+  return {
+    get size() {
+      return LazyViewCount(handle);
+    },
+    get: read,
+    has(key: string | NobjcObject) {
+      return read(key) !== undefined;
+    },
+    keys() {
+      return createLazyArrayView(LazyViewKeys(handle).handle);
+    }
+  };
+}
+
+/**
+ * Create a lazy, read-only view over an NSArray or NSDictionary.
+ *
+ * Nothing is converted up front. An NSArray view reads elements on demand
+ * in aligned chunks of 64 (via `getObjects:range:`) and keeps the last few
+ * chunks cached natively, so sparse or sequential access into a
+ * million-element array costs a handful of native calls instead of a full
+ * conversion or one send per element. An NSDictionary view looks keys up
+ * with `objectForKey:` and exposes its keys as a lazy array view.
+ *
+ * The view retains the collection. If the collection is mutated after the
+ * view is created, every further read throws; create a new view instead.
+ *
+ * @param collection - An NSArray or NSDictionary
+ * @returns A {@link LazyArrayView} or {@link LazyDictionaryView}
+ *
+ * @example
+ * ```typescript
+ * const files = lazyView(fileManager.contentsOfDirectoryAtPath$error$(path, null)) as LazyArrayView;
+ * console.log(files.length, files[0]?.toString(), files.at(-1)?.toString());
+ * for (const file of files) { ... }
+ *
+ * const env = lazyView(NSProcessInfo.processInfo().environment()) as LazyDictionaryView;
+ * console.log(env.get("HOME")?.toString());
+ * ```
+ */
+function lazyView(collection: NobjcObject): LazyArrayView | LazyDictionaryView {
+  const nativeObj = nativeObjectMap.get(collection as unknown as object);
+  if (!nativeObj) {
+    throw new TypeError("lazyView() expects a NobjcObject");
+  }
+  const { handle, kind } = CreateLazyView(nativeObj);
+  return kind === "dictionary" ? createLazyDictionaryView(handle) : createLazyArrayView(handle);
+}
+
+/**
+ * Options for resolveSymbols.
+ */
+interface ResolveSymbolsOptions {
+  /**
+   * Path of an already-loaded library that exports the symbols. Lookups go
+   * through that image's export table (the Mach-O export trie) instead of a
+   * dlsym scan across every loaded image.
+   */
+  image?: string;
+}
+
+/**
+ * Resolve many C symbols in one native call.
+ *
+ * Without `image`, names are resolved the way callFunction resolves them
+ * (dlsym(RTLD_DEFAULT)) and the addresses are cached, so later
+ * callFunction / callVariadicFunction calls for those names skip symbol
+ * lookup entirely. With `image`, names are resolved against that
+ * framework's export table only. Those addresses are not cached for
+ * callFunction, since a global lookup of the same name may find another
+ * image's definition; pass one back as `{ address }` (or pass `{ image }`)
+ * to call that definition.
+ *
+ * @param names - C function or data symbol names (no leading underscore)
+ * @param options - Optional `image` to resolve against
+ * @returns An object mapping each name to its address, or null if not found
+ *
+ * @example
+ * ```typescript
+ * const CG = "/System/Library/Frameworks/CoreGraphics.framework/CoreGraphics";
+ * const exported = resolveSymbols(["CGMainDisplayID", "CGDisplayPixelsWide"], { image: CG });
+ * // exported.CGMainDisplayID is CoreGraphics' address (or null if not exported)
+ * const id = callFunction("CGMainDisplayID", { returns: "I", address: exported.CGMainDisplayID! });
+ *
+ * resolveSymbols(["CGMainDisplayID", "CGDisplayPixelsWide"]); // warms the callFunction cache
+ * const display = callFunction("CGMainDisplayID", { returns: "I" }); // no lookup
+ * ```
+ */
+function resolveSymbols(names: string[], options: ResolveSymbolsOptions = {}): Record<string, bigint | null> {
+  if (!Array.isArray(names)) {
+    throw new TypeError("resolveSymbols expects an array of symbol names");
+  }
+  if (options.image !== undefined) {
+    // The export index only covers loaded images.
+    LoadLibrary(options.image);
+  }
+  return ResolveSymbols(names, options.image);
+}
+
 /**
  * Utilities for pumping the macOS CFRunLoop from a Node.js/Bun event loop.
  *
@@ -897,16 +1490,776 @@ const RunLoop = {
   }
 };
 
+/**
+ * Hit/miss counters for the NSString intern cache.
+ */
+interface StringInternStats {
+  /** Maximum number of interned strings (0 when disabled) */
+  capacity: number;
+  /** Number of strings currently interned */
+  size: number;
+  /** Lookups served from the cache */
+  hits: number;
+  /** Lookups that created and interned a new NSString */
+  misses: number;
+  /** Strings evicted to make room */
+  evictions: number;
+  /** Strings too long to intern (converted without caching) */
+  bypassed: number;
+  /** hits / (hits + misses), or 0 before the first lookup */
+  hitRate: number;
+}
+
+/**
+ * Opt-in cache of immutable NSStrings for JS strings passed to object (`@`)
+ * parameters.
+ *
+ * JS strings passed where an object is expected are converted to NSStrings.
+ * With interning enabled, short strings are looked up by content first, so
+ * repeated dictionary keys, attribute names and notification names reuse a
+ * single NSString instead of allocating one per call. The cache is bounded
+ * and evicts with the clock (second-chance) algorithm.
+ *
+ * @example
+ * ```typescript
+ * StringIntern.enable(4096);
+ * for (const row of rows) {
+ *   dict.setObject$forKey$(row.value, "identifier"); // one NSString for "identifier"
+ * }
+ * console.log(StringIntern.stats().hitRate);
+ * ```
+ */
+const StringIntern = {
+  /**
+   * Enable (or resize) the cache. Resizing empties it.
+   *
+   * @param capacity Maximum number of interned strings (default: 1024)
+   */
+  enable(capacity: number = 1024): void {
+    ConfigureStringIntern(capacity);
+  },
+
+  /**
+   * Disable the cache and release every interned string.
+   */
+  disable(): void {
+    ConfigureStringIntern(0);
+  },
+
+  /**
+   * Get cache counters.
+   */
+  stats(): StringInternStats {
+    const stats = GetStringInternStats();
+    const lookups = stats.hits + stats.misses;
+    return { ...stats, hitRate: lookups === 0 ? 0 : stats.hits / lookups };
+  }
+};
+
+/** Options for `Profiler.start()`. */
+interface ProfilerOptions {
+  /** Samples per second (1-10000, default: 1000) */
+  hz?: number;
+}
+
+/** One distinct native call stack and how often it was sampled. */
+interface ProfileStack {
+  /** Outermost call first: `-[Class selector]`, `+[Class selector]` or `function()` */
+  frames: string[];
+  count: number;
+}
+
+/** Result of `Profiler.stop()`. */
+interface CallProfile {
+  durationMs: number;
+  hz: number;
+  /** Sampler wakeups */
+  ticks: number;
+  /** Thread stacks captured (a tick samples every thread inside a native call) */
+  samples: number;
+  stacks: ProfileStack[];
+}
+
+/**
+ * Opt-in sampling profiler for time spent inside native calls.
+ *
+ * V8 CPU profiles show one opaque frame for every Objective-C send. While
+ * the profiler runs, sends, bound invocations, C function calls and
+ * `parallelSendMap` workers publish the class and selector (or function)
+ * they are in, and a background thread samples every thread at `hz`.
+ * Nested calls (a callback that sends again) appear as deeper frames.
+ *
+ * @example
+ * ```typescript
+ * Profiler.start({ hz: 2000 });
+ * runWorkload();
+ * const profile = Profiler.stop();
+ * fs.writeFileSync("native.folded", Profiler.toFolded(profile)); // flamegraph.pl / speedscope
+ * ```
+ */
+const Profiler = {
+  /**
+   * Start sampling. Throws if a profile is already being recorded.
+   */
+  start(options: ProfilerOptions = {}): void {
+    StartCallProfiler(options.hz ?? 1000);
+  },
+
+  /**
+   * Stop sampling and return the recorded stacks.
+   */
+  stop(): CallProfile {
+    return StopCallProfiler();
+  },
+
+  /**
+   * Render a profile in the folded-stack format (`frame;frame count` per
+   * line) read by flamegraph.pl, speedscope and similar tools.
+   */
+  toFolded(profile: CallProfile): string {
+    return profile.stacks.map((stack) => `${stack.frames.join(";")} ${stack.count}`).join("\n");
+  }
+};
+
+/**
+ * Opt-in recording of the bridge's call mix.
+ *
+ * While a trace runs, every send, bound invocation, C function call,
+ * `parallelSendMap` send and JS callback (same-thread or cross-thread) is
+ * logged with its class and selector, argument and return kinds and sizes,
+ * time offset and thread. Argument values are never recorded. Each call
+ * costs 10 bytes once its shape has been seen.
+ *
+ * Replay a saved trace with `bun run benchmarks/replay.ts trace.bin`.
+ *
+ * @example
+ * ```typescript
+ * Trace.start();
+ * runWorkload();
+ * fs.writeFileSync("calls.nobjctrace", Trace.stop());
+ * ```
+ */
+const Trace = {
+  /**
+   * Start recording. Throws if a trace is already being recorded.
+   */
+  start(): void {
+    StartCallTrace();
+  },
+
+  /**
+   * Stop recording and return the binary trace.
+   */
+  stop(): Buffer {
+    return StopCallTrace();
+  },
+
+  /**
+   * Decode a trace returned by `stop()`.
+   */
+  parse(data: Uint8Array): CallTrace {
+    return parseTrace(data);
+  },
+
+  /**
+   * Count calls per shape, most frequent first.
+   */
+  summarize(trace: CallTrace): Array<{ shape: TraceShape; count: number }> {
+    return summarizeTrace(trace);
+  }
+};
+
+/** Counters for one callback delivery lane. */
+interface CallbackLaneStats {
+  /** Callbacks queued from other threads */
+  posted: number;
+  /** Callbacks run on the JS thread */
+  delivered: number;
+  /** Callbacks currently queued */
+  pending: number;
+  /** Largest queue length seen */
+  maxPending: number;
+}
+
+/** Counters for cross-thread callback delivery. */
+interface CallbackDispatcherStats {
+  /** Drain passes run on the JS thread */
+  drains: number;
+  /** Drains that hit the time budget and yielded to the event loop */
+  yields: number;
+  /** Blocking callbacks run while the JS thread was inside a native call */
+  nested: number;
+  lanes: Record<CallbackPriority, CallbackLaneStats>;
+  /** Native threads that waited for a callback's result */
+  waits: CallbackWaitStats;
+}
+
+/** How long native threads waited for synchronous callbacks. */
+interface CallbackWaitStats {
+  /** Completed or abandoned waits */
+  count: number;
+  /** Waits that hit their timeout and returned a default value */
+  timeouts: number;
+  /** Wait counts by duration; the last bucket's `upToMs` is Infinity */
+  histogram: Array<{ upToMs: number; count: number }>;
+}
+
+/**
+ * Get counters for callbacks delivered to the JS thread from other threads
+ * (protocol and subclass methods, blocks, `observe()` and `subscribe()`).
+ *
+ * A growing `pending` count on the "blocking" lane means native threads are
+ * waiting on a busy JS thread.
+ */
+function getCallbackDispatcherStats(): CallbackDispatcherStats {
+  return GetCallbackDispatcherStats() as CallbackDispatcherStats;
+}
+
+/**
+ * Buffers batches pushed from native code and exposes them either to a
+ * callback or as an async iterator. Shared by the native observation APIs.
+ */
+class BatchStream<T> implements AsyncIterableIterator<T[]> {
+  private queue: T[][] = [];
+  private waiters: Array<(result: IteratorResult<T[]>) => void> = [];
+  private stopped = false;
+
+  constructor(
+    private readonly onStop: () => void,
+    private readonly callback?: (batch: T[]) => void
+  ) {}
+
+  /** @internal Called with each batch delivered by native code. */
+  push(batch: T[]): void {
+    if (this.stopped) return;
+    if (this.callback) {
+      this.callback(batch);
+      return;
+    }
+    const waiter = this.waiters.shift();
+    if (waiter) {
+      waiter({ value: batch, done: false });
+    } else {
+      this.queue.push(batch);
+    }
+  }
+
+  /** Stop delivery and release the native observer. Safe to call more than once. */
+  stop(): void {
+    if (this.stopped) return;
+    this.stopped = true;
+    this.onStop();
+    for (const waiter of this.waiters.splice(0)) {
+      waiter({ value: undefined, done: true });
+    }
+  }
+
+  next(): Promise<IteratorResult<T[]>> {
+    const batch = this.queue.shift();
+    if (batch) return Promise.resolve({ value: batch, done: false });
+    if (this.stopped) return Promise.resolve({ value: undefined, done: true });
+    return new Promise((resolve) => this.waiters.push(resolve));
+  }
+
+  return(): Promise<IteratorResult<T[]>> {
+    this.stop();
+    return Promise.resolve({ value: undefined, done: true });
+  }
+
+  [Symbol.asyncIterator](): AsyncIterableIterator<T[]> {
+    return this;
+  }
+}
+
+/** Values that can be requested from a key-value observation. */
+type ObserveValueOption = "new" | "old" | "initial" | "prior";
+
+const KVO_OPTION_BITS: Record<ObserveValueOption, number> = {
+  new: 0x01,
+  old: 0x02,
+  initial: 0x04,
+  prior: 0x08
+};
+
+interface ObserveOptions {
+  /**
+   * Merge bursts of changes that arrive within this many milliseconds into a
+   * single record (keeping the first old value and the latest new value).
+   * Defaults to 0, which delivers every change.
+   */
+  coalesceMs?: number;
+  /** Which values to include in each change. Defaults to ["new", "old"]. */
+  options?: ObserveValueOption[];
+  /** Delivery lane for batches. Defaults to "interactive". See `withPriority()`. */
+  priority?: CallbackPriority;
+}
+
+/** A key-value change delivered by `observe()`. */
+interface KeyValueChange {
+  /** The observed key path */
+  keyPath: string;
+  /** NSKeyValueChange kind (1 = setting, 2 = insertion, 3 = removal, 4 = replacement) */
+  kind: number;
+  /** New value (strings, numbers and booleans are converted; other objects are wrapped) */
+  newValue?: unknown;
+  /** Old value, converted the same way as newValue */
+  oldValue?: unknown;
+  /** NSIndexSet of affected indexes for collection mutations */
+  indexes?: NobjcObject;
+  /** True for the notification sent before the change ("prior" option) */
+  isPrior: boolean;
+  /** Number of changes merged into this record by coalescing */
+  count: number;
+}
+
+type KeyValueObservation = BatchStream<KeyValueChange>;
+
+/**
+ * Observe a key path using a native KVO observer.
+ *
+ * The change dictionary is unpacked natively, so each change costs no extra
+ * sends from JS, and changes are delivered in batches rather than one
+ * blocking callback per change. Pass a callback to receive batches as they
+ * arrive, or iterate the returned object with `for await`.
+ *
+ * The observed object is kept alive until `stop()` is called.
+ *
+ * @example
+ * ```typescript
+ * const observation = observe(model, "title", { coalesceMs: 16 }, (changes) => {
+ *   for (const change of changes) console.log(change.oldValue, "->", change.newValue);
+ * });
+ * // later
+ * observation.stop();
+ *
+ * // Or as an async iterator
+ * for await (const changes of observe(model, "title")) {
+ *   // ...
+ * }
+ * ```
+ */
+function observe(
+  object: NobjcObject,
+  keyPath: string,
+  optionsOrCallback?: ObserveOptions | ((changes: KeyValueChange[]) => void),
+  callback?: (changes: KeyValueChange[]) => void
+): KeyValueObservation {
+  const options = typeof optionsOrCallback === "function" ? {} : (optionsOrCallback ?? {});
+  const onBatch = typeof optionsOrCallback === "function" ? optionsOrCallback : callback;
+
+  const nativeObj = nativeObjectMap.get(object as unknown as object);
+  if (!nativeObj) {
+    throw new TypeError("observe() expects a NobjcObject");
+  }
+
+  let bits = 0;
+  for (const option of options.options ?? ["new", "old"]) {
+    const bit = KVO_OPTION_BITS[option];
+    if (bit === undefined) {
+      throw new TypeError(`Unknown observe option: ${option}`);
+    }
+    bits |= bit;
+  }
+
+  let handle: unknown;
+  const stream = new BatchStream<KeyValueChange>(() => StopObserving(handle), onBatch);
+  const deliver = (changes: unknown[]) => {
+    const batch = changes as unknown as KeyValueChange[];
+    for (let i = 0; i < batch.length; i++) {
+      const change = batch[i];
+      change.keyPath = keyPath;
+      if ("newValue" in change) change.newValue = wrapObjCObjectIfNeeded(change.newValue);
+      if ("oldValue" in change) change.oldValue = wrapObjCObjectIfNeeded(change.oldValue);
+      if (change.indexes) change.indexes = wrapObjCObjectIfNeeded(change.indexes) as NobjcObject;
+    }
+    stream.push(batch);
+  };
+  if (options.priority !== undefined) withPriority(options.priority, deliver);
+  handle = ObserveKeyPath(nativeObj, keyPath, bits, options.coalesceMs ?? 0, deliver);
+  return stream;
+}
+
+interface SubscribeOptions {
+  /** userInfo keys to extract natively. Other keys are not read. Defaults to none. */
+  keys?: string[];
+  /**
+   * Collect notifications for this many milliseconds before delivering them as
+   * one batch. Defaults to 0 (deliver as soon as the JS thread is free).
+   */
+  batchMs?: number;
+  /** Notification center to observe (e.g. NSWorkspace's). Defaults to the default center. */
+  center?: NobjcObject;
+  /** Delivery lane for batches. Defaults to "interactive". See `withPriority()`. */
+  priority?: CallbackPriority;
+}
+
+/** A notification delivered by `subscribe()`. */
+interface NotificationRecord {
+  /** The notification name */
+  name: string;
+  /** The posting object, if any */
+  object: NobjcObject | null;
+  /** The requested userInfo keys that were present, converted like observe() values */
+  userInfo: Record<string, unknown>;
+}
+
+type NotificationSubscription = BatchStream<NotificationRecord>;
+
+/**
+ * Subscribe to notifications with a native block observer.
+ *
+ * The observer runs on the posting thread but only copies out the requested
+ * `userInfo` keys and queues a compact record, so posters are never blocked on
+ * JavaScript. Records are delivered in batches to the callback, or through the
+ * async iterator when no callback is given.
+ *
+ * @param name - Notification name, or null for every notification
+ * @param object - Only deliver notifications posted by this object (null for any sender)
+ *
+ * @example
+ * ```typescript
+ * const subscription = subscribe("NSTextStorageDidProcessEditingNotification", textStorage, { batchMs: 50 }, (records) => {
+ *   console.log(`${records.length} edits`);
+ * });
+ * // later
+ * subscription.stop();
+ * ```
+ */
+function subscribe(
+  name: string | null,
+  object: NobjcObject | null,
+  optionsOrCallback?: SubscribeOptions | ((records: NotificationRecord[]) => void),
+  callback?: (records: NotificationRecord[]) => void
+): NotificationSubscription {
+  const options = typeof optionsOrCallback === "function" ? {} : (optionsOrCallback ?? {});
+  const onBatch = typeof optionsOrCallback === "function" ? optionsOrCallback : callback;
+
+  let handle: unknown;
+  const stream = new BatchStream<NotificationRecord>(() => Unsubscribe(handle), onBatch);
+  const deliver = (records: unknown[]) => {
+    const batch = records as unknown as NotificationRecord[];
+    for (let i = 0; i < batch.length; i++) {
+      const record = batch[i];
+      if (record.object) record.object = wrapObjCObjectIfNeeded(record.object) as NobjcObject;
+      const userInfo = record.userInfo;
+      for (const key in userInfo) {
+        userInfo[key] = wrapObjCObjectIfNeeded(userInfo[key]);
+      }
+    }
+    stream.push(batch);
+  };
+  if (options.priority !== undefined) withPriority(options.priority, deliver);
+  handle = SubscribeNotification(
+    name,
+    object ? unwrapArg(object) : null,
+    options.keys ?? [],
+    options.batchMs ?? 0,
+    options.center ? unwrapArg(options.center) : null,
+    deliver
+  );
+  return stream;
+}
+
+interface InputStreamOptions {
+  /** Maximum bytes per chunk. Defaults to 64 KiB. */
+  chunkSize?: number;
+  /** Readable highWaterMark, in bytes. */
+  highWaterMark?: number;
+}
+
+/**
+ * Adapt an NSInputStream to a Node.js Readable.
+ *
+ * Reads happen on a dedicated native thread into pooled buffers that are
+ * handed to the Readable without copying. A chunk is only read when the
+ * Readable asks for one, so Node back-pressure propagates to the stream.
+ * The stream is opened if needed and closed when the Readable ends or is
+ * destroyed.
+ *
+ * @example
+ * ```typescript
+ * const input = NSInputStream.inputStreamWithFileAtPath$(path);
+ * for await (const chunk of readableFromInputStream(input)) {
+ *   hash.update(chunk);
+ * }
+ * ```
+ */
+function readableFromInputStream(stream: NobjcObject, options: InputStreamOptions = {}): Readable {
+  const nativeStream = nativeObjectMap.get(stream as unknown as object);
+  if (!nativeStream) {
+    throw new TypeError("readableFromInputStream() expects a NobjcObject");
+  }
+
+  let handle: unknown;
+  const readable = new (loadStreamModule().Readable)({
+    highWaterMark: options.highWaterMark,
+    read() {
+      InputStreamRead(handle);
+    },
+    destroy(error, callback) {
+      InputStreamClose(handle);
+      callback(error);
+    }
+  });
+  handle = InputStreamOpen(nativeStream, options.chunkSize, (chunk, error) => {
+    if (error !== undefined) {
+      readable.destroy(new Error(error));
+    } else {
+      readable.push(chunk);
+    }
+  });
+  return readable;
+}
+
+/**
+ * Adapt an NSOutputStream to a Node.js Writable.
+ *
+ * Chunks are written by a dedicated native thread straight from the
+ * Buffers passed to `write()`; the write callback fires once all bytes have
+ * been accepted by the stream, so the Writable's highWaterMark provides
+ * back-pressure. The stream is opened if needed and closed by `end()`.
+ *
+ * @example
+ * ```typescript
+ * const output = NSOutputStream.outputStreamToFileAtPath$append$(path, false);
+ * await pipeline(source, writableFromOutputStream(output));
+ * ```
+ */
+function writableFromOutputStream(stream: NobjcObject, options: { highWaterMark?: number } = {}): Writable {
+  const nativeStream = nativeObjectMap.get(stream as unknown as object);
+  if (!nativeStream) {
+    throw new TypeError("writableFromOutputStream() expects a NobjcObject");
+  }
+
+  let nextRequestId = 1;
+  const pending = new Map<number, (error?: Error | null) => void>();
+  const handle = OutputStreamOpen(nativeStream, (requestId, error) => {
+    const callback = pending.get(requestId);
+    pending.delete(requestId);
+    callback?.(error === null ? null : new Error(error));
+  });
+  const submit = (buffers: Buffer[] | null, callback: (error?: Error | null) => void) => {
+    const requestId = nextRequestId++;
+    pending.set(requestId, callback);
+    if (buffers) {
+      OutputStreamWrite(handle, buffers, requestId);
+    } else {
+      OutputStreamClose(handle, requestId);
+    }
+  };
+
+  return new (loadStreamModule().Writable)({
+    highWaterMark: options.highWaterMark,
+    write(chunk: Buffer, _encoding, callback) {
+      submit([chunk], callback);
+    },
+    writev(chunks, callback) {
+      submit(
+        chunks.map((entry) => entry.chunk as Buffer),
+        callback
+      );
+    },
+    final(callback) {
+      submit(null, callback);
+    },
+    destroy(error, callback) {
+      OutputStreamClose(handle, 0);
+      callback(error);
+    }
+  });
+}
+
+/**
+ * Options for {@link parallelSendMap}.
+ */
+interface ParallelSendMapOptions<Out extends ArrayBufferView = Float64Array> {
+  /**
+   * Must be `true`. The method runs concurrently on several threads, so the
+   * caller has to vouch that it is safe to call on these receivers from any
+   * thread at the same time.
+   */
+  threadSafe: true;
+  /** Maximum number of worker threads. Defaults to the number of active CPUs. */
+  threads?: number;
+  /**
+   * Destination for numeric and BOOL results, at least `receivers.length`
+   * elements long. Defaults to a new Float64Array. Floating-point results
+   * require a Float32Array or Float64Array.
+   */
+  out?: Out;
+}
+
+/**
+ * Send a zero-argument method to many receivers in parallel.
+ *
+ * The receivers are split into chunks that worker threads claim until none
+ * are left (via `dispatch_apply`), each chunk running inside its own
+ * autorelease pool. The call blocks until every worker has finished, so it
+ * suits CPU-bound, embarrassingly parallel work such as hashing or
+ * normalizing many objects.
+ *
+ * Numeric and BOOL results are written into a TypedArray. Object results are
+ * retained on the worker and returned as an array of NobjcObjects (or null)
+ * after the join. Void methods return undefined. `null` receivers behave like
+ * messaging nil.
+ *
+ * If a receiver raises an Objective-C exception, the remaining chunks are
+ * skipped and an Error naming the receiver index is thrown.
+ *
+ * @param methodName - The method name in `$` notation (e.g. `"hash"`, `"lowercaseString"`)
+ * @param receivers - The objects to send the message to (at least one non-null)
+ * @param options - Must include `threadSafe: true`
+ *
+ * @example
+ * ```typescript
+ * const hashes = parallelSendMap("hash", blobs, { threadSafe: true, out: new BigUint64Array(blobs.length) });
+ * const lowered = parallelSendMap("lowercaseString", strings, { threadSafe: true, threads: 4 });
+ * ```
+ */
+function parallelSendMap<Out extends ArrayBufferView = Float64Array>(
+  methodName: string,
+  receivers: readonly (NobjcObject | null)[],
+  options: ParallelSendMapOptions<Out>
+): Out | (NobjcObject | null)[] | undefined {
+  if (options?.threadSafe !== true) {
+    throw new TypeError("parallelSendMap() requires { threadSafe: true }");
+  }
+  const nativeReceivers = receivers.map((receiver) => {
+    if (receiver === null || receiver === undefined) {
+      return null;
+    }
+    const nativeObj = nativeObjectMap.get(receiver as unknown as object);
+    if (!nativeObj) {
+      throw new TypeError("parallelSendMap() receivers must be NobjcObjects");
+    }
+    return nativeObj;
+  });
+  const first = nativeReceivers.find((receiver) => receiver !== null);
+  if (!first) {
+    throw new TypeError("parallelSendMap() needs at least one non-null receiver");
+  }
+
+  const handle = first.$prepareSend(NobjcMethodNameToObjcSelector(methodName));
+  const result = ParallelSendMap(handle, nativeReceivers, options.out ?? null, options.threads ?? 0);
+  if (Array.isArray(result)) {
+    return result.map((obj) => (obj === null ? null : new NobjcObject(obj)));
+  }
+  return result as Out | undefined;
+}
+
+/**
+ * A method call with some arguments fixed in advance. See {@link bind}.
+ */
+interface BoundMethod {
+  /** Call the method, passing one value per variable slot in argument order. */
+  invoke(...args: any[]): any;
+  /** The number of variable slots `invoke` expects. */
+  readonly variableCount: number;
+}
+
+/**
+ * Bind a method to a receiver with some arguments fixed.
+ *
+ * The fixed arguments are converted to native values once and stored in a
+ * reusable native invocation; each `invoke` converts only the variable
+ * arguments before sending. This helps tight loops that call the same
+ * method on the same receiver with only one or two arguments changing.
+ *
+ * Mark variable slots with `undefined` (or leave holes). Pass `null` for a
+ * fixed nil argument. Fixed objects, strings and blocks are retained by the
+ * binding; fixed Buffers for pointer arguments are kept alive with it.
+ *
+ * @param receiver - The object to send the message to
+ * @param methodName - The method name in `$` notation
+ * @param partialArgs - One entry per method argument; `undefined` = variable
+ *
+ * @example
+ * ```typescript
+ * const replace = bind(text, "replaceCharactersInRange$withString$", [undefined, separator]);
+ * for (const range of ranges) replace.invoke(range);
+ * ```
+ */
+function bind(receiver: NobjcObject, methodName: string, partialArgs: readonly unknown[] = []): BoundMethod {
+  const nativeReceiver = nativeObjectMap.get(receiver as unknown as object);
+  if (!nativeReceiver) {
+    throw new TypeError("bind() receiver must be a NobjcObject");
+  }
+  const handle = nativeReceiver.$prepareSend(NobjcMethodNameToObjcSelector(methodName));
+  // Array.from turns holes into undefined.
+  const args = Array.from(partialArgs, (arg) => (arg === undefined ? undefined : unwrapArg(arg)));
+  const bound = BindInvocation(nativeReceiver, handle, args);
+  const variableCount = args.filter((arg) => arg === undefined).length;
+  return {
+    variableCount,
+    invoke(...changed: any[]) {
+      for (let i = 0; i < changed.length; i++) {
+        changed[i] = unwrapArg(changed[i]);
+      }
+      return wrapObjCObjectIfNeeded(InvokeBound(bound, ...changed));
+    }
+  };
+}
+
 export {
   NobjcLibrary,
+  loadLibraryAsync,
   NobjcObject,
+  NobjcWeakRef,
   NobjcMethod,
   NobjcProtocol,
   NobjcClass,
   typedBlock,
+  withPriority,
+  withTimeout,
+  setCallbackTimeout,
+  getCallbackDispatcherStats,
   RunLoop,
+  StringIntern,
+  Profiler,
+  Trace,
   getPointer,
   fromPointer,
+  toArrayBuffer,
   callFunction,
-  callVariadicFunction
+  callVariadicFunction,
+  resolveSymbols,
+  borrowScope,
+  lazyView,
+  observe,
+  subscribe,
+  readableFromInputStream,
+  writableFromOutputStream,
+  parallelSendMap,
+  bind
+};
+
+export type {
+  NobjcLibraryOptions,
+  LibraryLoadResult,
+  ResolveSymbolsOptions,
+  ObserveOptions,
+  KeyValueChange,
+  KeyValueObservation,
+  SubscribeOptions,
+  NotificationRecord,
+  NotificationSubscription,
+  InputStreamOptions,
+  ParallelSendMapOptions,
+  BoundMethod,
+  LazyArrayView,
+  LazyDictionaryView,
+  StringInternStats,
+  CallbackPriority,
+  CallbackLaneStats,
+  CallbackDispatcherStats,
+  CallbackWaitStats,
+  CallbackDefaultReturn,
+  ProfilerOptions,
+  ProfileStack,
+  CallProfile,
+  CallTrace,
+  TraceCallKind,
+  TraceRecord,
+  TraceShape,
+  TraceValueShape
 };
@@ -9,26 +9,94 @@ const binding: typeof _binding = require("node-gyp-build")(join(__dirname, "..")
 
 const {
   LoadLibrary,
+  LoadLibraryAsync,
   GetClassObject,
   ObjcObject,
   GetPointer,
   FromPointer,
+  BeginBorrowScope,
+  EndBorrowScope,
+  CreateWeakReference,
+  LoadWeakReference,
+  LoadWeakReferences,
+  ToArrayBuffer,
   CreateProtocolImplementation,
   DefineClass,
   CallSuper,
   CallFunction,
-  PumpRunLoop
+  ResolveSymbols,
+  PumpRunLoop,
+  ObserveKeyPath,
+  StopObserving,
+  SubscribeNotification,
+  Unsubscribe,
+  InputStreamOpen,
+  InputStreamRead,
+  InputStreamClose,
+  OutputStreamOpen,
+  OutputStreamWrite,
+  OutputStreamClose,
+  ParallelSendMap,
+  BindInvocation,
+  InvokeBound,
+  CreateLazyView,
+  LazyViewCount,
+  LazyViewGet,
+  LazyViewGetRange,
+  LazyViewKeys,
+  ConfigureStringIntern,
+  GetStringInternStats,
+  GetCallbackDispatcherStats,
+  ConfigureCallbackTimeout,
+  StartCallProfiler,
+  StopCallProfiler,
+  StartCallTrace,
+  StopCallTrace
 } = binding;
 export {
   LoadLibrary,
+  LoadLibraryAsync,
   GetClassObject,
   ObjcObject,
   GetPointer,
   FromPointer,
+  BeginBorrowScope,
+  EndBorrowScope,
+  CreateWeakReference,
+  LoadWeakReference,
+  LoadWeakReferences,
+  ToArrayBuffer,
   CreateProtocolImplementation,
   DefineClass,
   CallSuper,
   CallFunction,
-  PumpRunLoop
+  ResolveSymbols,
+  PumpRunLoop,
+  ObserveKeyPath,
+  StopObserving,
+  SubscribeNotification,
+  Unsubscribe,
+  InputStreamOpen,
+  InputStreamRead,
+  InputStreamClose,
+  OutputStreamOpen,
+  OutputStreamWrite,
+  OutputStreamClose,
+  ParallelSendMap,
+  BindInvocation,
+  InvokeBound,
+  CreateLazyView,
+  LazyViewCount,
+  LazyViewGet,
+  LazyViewGetRange,
+  LazyViewKeys,
+  ConfigureStringIntern,
+  GetStringInternStats,
+  GetCallbackDispatcherStats,
+  ConfigureCallbackTimeout,
+  StartCallProfiler,
+  StopCallProfiler,
+  StartCallTrace,
+  StopCallTrace
 };
 export type { _binding as NobjcNative };
@@ -0,0 +1,130 @@
+/**
+ * Decoder for call traces recorded with `Trace.stop()`.
+ *
+ * This module does not load the native addon, so tools such as
+ * benchmarks/replay.ts can read traces on machines without Objective-C.
+ * The layout is documented in src/native/call-trace.h.
+ */
+
+/** What kind of bridge activity a shape describes. */
+type TraceCallKind = "send" | "function" | "callback" | "crossThreadCallback";
+
+const TRACE_CALL_KINDS: readonly TraceCallKind[] = ["send", "function", "callback", "crossThreadCallback"];
+
+const TRACE_MAGIC = "NOBJTRC\0";
+const TRACE_VERSION = 1;
+
+/** One argument or return value: simplified type-encoding character and byte size. */
+interface TraceValueShape {
+  kind: string;
+  size: number;
+}
+
+/** A distinct call site; stored once per trace. */
+interface TraceShape {
+  kind: TraceCallKind;
+  /** Class name, "function" or "block" */
+  owner: string;
+  /** Selector, function name or block signature */
+  name: string;
+  returns: TraceValueShape;
+  args: TraceValueShape[];
+}
+
+/** One recorded call. */
+interface TraceRecord {
+  /** Index into `CallTrace.shapes` */
+  shape: number;
+  /** Microseconds since the trace started */
+  timeUs: number;
+  /** Thread ordinal; 0 is the thread that started the trace */
+  thread: number;
+}
+
+/** A decoded call trace. */
+interface CallTrace {
+  durationUs: number;
+  threadCount: number;
+  /** Calls not recorded because the trace was full */
+  droppedRecords: number;
+  shapes: TraceShape[];
+  records: TraceRecord[];
+}
+
+/**
+ * Decode a trace produced by `Trace.stop()`.
+ *
+ * @throws If the buffer is not a trace or is truncated.
+ */
+function parseTrace(data: Uint8Array): CallTrace {
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  const decoder = new TextDecoder();
+  let offset = 0;
+  const need = (bytes: number) => {
+    if (offset + bytes > data.byteLength) {
+      throw new RangeError(`Truncated call trace at byte ${offset}`);
+    }
+  };
+  const u8 = () => (need(1), view.getUint8(offset++));
+  const u16 = () => (need(2), (offset += 2), view.getUint16(offset - 2, true));
+  const u32 = () => (need(4), (offset += 4), view.getUint32(offset - 4, true));
+  const str = () => {
+    const length = u16();
+    need(length);
+    offset += length;
+    return decoder.decode(data.subarray(offset - length, offset));
+  };
+  const char = () => String.fromCharCode(u8());
+
+  need(TRACE_MAGIC.length);
+  if (decoder.decode(data.subarray(0, TRACE_MAGIC.length)) !== TRACE_MAGIC) {
+    throw new TypeError("Not a call trace");
+  }
+  offset = TRACE_MAGIC.length;
+  const version = u16();
+  if (version !== TRACE_VERSION) {
+    throw new TypeError(`Unsupported call trace version ${version}`);
+  }
+  const threadCount = u16();
+  const durationUs = u32();
+  const droppedRecords = u32();
+  const shapeCount = u32();
+  const recordCount = u32();
+
+  const shapes: TraceShape[] = [];
+  for (let i = 0; i < shapeCount; i++) {
+    const kind = TRACE_CALL_KINDS[u8()] ?? "send";
+    const returnKind = char();
+    const argCount = u16();
+    const returns = { kind: returnKind, size: u32() };
+    const owner = str();
+    const name = str();
+    const args: TraceValueShape[] = [];
+    for (let j = 0; j < argCount; j++) {
+      args.push({ kind: char(), size: u32() });
+    }
+    shapes.push({ kind, owner, name, returns, args });
+  }
+
+  need(recordCount * 10);
+  const records: TraceRecord[] = new Array(recordCount);
+  for (let i = 0; i < recordCount; i++) {
+    records[i] = { shape: u32(), timeUs: u32(), thread: u16() };
+  }
+
+  return { durationUs, threadCount, droppedRecords, shapes, records };
+}
+
+/**
+ * Count calls per shape, most frequent first.
+ */
+function summarizeTrace(trace: CallTrace): Array<{ shape: TraceShape; count: number }> {
+  const counts = new Array<number>(trace.shapes.length).fill(0);
+  for (const record of trace.records) {
+    counts[record.shape]++;
+  }
+  return trace.shapes.map((shape, i) => ({ shape, count: counts[i] })).sort((a, b) => b.count - a.count);
+}
+
+export { parseTrace, summarizeTrace };
+export type { CallTrace, TraceCallKind, TraceRecord, TraceShape, TraceValueShape };
@@ -0,0 +1,92 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, toArrayBuffer } from "../dist/index.js";
+import { mkdtempSync, writeFileSync, rmSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSData = foundation["NSData"] as any;
+const NSMutableData = foundation["NSMutableData"] as any;
+
+const NSUTF8StringEncoding = 4;
+const NSDataReadingMappedIfSafe = 1;
+
+describe("toArrayBuffer()", () => {
+  test("should expose NSData bytes", () => {
+    const data = NSString.stringWithUTF8String$("Hello, bytes!").dataUsingEncoding$(NSUTF8StringEncoding);
+    const buffer = toArrayBuffer(data);
+    expect(buffer).toBeInstanceOf(ArrayBuffer);
+    expect(buffer.byteLength).toBe(13);
+    expect(Buffer.from(buffer).toString("utf8")).toBe("Hello, bytes!");
+  });
+
+  test("should return an empty ArrayBuffer for empty data", () => {
+    const buffer = toArrayBuffer(NSData.data());
+    expect(buffer.byteLength).toBe(0);
+  });
+
+  test("should read memory-mapped files", () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const file = join(dir, "asset.bin");
+    const contents = Buffer.alloc(1 << 20);
+    for (let i = 0; i < contents.length; i++) contents[i] = i & 0xff;
+    writeFileSync(file, contents);
+    try {
+      const data = NSData.dataWithContentsOfFile$options$error$(
+        NSString.stringWithUTF8String$(file),
+        NSDataReadingMappedIfSafe,
+        null
+      );
+      const bytes = new Uint8Array(toArrayBuffer(data));
+      expect(bytes.length).toBe(contents.length);
+      expect(Buffer.compare(Buffer.from(bytes), contents)).toBe(0);
+    } finally {
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test("should return a writable copy of a memory-mapped file", () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const file = join(dir, "asset.bin");
+    writeFileSync(file, Buffer.alloc(1 << 16, 7));
+    try {
+      const data = NSData.dataWithContentsOfFile$options$error$(
+        NSString.stringWithUTF8String$(file),
+        NSDataReadingMappedIfSafe,
+        null
+      );
+      const copy = new Uint8Array(toArrayBuffer(data, { copy: true }));
+      expect(copy.length).toBe(1 << 16);
+      copy[0] = 1; // Would fault on the mapped pages without copy
+      expect(copy[0]).toBe(1);
+      expect(new Uint8Array(toArrayBuffer(data))[0]).toBe(7);
+      expect(toArrayBuffer(NSData.data(), { copy: true }).byteLength).toBe(0);
+    } finally {
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test("should snapshot NSMutableData", () => {
+    const data = NSMutableData.dataWithData$(
+      NSString.stringWithUTF8String$("abc").dataUsingEncoding$(NSUTF8StringEncoding)
+    );
+    const buffer = toArrayBuffer(data);
+    data.setLength$(0);
+    expect(Buffer.from(buffer).toString("utf8")).toBe("abc");
+  });
+
+  test("should keep the data alive after the wrapper is dropped", () => {
+    let buffer: ArrayBuffer;
+    {
+      const data = NSString.stringWithUTF8String$("still here").dataUsingEncoding$(NSUTF8StringEncoding);
+      buffer = toArrayBuffer(data);
+    }
+    if (typeof globalThis.gc === "function") globalThis.gc();
+    expect(Buffer.from(buffer).toString("utf8")).toBe("still here");
+  });
+
+  test("should reject non-NSData objects", () => {
+    expect(() => toArrayBuffer(NSString.stringWithUTF8String$("nope"))).toThrow();
+  });
+});
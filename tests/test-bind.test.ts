@@ -0,0 +1,83 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, bind } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSMutableString = foundation["NSMutableString"] as any;
+const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+
+describe("bind()", () => {
+  test("should update only the variable slot on each invoke", () => {
+    const text = NSMutableString.stringWithUTF8String$("a-b-c-d");
+    const plus = NSString.stringWithUTF8String$("+");
+    const replace = bind(text, "replaceCharactersInRange$withString$", [undefined, plus]);
+    expect(replace.variableCount).toBe(1);
+    for (let i = 1; i < 7; i += 2) {
+      replace.invoke({ location: i, length: 1 });
+    }
+    expect(text.UTF8String()).toBe("a+b+c+d");
+  });
+
+  test("should keep fixed arguments alive after the caller drops them", () => {
+    const dict = NSMutableDictionary.dictionary();
+    // The fixed value is a JS string converted once; nothing else references it.
+    const setValue = bind(dict, "setObject$forKey$", ["shared-value", undefined]);
+    for (let i = 0; i < 50; i++) {
+      setValue.invoke(NSString.stringWithUTF8String$(`key-${i}`));
+    }
+    expect(dict.count()).toBe(50);
+    expect(dict.objectForKey$(NSString.stringWithUTF8String$("key-49")).UTF8String()).toBe("shared-value");
+  });
+
+  test("should treat holes as variable slots and null as a fixed nil", () => {
+    const text = NSMutableString.stringWithUTF8String$("hello");
+    // eslint-disable-next-line no-sparse-arrays
+    const append = bind(text, "appendString$", [,]);
+    append.invoke(NSString.stringWithUTF8String$(" world"));
+    expect(text.UTF8String()).toBe("hello world");
+
+    const equalsNil = bind(text, "isEqual$", [null]);
+    expect(equalsNil.variableCount).toBe(0);
+    expect(equalsNil.invoke()).toBe(false);
+  });
+
+  test("should mix fixed and variable arguments on direct sends", () => {
+    const text = NSString.stringWithUTF8String$("abcABC");
+    // Register struct argument, fixed and variable
+    const fixedRange = bind(text, "substringWithRange$", [{ location: 1, length: 2 }]);
+    expect(fixedRange.invoke().UTF8String()).toBe("bc");
+    const range = bind(text, "substringWithRange$", [undefined]);
+    expect(range.invoke({ location: 3, length: 3 }).UTF8String()).toBe("ABC");
+    // Register struct return with a fixed integer argument (NSCaseInsensitiveSearch)
+    const find = bind(text, "rangeOfString$options$", [undefined, 1]);
+    expect(find.invoke(NSString.stringWithUTF8String$("BC"))).toEqual({ location: 1, length: 2 });
+    // Float argument
+    const number = bind(NSNumber, "numberWithDouble$", [undefined]);
+    expect(number.invoke(2.5).doubleValue()).toBe(2.5);
+    expect(bind(NSNumber, "numberWithFloat$", [0.5]).invoke().floatValue()).toBe(0.5);
+  });
+
+  test("should support fully fixed bindings and return values", () => {
+    const text = NSString.stringWithUTF8String$("Hello");
+    const upper = bind(text, "uppercaseString", []);
+    expect(upper.variableCount).toBe(0);
+    expect(upper.invoke().UTF8String()).toBe("HELLO");
+    const hasPrefix = bind(text, "hasPrefix$", [undefined]);
+    expect(hasPrefix.invoke(NSString.stringWithUTF8String$("He"))).toBe(true);
+    expect(hasPrefix.invoke(NSString.stringWithUTF8String$("lo"))).toBe(false);
+  });
+
+  test("should return structs", () => {
+    const text = NSString.stringWithUTF8String$("abcabc");
+    const find = bind(text, "rangeOfString$", [undefined]);
+    expect(find.invoke(NSString.stringWithUTF8String$("ca"))).toEqual({ location: 2, length: 2 });
+  });
+
+  test("should validate argument counts", () => {
+    const text = NSMutableString.stringWithUTF8String$("x");
+    expect(() => bind(text, "appendString$", [])).toThrow();
+    const append = bind(text, "appendString$", [undefined]);
+    expect(() => append.invoke()).toThrow();
+  });
+});
@@ -260,6 +260,46 @@ describe("Block Support Tests", () => {
     );
   });
 
+  test("should keep block argument detection stable across many invocations", () => {
+    const arr = NSMutableArray.array();
+    for (let i = 0; i < 50; i++) {
+      arr.addObject$(NSNumber.numberWithInt$(i * 3));
+    }
+    for (let round = 0; round < 3; round++) {
+      const values: number[] = [];
+      const indices: number[] = [];
+      (arr as _NSArray).enumerateObjectsUsingBlock$((obj: any, idx: number, _stop: any) => {
+        values.push(obj.intValue());
+        indices.push(idx);
+      });
+      expect(values).toEqual(Array.from({ length: 50 }, (_, i) => i * 3));
+      expect(indices).toEqual(Array.from({ length: 50 }, (_, i) => i));
+    }
+  });
+
+  test("should compile separate signatures for untyped blocks of different arity", () => {
+    const arr = NSMutableArray.array();
+    arr.addObject$(NSNumber.numberWithInt$(7));
+    arr.addObject$(NSNumber.numberWithInt$(8));
+
+    const oneArg: number[] = [];
+    (arr as _NSArray).enumerateObjectsUsingBlock$(((obj: any) => {
+      oneArg.push(obj.intValue());
+    }) as any);
+    const threeArg: number[] = [];
+    (arr as _NSArray).enumerateObjectsUsingBlock$((obj: any, idx: number, _stop: any) => {
+      threeArg.push(obj.intValue() * 10 + idx);
+    });
+    const twoArg: number[] = [];
+    (arr as _NSArray).enumerateObjectsUsingBlock$(((obj: any, idx: number) => {
+      twoArg.push(obj.intValue() + idx);
+    }) as any);
+
+    expect(oneArg).toEqual([7, 8]);
+    expect(threeArg).toEqual([70, 81]);
+    expect(twoArg).toEqual([7, 9]);
+  });
+
   test("should reject invalid typedBlock types signatures", () => {
     expect(() =>
       typedBlock(
@@ -0,0 +1,94 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, NobjcWeakRef, borrowScope, parallelSendMap, subscribe } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSArray = foundation["NSArray"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+
+describe("borrowScope()", () => {
+  const words = NSString.stringWithUTF8String$("alpha beta gamma").componentsSeparatedByString$(
+    NSString.stringWithUTF8String$(" ")
+  );
+
+  test("should return plain values computed from borrowed objects", () => {
+    const result = borrowScope(() => words.objectAtIndex$(1).uppercaseString().UTF8String());
+    expect(result).toBe("BETA");
+  });
+
+  test("should revoke borrowed wrappers when the scope exits", () => {
+    const leaked = borrowScope(() => words.objectAtIndex$(0));
+    expect(() => leaked.length()).toThrow("borrowScope");
+  });
+
+  test("should revoke wrappers even when fn throws", () => {
+    let leaked: any;
+    expect(() =>
+      borrowScope(() => {
+        leaked = words.lastObject();
+        throw new Error("boom");
+      })
+    ).toThrow("boom");
+    expect(() => leaked.UTF8String()).toThrow("borrowScope");
+  });
+
+  test("should keep objects promoted with $retain()", () => {
+    const kept = borrowScope(() => words.objectAtIndex$(2).$retain());
+    expect(kept.UTF8String()).toBe("gamma");
+  });
+
+  test("should reject revoked wrappers passed as arguments", () => {
+    const leaked = borrowScope(() => words.firstObject());
+    expect(() => NSArray.arrayWithObject$(leaked)).toThrow("borrowScope");
+  });
+
+  test("should reject revoked wrappers at non-send entry points", () => {
+    const leaked = borrowScope(() => words.firstObject());
+    // A revoked sender must not be taken as nil (which observes every sender).
+    expect(() => subscribe("NobjcRevokedSender", leaked, () => {})).toThrow("borrowScope");
+    expect(() => leaked.$weak()).toThrow("borrowScope");
+  });
+
+  test("should leave wrappers created outside the scope alone", () => {
+    const outside = words.firstObject();
+    borrowScope(() => outside.length());
+    expect(outside.UTF8String()).toBe("alpha");
+  });
+
+  test("should attribute wrappers to the innermost scope", () => {
+    let inner: any;
+    borrowScope(() => {
+      const outer = words.firstObject();
+      borrowScope(() => {
+        inner = words.lastObject();
+      });
+      expect(() => inner.length()).toThrow("borrowScope");
+      expect(outer.length()).toBe(5);
+    });
+  });
+
+  test("should retain parallelSendMap object results", () => {
+    const numbers = Array.from({ length: 64 }, (_, i) => NSNumber.numberWithInt$(i * 7));
+    // stringValue results are autoreleased on the workers; the wrappers must own them.
+    const strings = borrowScope(() => {
+      const results = parallelSendMap("stringValue", numbers, { threadSafe: true }) as any[];
+      expect(results[3].UTF8String()).toBe("21");
+      return results;
+    });
+    expect(strings[63].UTF8String()).toBe("441");
+  });
+
+  test("should retain objects loaded from weak references", () => {
+    const first = NSNumber.numberWithInt$(123456).stringValue();
+    const second = NSNumber.numberWithInt$(654321).stringValue();
+    const ref = first.$weak();
+    const loaded = borrowScope(() => ref.deref());
+    const all = borrowScope(() => NobjcWeakRef.derefAll([ref, second.$weak()]));
+    expect(loaded!.UTF8String()).toBe("123456");
+    expect(all[1]!.UTF8String()).toBe("654321");
+  });
+
+  test("should reject async callbacks", () => {
+    expect(() => borrowScope(async () => 1)).toThrow("synchronous");
+  });
+});
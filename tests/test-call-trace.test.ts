@@ -0,0 +1,48 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, Trace, callFunction } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSMutableArray = foundation["NSMutableArray"] as any;
+const NSString = foundation["NSString"] as any;
+
+describe("Trace", () => {
+  test("should record call shapes without argument values", () => {
+    const str = NSString.stringWithUTF8String$("trace me");
+    const array = NSMutableArray.array();
+    array.addObject$(str);
+
+    Trace.start();
+    for (let i = 0; i < 3; i++) {
+      str.characterAtIndex$(0);
+    }
+    callFunction("CFStringGetLength", { returns: "q", args: ["@"] }, str);
+    array.enumerateObjectsUsingBlock$(() => {});
+    const trace = Trace.parse(Trace.stop());
+
+    expect(trace.droppedRecords).toBe(0);
+    expect(trace.records.every((record) => record.thread === 0)).toBe(true);
+
+    const summary = Trace.summarize(trace);
+    const send = summary.find(({ shape }) => shape.name === "characterAtIndex:");
+    expect(send?.count).toBe(3);
+    expect(send?.shape.kind).toBe("send");
+    expect(send?.shape.returns).toEqual({ kind: "S", size: 2 });
+    expect(send?.shape.args).toEqual([{ kind: "Q", size: 8 }]);
+
+    const fn = summary.find(({ shape }) => shape.kind === "function");
+    expect(fn?.shape.name).toBe("CFStringGetLength");
+    expect(summary.some(({ shape }) => shape.kind === "callback" && shape.owner === "block")).toBe(true);
+
+    // Records are in call order
+    const times = trace.records.map((record) => record.timeUs);
+    expect(times).toEqual([...times].sort((a, b) => a - b));
+  });
+
+  test("start and stop should validate state", () => {
+    expect(() => Trace.stop()).toThrow(/No call trace/);
+    Trace.start();
+    expect(() => Trace.start()).toThrow(/already being recorded/);
+    Trace.stop();
+    expect(() => Trace.parse(new Uint8Array(16))).toThrow(/Not a call trace/);
+  });
+});
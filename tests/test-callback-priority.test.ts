@@ -0,0 +1,65 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, getCallbackDispatcherStats, subscribe, typedBlock, withPriority } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSNotificationCenter = foundation["NSNotificationCenter"] as any;
+const NSOperationQueue = foundation["NSOperationQueue"] as any;
+
+function sleep(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+// Run `fn` as a block on an NSOperationQueue worker thread.
+function runOnWorker(fn: () => void): void {
+  NSOperationQueue.new().addOperationWithBlock$(fn);
+}
+
+describe("Callback priority lanes", () => {
+  test("withPriority should tag and return the same function", () => {
+    const fn = () => {};
+    expect(withPriority("background", fn)).toBe(fn);
+    expect(() => withPriority("urgent" as any, fn)).toThrow(/Unknown callback priority/);
+  });
+
+  test("stats should report all three lanes", () => {
+    const stats = getCallbackDispatcherStats();
+    expect(typeof stats.drains).toBe("number");
+    for (const lane of ["blocking", "interactive", "background"] as const) {
+      expect(stats.lanes[lane].posted).toBeGreaterThanOrEqual(stats.lanes[lane].delivered);
+    }
+  });
+
+  test("blocks called from a worker thread should use their lane", async () => {
+    const before = getCallbackDispatcherStats().lanes.background.delivered;
+    await new Promise<void>((resolve) => runOnWorker(withPriority("background", () => resolve())));
+    expect(getCallbackDispatcherStats().lanes.background.delivered).toBe(before + 1);
+  });
+
+  test("typedBlock should accept a priority", async () => {
+    const before = getCallbackDispatcherStats().lanes.interactive.delivered;
+    await new Promise<void>((resolve) =>
+      runOnWorker(typedBlock({ returns: "v", priority: "interactive" }, () => resolve()))
+    );
+    expect(getCallbackDispatcherStats().lanes.interactive.delivered).toBeGreaterThan(before);
+  });
+
+  test("a waiting block should run before queued notification batches", async () => {
+    const order: string[] = [];
+    const subscription = subscribe("NobjcPriorityTest", null, () => order.push("notification"));
+    NSNotificationCenter.defaultCenter().postNotificationName$object$(
+      NSString.stringWithUTF8String$("NobjcPriorityTest"),
+      null
+    );
+
+    // Keep the JS thread busy until the worker's block is queued behind the
+    // notification batch.
+    runOnWorker(() => order.push("block"));
+    const deadline = Date.now() + 2000;
+    while (getCallbackDispatcherStats().lanes.blocking.pending === 0 && Date.now() < deadline) {}
+
+    await sleep(50);
+    subscription.stop();
+    expect(order).toEqual(["block", "notification"]);
+  });
+});
@@ -0,0 +1,54 @@
+import { test, expect, describe } from "./test-utils.js";
+import {
+  NobjcLibrary,
+  getCallbackDispatcherStats,
+  setCallbackTimeout,
+  typedBlock,
+  withTimeout
+} from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSMutableArray = foundation["NSMutableArray"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+
+const NSEnumerationConcurrent = 1;
+
+describe("Callback timeouts", () => {
+  test("withTimeout should tag and return the same function", () => {
+    const fn = () => 1;
+    expect(withTimeout(10, fn, 0)).toBe(fn);
+    expect(() => withTimeout(-1, fn)).toThrow(RangeError);
+    expect(() => withTimeout(10, fn, "yes" as any)).toThrow(/defaultReturn/);
+  });
+
+  test("setCallbackTimeout should validate its argument", () => {
+    expect(() => setCallbackTimeout(-5)).toThrow(RangeError);
+    setCallbackTimeout(0);
+  });
+
+  test("stats should include a wait histogram", () => {
+    const { waits } = getCallbackDispatcherStats();
+    expect(waits.count).toBeGreaterThanOrEqual(waits.timeouts);
+    expect(waits.histogram[waits.histogram.length - 1].upToMs).toBe(Infinity);
+    expect(waits.histogram.reduce((sum, bucket) => sum + bucket.count, 0)).toBe(waits.count);
+  });
+
+  test("worker threads should return the default while the JS thread is blocked", () => {
+    const array = NSMutableArray.array();
+    for (let i = 0; i < 64; i++) {
+      array.addObject$(NSNumber.numberWithInt$(i));
+    }
+    const before = getCallbackDispatcherStats().waits.timeouts;
+
+    // The JS thread is inside the enumeration call, so blocks invoked on GCD
+    // workers can only finish by timing out. Without a deadline this would
+    // deadlock.
+    const indexes = array.indexesOfObjectsWithOptions$passingTest$(
+      NSEnumerationConcurrent,
+      typedBlock({ returns: "B", args: ["@", "Q", "^B"], timeoutMs: 5, defaultReturn: false }, () => true)
+    );
+
+    const timedOut = getCallbackDispatcherStats().waits.timeouts - before;
+    expect(indexes.count() + timedOut).toBe(64);
+  });
+});
@@ -62,6 +62,17 @@ describe("Inspect Symbol Tests", () => {
     expect(result).toBe("test string");
   });
 
+  test("toString should preserve non-ASCII NSString content", () => {
+    const str = NSString.stringWithUTF8String$("héllo wörld 👋");
+    expect(str.toString()).toBe("héllo wörld 👋");
+  });
+
+  test("toString should use description for non-string objects", () => {
+    const num = NSNumber.numberWithInt$(42);
+    expect(num.toString()).toBe("42");
+    expect(String(Foundation.NSString)).toBe("NSString");
+  });
+
   test("inspect symbol should be accessible on the proxy", () => {
     const str = NSString.stringWithUTF8String$("inspect test");
     const inspectSymbol = Symbol.for("nodejs.util.inspect.custom");
@@ -0,0 +1,123 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, NobjcObject, observe } from "../dist/index.js";
+import type { KeyValueChange } from "../dist/index.js";
+
+interface _NSProgress extends NobjcObject {
+  completedUnitCount(): number;
+  setCompletedUnitCount$(count: number): void;
+}
+
+interface _NSProgressConstructor {
+  progressWithTotalUnitCount$(count: number): _NSProgress;
+}
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSProgress = foundation["NSProgress"] as unknown as _NSProgressConstructor;
+
+function sleep(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+describe("observe()", () => {
+  test("should deliver new and old values as JS primitives", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    const received: KeyValueChange[] = [];
+    const observation = observe(progress, "completedUnitCount", (changes) => {
+      received.push(...changes);
+    });
+
+    progress.setCompletedUnitCount$(10);
+    await sleep(50);
+    observation.stop();
+
+    expect(received.length).toBe(1);
+    expect(received[0].keyPath).toBe("completedUnitCount");
+    expect(received[0].kind).toBe(1);
+    expect(received[0].oldValue).toBe(0);
+    expect(received[0].newValue).toBe(10);
+    expect(received[0].count).toBe(1);
+  });
+
+  test("should coalesce bursts of changes", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    const received: KeyValueChange[] = [];
+    const observation = observe(progress, "completedUnitCount", { coalesceMs: 20 }, (changes) => {
+      received.push(...changes);
+    });
+
+    for (let i = 1; i <= 50; i++) {
+      progress.setCompletedUnitCount$(i);
+    }
+    await sleep(100);
+    observation.stop();
+
+    expect(received.length).toBe(1);
+    expect(received[0].oldValue).toBe(0);
+    expect(received[0].newValue).toBe(50);
+    expect(received[0].count).toBe(50);
+  });
+
+  test("should deliver every change when coalescing is off", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    const received: KeyValueChange[] = [];
+    const observation = observe(progress, "completedUnitCount", (changes) => {
+      received.push(...changes);
+    });
+
+    for (let i = 1; i <= 5; i++) {
+      progress.setCompletedUnitCount$(i);
+    }
+    await sleep(50);
+    observation.stop();
+
+    expect(received.map((c) => c.newValue)).toEqual([1, 2, 3, 4, 5]);
+  });
+
+  test("should support the initial option", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    progress.setCompletedUnitCount$(7);
+    const received: KeyValueChange[] = [];
+    const observation = observe(progress, "completedUnitCount", { options: ["new", "initial"] }, (changes) => {
+      received.push(...changes);
+    });
+    await sleep(50);
+    observation.stop();
+
+    expect(received.length).toBe(1);
+    expect(received[0].newValue).toBe(7);
+    expect("oldValue" in received[0]).toBe(false);
+  });
+
+  test("should work as an async iterator", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    const observation = observe(progress, "completedUnitCount");
+
+    progress.setCompletedUnitCount$(3);
+    const result = await observation.next();
+    expect(result.done).toBe(false);
+    expect(result.value[0].newValue).toBe(3);
+
+    observation.stop();
+    const finished = await observation.next();
+    expect(finished.done).toBe(true);
+  });
+
+  test("should stop delivering after stop()", async () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    let calls = 0;
+    const observation = observe(progress, "completedUnitCount", () => {
+      calls++;
+    });
+    observation.stop();
+    observation.stop();
+
+    progress.setCompletedUnitCount$(1);
+    await sleep(50);
+    expect(calls).toBe(0);
+  });
+
+  test("should reject unknown options", () => {
+    const progress = NSProgress.progressWithTotalUnitCount$(100);
+    expect(() => observe(progress, "completedUnitCount", { options: ["bogus" as any] })).toThrow();
+  });
+});
@@ -0,0 +1,97 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, lazyView } from "../dist/index.js";
+import type { LazyArrayView, LazyDictionaryView } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+const NSMutableArray = foundation["NSMutableArray"] as any;
+const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+
+function makeArray(count: number) {
+  const array = NSMutableArray.arrayWithCapacity$(count);
+  for (let i = 0; i < count; i++) {
+    array.addObject$(NSNumber.numberWithInt$(i));
+  }
+  return array;
+}
+
+describe("lazyView() over NSArray", () => {
+  const array = makeArray(1000);
+
+  test("should expose length and index reads across chunk boundaries", () => {
+    const view = lazyView(array) as LazyArrayView;
+    expect(view.length).toBe(1000);
+    for (const i of [0, 63, 64, 65, 127, 128, 500, 999]) {
+      expect(view[i]!.intValue()).toBe(i);
+    }
+    expect(view[1000]).toBeUndefined();
+    expect(view.at(-1)!.intValue()).toBe(999);
+    expect(0 in view).toBe(true);
+    expect(1000 in view).toBe(false);
+  });
+
+  test("should slice and iterate", () => {
+    const view = lazyView(array) as LazyArrayView;
+    expect(view.slice(60, 70).map((n) => n.intValue())).toEqual([60, 61, 62, 63, 64, 65, 66, 67, 68, 69]);
+    expect(view.slice(-2).map((n) => n.intValue())).toEqual([998, 999]);
+    let sum = 0;
+    let seen = 0;
+    for (const n of view) {
+      sum += n.intValue();
+      seen++;
+    }
+    expect(seen).toBe(1000);
+    expect(sum).toBe((999 * 1000) / 2);
+  });
+
+  test("should handle empty arrays", () => {
+    const view = lazyView(NSMutableArray.array()) as LazyArrayView;
+    expect(view.length).toBe(0);
+    expect(view[0]).toBeUndefined();
+    expect([...view]).toEqual([]);
+  });
+
+  test("should throw after the array is mutated", () => {
+    const mutable = makeArray(10);
+    const view = lazyView(mutable) as LazyArrayView;
+    expect(view[3]!.intValue()).toBe(3);
+    mutable.addObject$(NSNumber.numberWithInt$(10));
+    expect(() => view[3]).toThrow("mutated");
+    expect(() => view.length).toThrow("mutated");
+  });
+});
+
+describe("lazyView() over NSDictionary", () => {
+  test("should look up keys and list them lazily", () => {
+    const dict = NSMutableDictionary.dictionary();
+    for (let i = 0; i < 100; i++) {
+      dict.setObject$forKey$(NSNumber.numberWithInt$(i * 2), NSString.stringWithUTF8String$(`key-${i}`));
+    }
+    const view = lazyView(dict) as LazyDictionaryView;
+    expect(view.size).toBe(100);
+    expect(view.get("key-21")!.intValue()).toBe(42);
+    expect(view.get(NSString.stringWithUTF8String$("key-5"))!.intValue()).toBe(10);
+    expect(view.has("key-99")).toBe(true);
+    expect(view.has("missing")).toBe(false);
+    const keys = view.keys();
+    expect(keys.length).toBe(100);
+    expect([...keys].map((k) => k.toString()).sort()).toEqual(
+      Array.from({ length: 100 }, (_, i) => `key-${i}`).sort()
+    );
+  });
+
+  test("should throw after the dictionary is mutated", () => {
+    const dict = NSMutableDictionary.dictionary();
+    dict.setObject$forKey$(NSNumber.numberWithInt$(1), NSString.stringWithUTF8String$("a"));
+    const view = lazyView(dict) as LazyDictionaryView;
+    const keys = view.keys();
+    dict.setObject$forKey$(NSNumber.numberWithInt$(2), NSString.stringWithUTF8String$("b"));
+    expect(() => view.get("a")).toThrow("mutated");
+    expect(() => keys[0]).toThrow("mutated");
+  });
+
+  test("should reject other objects", () => {
+    expect(() => lazyView(NSString.stringWithUTF8String$("nope"))).toThrow();
+  });
+});
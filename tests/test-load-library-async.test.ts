@@ -0,0 +1,61 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, loadLibraryAsync } from "../dist/index.js";
+
+const FOUNDATION = "/System/Library/Frameworks/Foundation.framework/Foundation";
+const CORE_FOUNDATION = "/System/Library/Frameworks/CoreFoundation.framework/CoreFoundation";
+const NETWORK = "/System/Library/Frameworks/Network.framework/Network";
+// Loaded only by the tests below, so their classes are absent until then
+const CONTACTS = "/System/Library/Frameworks/Contacts.framework/Contacts";
+const EVENT_KIT = "/System/Library/Frameworks/EventKit.framework/EventKit";
+
+// Looks classes up without loading anything beyond Foundation
+const probe = new NobjcLibrary(FOUNDATION);
+
+describe("loadLibraryAsync", () => {
+  test("should load several libraries and report per-library timings", async () => {
+    const results = await loadLibraryAsync([FOUNDATION, CORE_FOUNDATION, NETWORK]);
+    expect(results.length).toBe(3);
+    expect(results.map((r) => r.path)).toEqual([FOUNDATION, CORE_FOUNDATION, NETWORK]);
+    for (const result of results) {
+      expect(result.loaded).toBe(true);
+      expect(typeof result.ms).toBe("number");
+      expect(result.ms >= 0).toBe(true);
+      expect(result.error).toBeUndefined();
+    }
+  });
+
+  test("should report failures per entry without rejecting", async () => {
+    const results = await loadLibraryAsync([FOUNDATION, "/nonexistent/Nope.framework/Nope"]);
+    expect(results[0].loaded).toBe(true);
+    expect(results[1].loaded).toBe(false);
+    expect(typeof results[1].error).toBe("string");
+  });
+
+  test("should resolve an empty list", async () => {
+    expect(await loadLibraryAsync([])).toEqual([]);
+  });
+
+  test("should reject non-string paths", () => {
+    expect(() => loadLibraryAsync([42 as any])).toThrow();
+  });
+
+  test("should make classes available after loading", async () => {
+    expect(probe["CNContact"]).toBeUndefined();
+    const [result] = await loadLibraryAsync([CONTACTS]);
+    expect(result.loaded).toBe(true);
+    expect(probe["CNContact"]).toBeDefined();
+  });
+
+  test("should start loading in the background with the preload hint", async () => {
+    expect(probe["EKEventStore"]).toBeUndefined();
+    const eventKit = new NobjcLibrary(EVENT_KIT, { preload: true });
+
+    // The class appears without any access to `eventKit` itself
+    const deadline = Date.now() + 5000;
+    while (probe["EKEventStore"] === undefined && Date.now() < deadline) {
+      await new Promise((resolve) => setTimeout(resolve, 5));
+    }
+    expect(probe["EKEventStore"]).toBeDefined();
+    expect(eventKit["EKEventStore"]).toBeDefined();
+  });
+});
@@ -0,0 +1,73 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, borrowScope, getCallbackDispatcherStats, withPriority } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSDate = foundation["NSDate"] as any;
+const NSItemProvider = foundation["NSItemProvider"] as any;
+const NSOperationQueue = foundation["NSOperationQueue"] as any;
+const NSRunLoop = foundation["NSRunLoop"] as any;
+const NSString = foundation["NSString"] as any;
+
+// Spin the current run loop from inside native calls until `done()` or the
+// timeout.
+function runLoopUntil(done: () => boolean, timeoutMs = 2000): void {
+  const runLoop = NSRunLoop.currentRunLoop();
+  const deadline = Date.now() + timeoutMs;
+  while (!done() && Date.now() < deadline) {
+    runLoop.runUntilDate$(NSDate.dateWithTimeIntervalSinceNow$(0.05));
+  }
+}
+
+describe("Nested callbacks", () => {
+  test("a worker's block should run while the JS thread is inside a native call", () => {
+    const before = getCallbackDispatcherStats().nested;
+    let ran = false;
+    let insideNative = false;
+    NSOperationQueue.new().addOperationWithBlock$(() => {
+      ran = insideNative;
+    });
+
+    // Without nested delivery the block could only run after this
+    // synchronous code returns to the event loop.
+    insideNative = true;
+    runLoopUntil(() => ran);
+    insideNative = false;
+
+    expect(ran).toBe(true);
+    expect(getCallbackDispatcherStats().nested).toBeGreaterThan(before);
+  });
+
+  test("arguments delivered inside a borrowScope should outlive it", () => {
+    const provider = NSItemProvider.alloc().initWithObject$(NSString.stringWithUTF8String$("delivered"));
+    let kept: any;
+    borrowScope(() => {
+      // The completion handler runs on a background queue and reaches JS
+      // through nested delivery while the scope is still open.
+      provider.loadObjectOfClass$completionHandler$(NSString, (value: any) => {
+        kept = value;
+      });
+      runLoopUntil(() => kept !== undefined);
+    });
+    expect(kept.UTF8String()).toBe("delivered");
+  });
+
+  test("non-blocking lanes should wait for the regular drain", async () => {
+    let ranInside = false;
+    let insideNative = false;
+    let ran = false;
+    await new Promise<void>((resolve) => {
+      NSOperationQueue.new().addOperationWithBlock$(
+        withPriority("background", () => {
+          ranInside = insideNative;
+          ran = true;
+          resolve();
+        })
+      );
+      insideNative = true;
+      runLoopUntil(() => false, 200);
+      insideNative = false;
+    });
+    expect(ran).toBe(true);
+    expect(ranInside).toBe(false);
+  });
+});
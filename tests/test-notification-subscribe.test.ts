@@ -0,0 +1,95 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, NobjcObject, subscribe } from "../dist/index.js";
+import type { NotificationRecord } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+const NSNotificationCenter = foundation["NSNotificationCenter"] as any;
+const NSObject = foundation["NSObject"] as any;
+
+const str = (s: string) => NSString.stringWithUTF8String$(s);
+
+function post(name: string, object: NobjcObject | null, userInfo: NobjcObject | null = null): void {
+  NSNotificationCenter.defaultCenter().postNotificationName$object$userInfo$(str(name), object, userInfo);
+}
+
+function sleep(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+describe("subscribe()", () => {
+  test("should deliver notifications with only the requested userInfo keys", async () => {
+    const received: NotificationRecord[] = [];
+    const subscription = subscribe("NobjcTestNotification", null, { keys: ["count"] }, (records) => {
+      received.push(...records);
+    });
+
+    const userInfo = NSMutableDictionary.dictionary();
+    userInfo.setObject$forKey$(NSNumber.numberWithInt$(42), str("count"));
+    userInfo.setObject$forKey$(str("ignored"), str("other"));
+    post("NobjcTestNotification", null, userInfo);
+    await sleep(50);
+    subscription.stop();
+
+    expect(received.length).toBe(1);
+    expect(received[0].name).toBe("NobjcTestNotification");
+    expect(received[0].object).toBe(null);
+    expect(received[0].userInfo).toEqual({ count: 42 });
+  });
+
+  test("should batch notifications posted within batchMs", async () => {
+    const batches: NotificationRecord[][] = [];
+    const subscription = subscribe("NobjcBatchNotification", null, { batchMs: 20 }, (records) => {
+      batches.push(records);
+    });
+
+    for (let i = 0; i < 25; i++) {
+      post("NobjcBatchNotification", null);
+    }
+    await sleep(100);
+    subscription.stop();
+
+    expect(batches.length).toBe(1);
+    expect(batches[0].length).toBe(25);
+  });
+
+  test("should filter by sender", async () => {
+    const sender = NSObject.alloc().init();
+    const other = NSObject.alloc().init();
+    const received: NotificationRecord[] = [];
+    const subscription = subscribe("NobjcSenderNotification", sender, (records) => {
+      received.push(...records);
+    });
+
+    post("NobjcSenderNotification", other);
+    post("NobjcSenderNotification", sender);
+    await sleep(50);
+    subscription.stop();
+
+    expect(received.length).toBe(1);
+    expect(received[0].object).not.toBe(null);
+  });
+
+  test("should work as an async iterator", async () => {
+    const subscription = subscribe("NobjcIteratorNotification", null);
+    post("NobjcIteratorNotification", null);
+
+    const result = await subscription.next();
+    expect(result.done).toBe(false);
+    expect(result.value[0].name).toBe("NobjcIteratorNotification");
+    subscription.stop();
+  });
+
+  test("should stop delivering after stop()", async () => {
+    let calls = 0;
+    const subscription = subscribe("NobjcStoppedNotification", null, () => {
+      calls++;
+    });
+    subscription.stop();
+    post("NobjcStoppedNotification", null);
+    await sleep(50);
+    expect(calls).toBe(0);
+  });
+});
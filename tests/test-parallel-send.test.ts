@@ -0,0 +1,74 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcClass, NobjcLibrary, NobjcObject, parallelSendMap } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSNumber = foundation["NSNumber"] as any;
+
+const words = Array.from({ length: 500 }, (_, i) => `Word-${i}`);
+const strings: NobjcObject[] = words.map((w) => NSString.stringWithUTF8String$(w));
+
+describe("parallelSendMap()", () => {
+  test("should require threadSafe: true", () => {
+    expect(() => (parallelSendMap as any)("length", strings, {})).toThrow("threadSafe");
+  });
+
+  test("should write integer results into a new Float64Array", () => {
+    const lengths = parallelSendMap("length", strings, { threadSafe: true }) as Float64Array;
+    expect(lengths).toBeInstanceOf(Float64Array);
+    expect(Array.from(lengths)).toEqual(words.map((w) => w.length));
+  });
+
+  test("should write into a caller-provided TypedArray", () => {
+    const out = new BigUint64Array(strings.length);
+    const result = parallelSendMap("hash", strings, { threadSafe: true, threads: 4, out });
+    expect(result).toBe(out);
+    expect(out[0]).toBe(BigInt(strings[0].hash()));
+    expect(out[499]).toBe(BigInt(strings[499].hash()));
+  });
+
+  test("should write floating-point results", () => {
+    const numbers = Array.from({ length: 100 }, (_, i) => NSNumber.numberWithDouble$(i + 0.5));
+    const out = parallelSendMap("doubleValue", numbers, { threadSafe: true, out: new Float64Array(100) });
+    expect(out![42]).toBe(42.5);
+  });
+
+  test("should reject an integer TypedArray for floating-point results", () => {
+    const numbers = [NSNumber.numberWithDouble$(1.5)];
+    expect(() => parallelSendMap("doubleValue", numbers, { threadSafe: true, out: new Int32Array(1) })).toThrow();
+  });
+
+  test("should return wrapped objects for object results", () => {
+    const upper = parallelSendMap("uppercaseString", strings, { threadSafe: true }) as NobjcObject[];
+    expect(upper.length).toBe(strings.length);
+    expect(upper[7].toString()).toBe("WORD-7");
+    expect(upper[499].toString()).toBe("WORD-499");
+  });
+
+  test("should treat null receivers as nil", () => {
+    const lengths = parallelSendMap("length", [strings[0], null], { threadSafe: true }) as Float64Array;
+    expect(Array.from(lengths)).toEqual([words[0].length, 0]);
+  });
+
+  test("should reject receivers that do not respond to the selector", () => {
+    expect(() => parallelSendMap("length", [strings[0], NSNumber.numberWithInt$(1)], { threadSafe: true })).toThrow(
+      "does not respond"
+    );
+  });
+
+  test("should reject receivers whose class declares another return type", () => {
+    const DoubleLength = NobjcClass.define({
+      name: "TestParallelDoubleLength",
+      superclass: "NSObject",
+      methods: {
+        length: { types: "d@:", implementation: () => 1.5 }
+      }
+    }) as any;
+    const other = DoubleLength.alloc().init();
+    expect(() => parallelSendMap("length", [strings[0], other], { threadSafe: true })).toThrow("expected Q");
+  });
+
+  test("should reject an out array that is too short", () => {
+    expect(() => parallelSendMap("length", strings, { threadSafe: true, out: new Float64Array(1) })).toThrow();
+  });
+});
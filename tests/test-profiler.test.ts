@@ -0,0 +1,41 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, Profiler, callFunction } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSMutableArray = foundation["NSMutableArray"] as any;
+const NSString = foundation["NSString"] as any;
+
+describe("Profiler", () => {
+  test("should attribute samples to selectors and functions", () => {
+    const array = NSMutableArray.array();
+    const str = NSString.stringWithUTF8String$("profile me");
+
+    Profiler.start({ hz: 5000 });
+    const deadline = Date.now() + 200;
+    while (Date.now() < deadline) {
+      // Sorting a large array keeps the thread inside one send long enough
+      // to be sampled.
+      for (let i = 0; i < 2000; i++) array.addObject$(str);
+      array.sortUsingSelector$("compare:");
+      callFunction("CFStringGetLength", { returns: "q", args: ["@"] }, str);
+    }
+    const profile = Profiler.stop();
+
+    expect(profile.hz).toBe(5000);
+    expect(profile.ticks).toBeGreaterThan(0);
+    expect(profile.samples).toBe(profile.stacks.reduce((sum, stack) => sum + stack.count, 0));
+    const frames = profile.stacks.flatMap((stack) => stack.frames);
+    expect(frames).toContain("-[__NSArrayM sortUsingSelector:]");
+
+    const folded = Profiler.toFolded(profile);
+    expect(folded.split("\n")[0]).toMatch(/ \d+$/);
+  });
+
+  test("start and stop should validate state", () => {
+    expect(() => Profiler.stop()).toThrow(/not running/);
+    expect(() => Profiler.start({ hz: 0 })).toThrow(RangeError);
+    Profiler.start();
+    expect(() => Profiler.start()).toThrow(/already running/);
+    Profiler.stop();
+  });
+});
@@ -0,0 +1,70 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, callFunction, resolveSymbols } from "../dist/index.js";
+
+const FOUNDATION = "/System/Library/Frameworks/Foundation.framework/Foundation";
+const FOUNDATION_SYMBOLS = ["NSHomeDirectory", "NSStringFromClass", "NSLog", "NSTemporaryDirectory"];
+
+describe("resolveSymbols", () => {
+  new NobjcLibrary(FOUNDATION)["NSObject"];
+
+  test("should resolve symbols globally", () => {
+    const symbols = resolveSymbols(FOUNDATION_SYMBOLS);
+    for (const name of FOUNDATION_SYMBOLS) {
+      expect(typeof symbols[name]).toBe("bigint");
+    }
+  });
+
+  test("should resolve through the image export index to the same addresses", () => {
+    const global = resolveSymbols(FOUNDATION_SYMBOLS);
+    const indexed = resolveSymbols(FOUNDATION_SYMBOLS, { image: FOUNDATION });
+    for (const name of FOUNDATION_SYMBOLS) {
+      expect(indexed[name]).toBe(global[name]);
+    }
+  });
+
+  test("should return null for missing symbols", () => {
+    const symbols = resolveSymbols(["NobjcDefinitelyNotASymbol", "NSHomeDirectory"], { image: FOUNDATION });
+    expect(symbols.NobjcDefinitelyNotASymbol).toBeNull();
+    expect(typeof symbols.NSHomeDirectory).toBe("bigint");
+  });
+
+  test("should not find symbols exported by other images", () => {
+    // CFStringGetLength lives in CoreFoundation, not Foundation's export trie.
+    const symbols = resolveSymbols(["CFStringGetLength"], { image: FOUNDATION });
+    expect(symbols.CFStringGetLength).toBeNull();
+  });
+
+  test("should throw for images that cannot be loaded", () => {
+    expect(() => resolveSymbols(["x"], { image: "/nonexistent/Nope.framework/Nope" })).toThrow();
+  });
+
+  test("callFunction should work after resolving", () => {
+    resolveSymbols(["NSHomeDirectory"], { image: FOUNDATION });
+    const home = callFunction("NSHomeDirectory", { returns: "@" });
+    expect(home.toString().length > 0).toBe(true);
+  });
+
+  test("callFunction should call image-scoped definitions", () => {
+    const { NSTemporaryDirectory } = resolveSymbols(["NSTemporaryDirectory"], { image: FOUNDATION });
+    const expected = callFunction("NSTemporaryDirectory", { returns: "@" }).toString();
+    expect(callFunction("NSTemporaryDirectory", { returns: "@", image: FOUNDATION }).toString()).toBe(expected);
+    expect(callFunction("NSTemporaryDirectory", { returns: "@", address: NSTemporaryDirectory! }).toString()).toBe(
+      expected
+    );
+  });
+
+  test("callFunction with an image should not fall back to other images", () => {
+    const text = "nobjc";
+    expect(callFunction("CFStringGetLength", { returns: "q", args: ["@"] }, text)).toBe(5);
+    expect(() => callFunction("CFStringGetLength", { returns: "q", args: ["@"], image: FOUNDATION }, text)).toThrow(
+      "not exported"
+    );
+  });
+
+  test("image-scoped results should not replace the global resolution", () => {
+    // CFStringGetLength is not Foundation's, so the image lookup misses
+    // while the global one (what callFunction uses) still finds it.
+    expect(resolveSymbols(["CFStringGetLength"], { image: FOUNDATION }).CFStringGetLength).toBeNull();
+    expect(typeof resolveSymbols(["CFStringGetLength"]).CFStringGetLength).toBe("bigint");
+  });
+});
@@ -0,0 +1,117 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, readableFromInputStream, writableFromOutputStream } from "../dist/index.js";
+import { mkdtempSync, readFileSync, writeFileSync, rmSync, openSync, closeSync, constants } from "node:fs";
+import { execFileSync } from "node:child_process";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { Readable } from "node:stream";
+import { pipeline } from "node:stream/promises";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSInputStream = foundation["NSInputStream"] as any;
+const NSOutputStream = foundation["NSOutputStream"] as any;
+
+const str = (s: string) => NSString.stringWithUTF8String$(s);
+
+function makeContents(size: number): Buffer {
+  const contents = Buffer.alloc(size);
+  for (let i = 0; i < size; i++) contents[i] = (i * 31) & 0xff;
+  return contents;
+}
+
+describe("Stream adapters", () => {
+  test("readableFromInputStream should read a whole file in chunks", async () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const file = join(dir, "input.bin");
+    const contents = makeContents(300 * 1024);
+    writeFileSync(file, contents);
+    try {
+      const input = NSInputStream.inputStreamWithFileAtPath$(str(file));
+      const chunks: Buffer[] = [];
+      for await (const chunk of readableFromInputStream(input, { chunkSize: 16 * 1024 })) {
+        expect(chunk.length).toBeLessThanOrEqual(16 * 1024);
+        chunks.push(Buffer.from(chunk));
+      }
+      expect(Buffer.compare(Buffer.concat(chunks), contents)).toBe(0);
+    } finally {
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test("readableFromInputStream should end immediately for empty data", async () => {
+    const data = str("").dataUsingEncoding$(4);
+    const input = NSInputStream.inputStreamWithData$(data);
+    const chunks: Buffer[] = [];
+    for await (const chunk of readableFromInputStream(input)) {
+      chunks.push(chunk);
+    }
+    expect(chunks.length).toBe(0);
+  });
+
+  test("readableFromInputStream should stop reading when destroyed", async () => {
+    const data = str("x".repeat(100000)).dataUsingEncoding$(4);
+    const readable = readableFromInputStream(NSInputStream.inputStreamWithData$(data), { chunkSize: 1024 });
+    for await (const chunk of readable) {
+      expect(chunk.length).toBe(1024);
+      break;
+    }
+    expect(readable.destroyed).toBe(true);
+  });
+
+  test("readableFromInputStream should close an idle pipe when destroyed", async () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const fifo = join(dir, "idle.fifo");
+    execFileSync("mkfifo", [fifo]);
+    // Hold a writer open so the reader neither blocks in open nor sees EOF.
+    const writer = openSync(fifo, constants.O_RDWR);
+    try {
+      const input = NSInputStream.inputStreamWithFileAtPath$(str(fifo));
+      const readable = readableFromInputStream(input);
+      readable.on("data", () => {});
+      await new Promise((resolve) => setTimeout(resolve, 50));
+      readable.destroy();
+      const NSStreamStatusClosed = 6;
+      for (let i = 0; i < 100 && input.streamStatus() !== NSStreamStatusClosed; i++) {
+        await new Promise((resolve) => setTimeout(resolve, 10));
+      }
+      expect(input.streamStatus()).toBe(NSStreamStatusClosed);
+    } finally {
+      closeSync(writer);
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test("writableFromOutputStream should write all chunks to a file", async () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const file = join(dir, "output.bin");
+    const contents = makeContents(200 * 1024);
+    try {
+      const output = NSOutputStream.outputStreamToFileAtPath$append$(str(file), false);
+      const source = Readable.from(
+        Array.from({ length: 20 }, (_, i) => contents.subarray(i * 10 * 1024, (i + 1) * 10 * 1024))
+      );
+      await pipeline(source, writableFromOutputStream(output));
+      expect(Buffer.compare(readFileSync(file), contents)).toBe(0);
+    } finally {
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  test("round-trips data through both adapters", async () => {
+    const dir = mkdtempSync(join(tmpdir(), "nobjc-"));
+    const source = join(dir, "source.bin");
+    const destination = join(dir, "destination.bin");
+    const contents = makeContents(1024 * 1024);
+    writeFileSync(source, contents);
+    try {
+      await pipeline(
+        readableFromInputStream(NSInputStream.inputStreamWithFileAtPath$(str(source))),
+        writableFromOutputStream(NSOutputStream.outputStreamToFileAtPath$append$(str(destination), false))
+      );
+      expect(Buffer.compare(readFileSync(destination), contents)).toBe(0);
+    } finally {
+      rmSync(dir, { recursive: true, force: true });
+    }
+  });
+});
@@ -0,0 +1,69 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, StringIntern } from "../dist/index.js";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+
+describe("StringIntern", () => {
+  test("should convert JS strings passed to object parameters", () => {
+    const dict = NSMutableDictionary.dictionary();
+    dict.setObject$forKey$("value", "key");
+    expect(dict.objectForKey$("key").toString()).toBe("value");
+    expect(NSString.stringWithString$("héllo 👋").toString()).toBe("héllo 👋");
+  });
+
+  test("should be disabled by default", () => {
+    StringIntern.disable();
+    NSMutableDictionary.dictionary().setObject$forKey$("a", "b");
+    const stats = StringIntern.stats();
+    expect(stats.capacity).toBe(0);
+    expect(stats.hits + stats.misses).toBe(0);
+  });
+
+  test("should reuse one NSString for repeated keys", () => {
+    StringIntern.enable(16);
+    try {
+      const dict = NSMutableDictionary.dictionary();
+      for (let i = 0; i < 100; i++) {
+        dict.setObject$forKey$(NSString.stringWithUTF8String$(`${i}`), "sharedKey");
+      }
+      const stats = StringIntern.stats();
+      expect(stats.misses).toBe(1);
+      expect(stats.hits).toBe(99);
+      expect(stats.hitRate).toBeCloseTo(0.99);
+      expect(dict.objectForKey$("sharedKey").toString()).toBe("99");
+    } finally {
+      StringIntern.disable();
+    }
+  });
+
+  test("should evict when full and stay correct", () => {
+    StringIntern.enable(4);
+    try {
+      const dict = NSMutableDictionary.dictionary();
+      for (let i = 0; i < 20; i++) {
+        dict.setObject$forKey$(NSString.stringWithUTF8String$(`v${i}`), `k${i}`);
+      }
+      const stats = StringIntern.stats();
+      expect(stats.size).toBe(4);
+      expect(stats.evictions).toBeGreaterThan(0);
+      for (let i = 0; i < 20; i++) {
+        expect(dict.objectForKey$(`k${i}`).toString()).toBe(`v${i}`);
+      }
+    } finally {
+      StringIntern.disable();
+    }
+  });
+
+  test("should bypass long strings", () => {
+    StringIntern.enable(4);
+    try {
+      const long = "x".repeat(1000);
+      expect(NSString.stringWithString$(long).length()).toBe(1000);
+      expect(StringIntern.stats().bypassed).toBe(1);
+    } finally {
+      StringIntern.disable();
+    }
+  });
+});
@@ -0,0 +1,69 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, subscribe } from "../dist/index.js";
+
+/**
+ * Round-trips strings of every width class (ASCII, Latin-1, BMP, astral)
+ * through the native string conversions, at lengths on both sides of the
+ * vector widths and the stack scratch buffer.
+ */
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSMutableDictionary = foundation["NSMutableDictionary"] as any;
+const NSNotificationCenter = foundation["NSNotificationCenter"] as any;
+
+const samples: Record<string, string> = {
+  ascii: "The quick brown fox jumps over the lazy dog",
+  latin1: "Café crème brûlée à la française, s'il vous plaît",
+  bmp: "Быстрая коричневая лиса 快速的棕色狐狸",
+  astral: "emoji 🦊🐕 and math 𝔸𝔹ℂ",
+  empty: ""
+};
+
+describe("String transcoding", () => {
+  for (const [kind, sample] of Object.entries(samples)) {
+    test(`should round-trip ${kind} text through UTF8String`, () => {
+      expect(NSString.stringWithUTF8String$(sample).UTF8String()).toBe(sample);
+    });
+
+    test(`should round-trip long ${kind} text`, () => {
+      const long = sample.repeat(64) + "!";
+      const ns = NSString.stringWithUTF8String$(long);
+      expect(ns.UTF8String()).toBe(long);
+      expect(ns.length()).toBe(long.length);
+    });
+  }
+
+  test("should convert every length around the vector widths", () => {
+    for (let n = 0; n < 70; n++) {
+      const s = "a".repeat(n) + "é" + "b".repeat(n % 17);
+      expect(NSString.stringWithUTF8String$(s).UTF8String()).toBe(s);
+    }
+  });
+
+  test("should encode lone surrogates in char * arguments as U+FFFD", () => {
+    expect(NSString.stringWithUTF8String$("a\uD800b").UTF8String()).toBe("a\uFFFDb");
+  });
+
+  test("should convert multi-megabyte NSStrings (external strings where supported)", async () => {
+    const ascii = "0123456789abcdef".repeat(1 << 16);
+    const wide = "長い文字列".repeat(1 << 16);
+    const received: Record<string, unknown> = {};
+    const subscription = subscribe("NobjcLargeStringNotification", null, { keys: ["ascii", "wide"] }, (records) => {
+      Object.assign(received, records[0].userInfo);
+    });
+    const userInfo = NSMutableDictionary.dictionary();
+    userInfo.setObject$forKey$(NSString.stringWithUTF8String$(ascii), NSString.stringWithUTF8String$("ascii"));
+    userInfo.setObject$forKey$(NSString.stringWithUTF8String$(wide), NSString.stringWithUTF8String$("wide"));
+    NSNotificationCenter.defaultCenter().postNotificationName$object$userInfo$(
+      NSString.stringWithUTF8String$("NobjcLargeStringNotification"),
+      null,
+      userInfo
+    );
+    await new Promise((resolve) => setTimeout(resolve, 50));
+    subscription.stop();
+
+    expect(received.ascii).toBe(ascii);
+    expect(received.wide).toBe(wide);
+  });
+});
@@ -217,4 +217,46 @@ describe("Struct Support Tests", () => {
       expect(roundtripped.length).toBe(100);
     });
   });
+
+  describe("Register-Passed Struct Fast Path", () => {
+    test("should return register structs consistently across repeated calls", () => {
+      const NSString = Foundation.NSString as any;
+      const NSValue = Foundation.NSValue as any;
+      const str = NSString.stringWithUTF8String$("abc abc abc");
+      const needle = NSString.stringWithUTF8String$("abc");
+      const rect = NSValue.valueWithRect$({ origin: { x: 1, y: 2 }, size: { width: 3, height: 4 } });
+      for (let i = 0; i < 20; i++) {
+        const range = str.rangeOfString$options$(needle, 4); // NSBackwardsSearch
+        expect(range.location).toBe(8);
+        expect(range.length).toBe(3);
+        const r = rect.rectValue();
+        expect(r.origin.x).toBe(1);
+        expect(r.size.height).toBe(4);
+      }
+    });
+
+    test("should pass a register struct as the only argument", () => {
+      const NSIndexSet = Foundation.NSIndexSet as any;
+      const set = NSIndexSet.indexSetWithIndexesInRange$({ location: 10, length: 5 });
+      expect(set.count()).toBe(5);
+      expect(set.firstIndex()).toBe(10);
+      expect(set.lastIndex()).toBe(14);
+    });
+
+    test("should pass a register struct followed by an integer argument", () => {
+      const NSWindow = AppKit.NSWindow as any;
+      const window = NSWindow.alloc().initWithContentRect$styleMask$backing$defer$(
+        { origin: { x: 0, y: 0 }, size: { width: 200, height: 100 } },
+        1,
+        2,
+        false
+      );
+      window.setFrame$display$({ origin: { x: 10, y: 20 }, size: { width: 320, height: 240 } }, false);
+      const frame = window.frame();
+      expect(frame.origin.x).toBe(10);
+      expect(frame.origin.y).toBe(20);
+      expect(frame.size.width).toBe(320);
+      expect(frame.size.height).toBe(240);
+    });
+  });
 });
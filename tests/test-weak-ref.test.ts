@@ -0,0 +1,69 @@
+import { test, expect, describe } from "./test-utils.js";
+import { NobjcLibrary, NobjcObject, NobjcWeakRef } from "../dist/index.js";
+import vm from "node:vm";
+import v8 from "node:v8";
+
+const foundation = new NobjcLibrary("/System/Library/Frameworks/Foundation.framework/Foundation");
+const NSString = foundation["NSString"] as any;
+const NSObject = foundation["NSObject"] as any;
+
+function createForceGC(): () => void {
+  if (typeof Bun !== "undefined" && typeof Bun.gc === "function") {
+    const bunGC = Bun.gc;
+    return () => bunGC(true);
+  }
+  if (typeof globalThis.gc === "function") {
+    const gc = globalThis.gc;
+    return () => gc();
+  }
+  v8.setFlagsFromString("--expose_gc");
+  return vm.runInNewContext("gc");
+}
+
+const forceGC = createForceGC();
+
+describe("Weak references", () => {
+  test("should deref to the same object while it is alive", () => {
+    const str = NSString.stringWithUTF8String$("weakly held");
+    const ref = str.$weak();
+    expect(ref).toBeInstanceOf(NobjcWeakRef);
+    const again = ref.deref();
+    expect(again).not.toBeNull();
+    expect(again.isEqual$(str)).toBe(true);
+    expect(again.UTF8String()).toBe("weakly held");
+  });
+
+  test("should construct from a NobjcObject directly", () => {
+    const obj: NobjcObject = NSObject.new();
+    const ref = new NobjcWeakRef(obj);
+    expect(ref.deref()!.isEqual$(obj)).toBe(true);
+  });
+
+  test("should deref many references at once", () => {
+    const objs = Array.from({ length: 10 }, (_, i) => NSString.stringWithUTF8String$(`item-${i}`));
+    const refs = objs.map((o) => o.$weak());
+    const loaded = NobjcWeakRef.derefAll(refs);
+    expect(loaded.length).toBe(10);
+    expect(loaded[7]!.UTF8String()).toBe("item-7");
+  });
+
+  test("should resolve to null after the object is deallocated", async () => {
+    let ref: NobjcWeakRef | undefined;
+    (() => {
+      const obj = NSObject.new();
+      ref = obj.$weak();
+      // Balance the +1 from `new`; the wrapper's own retain remains.
+      obj.release();
+    })();
+    // Don't deref while waiting: each deref creates a new retaining wrapper.
+    for (let i = 0; i < 20; i++) {
+      forceGC();
+      await new Promise((resolve) => setTimeout(resolve, 10));
+    }
+    expect(ref!.deref()).toBeNull();
+  });
+
+  test("should reject non-objects", () => {
+    expect(() => new NobjcWeakRef({} as any)).toThrow();
+  });
+});
@@ -4,12 +4,46 @@ declare module "#nobjc_native" {
     $respondsToSelector(selector: string): boolean;
     $prepareSend(selector: string): unknown;
     $msgSendPrepared(handle: unknown, ...args: any[]): unknown;
+    $toString(): string;
+    /** Promote a borrowed wrapper (see BeginBorrowScope) to a retained one. */
+    $retain(): this;
     $getPointer(): Buffer;
   }
   export function LoadLibrary(path: string): void;
+  /**
+   * dlopen the given libraries in parallel on background threads.
+   * Resolves with one entry per path, in order; failures are reported in
+   * the entry's `error` rather than rejecting.
+   */
+  export function LoadLibraryAsync(
+    paths: string[]
+  ): Promise<Array<{ path: string; loaded: boolean; ms: number; error?: string }>>;
   export function GetClassObject(name: string): ObjcObject;
   export function GetPointer(obj: ObjcObject): Buffer;
   export function FromPointer(pointer: Buffer | bigint): ObjcObject | null;
+  /**
+   * Open a borrow scope: wrappers created until EndBorrowScope do not retain
+   * their objects and are revoked (using them throws) when it closes.
+   */
+  export function BeginBorrowScope(): void;
+  /** Close the innermost borrow scope. */
+  export function EndBorrowScope(): void;
+  /**
+   * Create a zeroing weak reference (objc_initWeak) that does not retain the object.
+   * Throws if the object refuses weak references.
+   */
+  export function CreateWeakReference(obj: ObjcObject): unknown;
+  /** Load a weak reference; null once the object has been deallocated. */
+  export function LoadWeakReference(handle: unknown): ObjcObject | null;
+  /** Load many weak references in one call. */
+  export function LoadWeakReferences(handles: unknown[]): (ObjcObject | null)[];
+  /**
+   * Expose the bytes of an NSData as an ArrayBuffer without copying.
+   * The NSData is retained until the ArrayBuffer is garbage collected.
+   * NSMutableData is snapshotted first; runtimes that forbid external buffers get a copy.
+   * The zero-copy buffer must be treated as read-only; pass copy = true for a writable copy.
+   */
+  export function ToArrayBuffer(data: ObjcObject, copy?: boolean): ArrayBuffer;
   export function CreateProtocolImplementation(
     protocolName: string,
     methodImplementations: Record<string, Function>
@@ -57,7 +91,8 @@ declare module "#nobjc_native" {
   /**
    * Call a C function by name using dlsym + libffi.
    * The framework containing the function must be loaded first (via LoadLibrary).
-   * @param name The function name (e.g., "NSLog", "CGRectMake")
+   * @param target The function name (e.g., "NSLog", "CGRectMake"), or the name with
+   *   an `image` to resolve it in that library's export table, or an `address` from ResolveSymbols
    * @param returnType ObjC type encoding for the return type (e.g., "v" for void, "@" for id)
    * @param argTypes Array of ObjC type encodings for each argument
    * @param fixedArgCount Number of fixed args (for variadic functions). Set equal to argTypes.length for non-variadic.
@@ -65,13 +100,22 @@ declare module "#nobjc_native" {
    * @returns The return value converted to JS
    */
   export function CallFunction(
-    name: string,
+    target: string | { name: string; image?: string; address?: bigint },
     returnType: string,
     argTypes: string[],
     fixedArgCount: number,
     ...args: any[]
   ): any;
 
+  /**
+   * Resolve many C symbols in one call. With `image`, names are looked up in
+   * that library's export table instead of every loaded image. Without it,
+   * resolved addresses are cached and reused by CallFunction.
+   *
+   * @returns A map from each name to its address, or null if not found
+   */
+  export function ResolveSymbols(names: string[], image?: string): Record<string, bigint | null>;
+
   /**
    * Pump the macOS CFRunLoop in default mode.
    * Processes any pending run loop sources (AppKit events, dispatch_async to main queue,
@@ -84,4 +128,223 @@ declare module "#nobjc_native" {
    * @returns true if a source was processed, false otherwise
    */
   export function PumpRunLoop(timeout?: number): boolean;
+
+  /** A single key-value change as extracted by the native observer. */
+  export interface NativeKeyValueChange {
+    /** NSKeyValueChange kind (1 = setting, 2 = insertion, 3 = removal, 4 = replacement) */
+    kind: number;
+    /** New value, present when NSKeyValueObservingOptionNew was requested */
+    newValue?: unknown;
+    /** Old value, present when NSKeyValueObservingOptionOld was requested */
+    oldValue?: unknown;
+    /** NSIndexSet for collection mutations */
+    indexes?: ObjcObject;
+    /** True for the notification sent before the change (NSKeyValueObservingOptionPrior) */
+    isPrior: boolean;
+    /** Number of changes merged into this record by coalescing */
+    count: number;
+  }
+
+  /**
+   * Observe a key path with a native KVO observer.
+   * Change dictionaries are unpacked natively and delivered to `callback` in batches.
+   * @param target The object to observe (kept alive until StopObserving)
+   * @param keyPath The key path to observe
+   * @param options NSKeyValueObservingOptions bitmask
+   * @param coalesceMs Merge bursts of setting changes within this window (0 = deliver every change)
+   * @param callback Receives an array of changes per batch
+   * @returns An opaque subscription handle
+   */
+  export function ObserveKeyPath(
+    target: ObjcObject,
+    keyPath: string,
+    options: number,
+    coalesceMs: number,
+    callback: (changes: NativeKeyValueChange[]) => void
+  ): unknown;
+
+  /**
+   * Remove an observer created by ObserveKeyPath. Safe to call more than once.
+   * @param handle The subscription handle
+   */
+  export function StopObserving(handle: unknown): void;
+
+  /** A notification as extracted by the native block observer. */
+  export interface NativeNotificationRecord {
+    name: string;
+    object: ObjcObject | null;
+    /** Only the requested userInfo keys that were present */
+    userInfo: Record<string, unknown>;
+  }
+
+  /**
+   * Subscribe to notifications with a native block observer.
+   * Only the requested userInfo keys are extracted, and records are delivered in batches
+   * without blocking the posting thread.
+   * @param name Notification name, or null for all notifications
+   * @param object Only deliver notifications posted by this object (null for any sender)
+   * @param keys userInfo keys to extract
+   * @param batchMs Delay before a batch is delivered (0 = as soon as the JS thread is free)
+   * @param center Notification center to observe (null for the default center)
+   * @param callback Receives an array of records per batch
+   * @returns An opaque subscription handle
+   */
+  export function SubscribeNotification(
+    name: string | null,
+    object: ObjcObject | null,
+    keys: string[],
+    batchMs: number,
+    center: ObjcObject | null,
+    callback: (records: NativeNotificationRecord[]) => void
+  ): unknown;
+
+  /**
+   * Remove an observer created by SubscribeNotification. Safe to call more than once.
+   * @param handle The subscription handle
+   */
+  export function Unsubscribe(handle: unknown): void;
+
+  /**
+   * Start a reader thread for an NSInputStream. The stream is opened if needed.
+   * Each InputStreamRead grants one chunk of credit; chunks are read into pooled
+   * buffers on the reader thread and delivered to `onChunk`.
+   * @param stream The NSInputStream
+   * @param chunkSize Maximum bytes per chunk (undefined for the native default, 64 KiB)
+   * @param onChunk Called with a Buffer per chunk, null at end of stream, or (undefined, message) on error
+   * @returns An opaque reader handle
+   */
+  export function InputStreamOpen(
+    stream: ObjcObject,
+    chunkSize: number | undefined,
+    onChunk: (chunk: Buffer | null | undefined, error?: string) => void
+  ): unknown;
+
+  /** Request one more chunk from a reader (Readable._read). */
+  export function InputStreamRead(handle: unknown): void;
+
+  /** Stop a reader and close its stream. Safe to call more than once. */
+  export function InputStreamClose(handle: unknown): void;
+
+  /**
+   * Start a writer thread for an NSOutputStream. The stream is opened if needed.
+   * @param stream The NSOutputStream
+   * @param onComplete Called with the request id and an error message (or null) when a write or close finishes
+   * @returns An opaque writer handle
+   */
+  export function OutputStreamOpen(stream: ObjcObject, onComplete: (requestId: number, error: string | null) => void): unknown;
+
+  /** Queue Buffers for writing. The Buffers are referenced until the write completes. */
+  export function OutputStreamWrite(handle: unknown, buffers: Buffer[], requestId: number): void;
+
+  /** Finish queued writes and close the stream. Safe to call more than once. */
+  export function OutputStreamClose(handle: unknown, requestId: number): void;
+
+  /**
+   * Send a prepared zero-argument selector to every receiver on worker threads.
+   * Blocks until all workers have finished. The method must be thread-safe.
+   * @param handle A handle from $prepareSend
+   * @param receivers The receivers (null entries behave like messaging nil)
+   * @param out Destination for numeric results, or null to allocate a Float64Array
+   * @param threads Maximum number of workers (0 = number of active CPUs)
+   * @returns The results TypedArray, an array of objects for object returns, or undefined for void returns
+   */
+  export function ParallelSendMap(
+    handle: unknown,
+    receivers: (ObjcObject | null)[],
+    out: ArrayBufferView | null,
+    threads: number
+  ): ArrayBufferView | (ObjcObject | null)[] | undefined;
+
+  /**
+   * Build a reusable invocation for one receiver and selector. `undefined`
+   * entries in args are variable slots; everything else is converted once.
+   * @param receiver The target object
+   * @param handle A handle from $prepareSend on the receiver
+   * @param args One entry per selector argument
+   * @returns An opaque BoundInvocation handle
+   */
+  export function BindInvocation(receiver: ObjcObject, handle: unknown, args: unknown[]): unknown;
+  /** Fill the variable slots of a BoundInvocation in order and send it. */
+  export function InvokeBound(bound: unknown, ...args: any[]): unknown;
+
+  /** Native state behind a lazy collection view. */
+  export interface LazyViewInfo {
+    handle: unknown;
+    kind: "array" | "dictionary";
+    count: number;
+  }
+  /**
+   * Create a lazy view over an NSArray or NSDictionary. Reads throw once the
+   * collection has been mutated.
+   */
+  export function CreateLazyView(collection: ObjcObject): LazyViewInfo;
+  export function LazyViewCount(handle: unknown): number;
+  /** Read an element by index (array views, chunked) or key (dictionary views). */
+  export function LazyViewGet(handle: unknown, indexOrKey: number | string | ObjcObject): ObjcObject | null | undefined;
+  /** Read elements [start, end) of an array view in one call. */
+  export function LazyViewGetRange(handle: unknown, start: number, end: number): (ObjcObject | null)[];
+  /** An array view over a dictionary view's keys. */
+  export function LazyViewKeys(handle: unknown): LazyViewInfo;
+
+  /**
+   * Enable, resize or disable the JS string -> NSString intern cache used for `@` arguments.
+   * @param capacity Maximum number of interned strings (0 disables the cache)
+   */
+  export function ConfigureStringIntern(capacity: number): void;
+
+  /** Get the intern cache counters. */
+  export function GetStringInternStats(): {
+    capacity: number;
+    size: number;
+    hits: number;
+    misses: number;
+    evictions: number;
+    bypassed: number;
+  };
+
+  /** Counters for one cross-thread callback delivery lane. */
+  export interface CallbackLaneStats {
+    posted: number;
+    delivered: number;
+    pending: number;
+    maxPending: number;
+  }
+
+  /** Get the callback dispatcher's drain and per-lane counters. */
+  export function GetCallbackDispatcherStats(): {
+    drains: number;
+    yields: number;
+    nested: number;
+    lanes: {
+      blocking: CallbackLaneStats;
+      interactive: CallbackLaneStats;
+      background: CallbackLaneStats;
+    };
+    waits: {
+      count: number;
+      timeouts: number;
+      histogram: Array<{ upToMs: number; count: number }>;
+    };
+  };
+
+  /** Set the default timeout (ms, 0 = none) for synchronous cross-thread callbacks. */
+  export function ConfigureCallbackTimeout(timeoutMs: number): void;
+
+  /** Start the process-wide native call sampler. */
+  export function StartCallProfiler(hz: number): void;
+
+  /** Stop the sampler and return the aggregated native call stacks. */
+  export function StopCallProfiler(): {
+    durationMs: number;
+    hz: number;
+    ticks: number;
+    samples: number;
+    stacks: Array<{ frames: string[]; count: number }>;
+  };
+
+  /** Start recording call shapes and timings (no argument values). */
+  export function StartCallTrace(): void;
+
+  /** Stop recording and return the binary trace. */
+  export function StopCallTrace(): Buffer;
 }